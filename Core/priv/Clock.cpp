@@ -0,0 +1,27 @@
+#include "Clock.h"
+
+#include <chrono>
+
+int64_t SystemWallClock::nowSeconds() const
+{
+    auto now = std::chrono::system_clock::now();
+    return std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+}
+
+int64_t ManualClock::nowSeconds() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_now;
+}
+
+void ManualClock::set(int64_t nowSeconds)
+{
+    std::lock_guard lock(m_mutex);
+    m_now = nowSeconds;
+}
+
+void ManualClock::advance(int64_t seconds)
+{
+    std::lock_guard lock(m_mutex);
+    m_now += seconds;
+}
@@ -0,0 +1,303 @@
+#include "Ed25519Signer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+
+namespace {
+
+constexpr uint8_t kAlgoEdDsaLegacy = 22;
+constexpr uint8_t kAlgoEd25519     = 27;
+constexpr uint8_t kTagSecretKey    = 5;
+constexpr uint8_t kTagPublicKey    = 6;
+
+// OID 1.3.6.1.4.1.11591.15.1 (Ed25519) as used in OpenPGP
+constexpr uint8_t kEd25519Oid[] = {0x2B, 0x06, 0x01, 0x04, 0x01, 0xDA, 0x47, 0x0F, 0x01};
+
+struct KeyMaterial
+{
+    Ed25519Signer::PublicKey publicKey{};
+    std::array<uint8_t, 32>  seed{};
+    bool                     hasSeed = false;
+};
+
+// Strip ASCII armor if present and base64-decode the body
+std::string dearmor(const std::string& text)
+{
+    if (text.rfind("-----BEGIN", 0) != 0) {
+        return text;
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    std::string base64;
+    bool inBody = false;
+    std::getline(lines, line);  // BEGIN line
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!inBody) {
+            // Armor headers ("Version: ...") end at the first blank line
+            inBody = line.empty();
+            continue;
+        }
+        if (line.empty() || line[0] == '=' || line.rfind("-----END", 0) == 0) {
+            break;
+        }
+        base64 += line;
+    }
+
+    if (base64.empty() || base64.size() % 4 != 0) {
+        throw std::runtime_error("Malformed armored key");
+    }
+
+    std::string decoded(base64.size() / 4 * 3, '\0');
+    int len = EVP_DecodeBlock(reinterpret_cast<unsigned char*>(&decoded[0]),
+                              reinterpret_cast<const unsigned char*>(base64.data()),
+                              static_cast<int>(base64.size()));
+    if (len < 0) {
+        throw std::runtime_error("Malformed armored key");
+    }
+    // EVP_DecodeBlock counts padding as zero bytes
+    size_t padding = std::count(base64.end() - 2, base64.end(), '=');
+    decoded.resize(static_cast<size_t>(len) - padding);
+    return decoded;
+}
+
+class Reader
+{
+public:
+    Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    bool has(size_t n) const { return m_size - m_pos >= n; }
+    size_t remaining() const { return m_size - m_pos; }
+
+    uint8_t u8()
+    {
+        if (!has(1)) throw std::runtime_error("Truncated key packet");
+        return m_data[m_pos++];
+    }
+
+    const uint8_t* take(size_t n)
+    {
+        if (!has(n)) throw std::runtime_error("Truncated key packet");
+        const uint8_t* p = m_data + m_pos;
+        m_pos += n;
+        return p;
+    }
+
+    // OpenPGP MPI: 2-byte bit count followed by the big-endian bytes
+    std::vector<uint8_t> mpi()
+    {
+        size_t bits = (static_cast<size_t>(u8()) << 8) | u8();
+        const uint8_t* p = take((bits + 7) / 8);
+        return std::vector<uint8_t>(p, p + (bits + 7) / 8);
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
+// Parse a v4 public or secret key packet body into raw Ed25519 material
+bool parseKeyPacket(const uint8_t* body, size_t size, bool secret, KeyMaterial& out)
+{
+    Reader r(body, size);
+    if (r.u8() != 4) {
+        return false;  // only v4 keys are generated by rnp here
+    }
+    r.take(4);  // creation time
+    uint8_t algo = r.u8();
+
+    if (algo == kAlgoEdDsaLegacy) {
+        size_t oidLen = r.u8();
+        const uint8_t* oid = r.take(oidLen);
+        if (oidLen != sizeof(kEd25519Oid) || std::memcmp(oid, kEd25519Oid, oidLen) != 0) {
+            return false;
+        }
+        // Public point is 0x40 followed by the 32-byte native key
+        std::vector<uint8_t> point = r.mpi();
+        if (point.size() != 33 || point[0] != 0x40) {
+            return false;
+        }
+        std::copy(point.begin() + 1, point.end(), out.publicKey.begin());
+    } else if (algo == kAlgoEd25519) {
+        const uint8_t* point = r.take(32);
+        std::copy(point, point + 32, out.publicKey.begin());
+    } else {
+        return false;
+    }
+
+    if (!secret) {
+        return true;
+    }
+
+    if (r.u8() != 0) {
+        throw std::runtime_error("Secret key is password protected");
+    }
+
+    if (algo == kAlgoEdDsaLegacy) {
+        // Seed is stored as an MPI, so leading zero bytes are stripped
+        std::vector<uint8_t> seed = r.mpi();
+        if (seed.size() > 32) {
+            return false;
+        }
+        std::fill(out.seed.begin(), out.seed.end(), 0);
+        std::copy(seed.begin(), seed.end(), out.seed.end() - seed.size());
+        OPENSSL_cleanse(seed.data(), seed.size());
+    } else {
+        const uint8_t* seed = r.take(32);
+        std::copy(seed, seed + 32, out.seed.begin());
+    }
+    out.hasSeed = true;
+    return true;
+}
+
+// Walk the packet sequence and parse the first primary key packet
+KeyMaterial readKeyMaterial(const std::string& key, bool secret)
+{
+    std::string bytes = dearmor(key);
+    const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+    Reader r(data, bytes.size());
+
+    while (r.remaining() > 0) {
+        uint8_t header = r.u8();
+        if (!(header & 0x80)) {
+            throw std::runtime_error("Invalid OpenPGP packet header");
+        }
+
+        uint8_t tag = 0;
+        size_t length = 0;
+        if (header & 0x40) {
+            // New format length
+            tag = header & 0x3f;
+            uint8_t first = r.u8();
+            if (first < 192) {
+                length = first;
+            } else if (first < 224) {
+                length = ((static_cast<size_t>(first) - 192) << 8) + r.u8() + 192;
+            } else if (first == 255) {
+                const uint8_t* p = r.take(4);
+                length = (static_cast<size_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+            } else {
+                throw std::runtime_error("Partial-length key packets are not supported");
+            }
+        } else {
+            // Old format length
+            tag = (header >> 2) & 0x0f;
+            size_t lengthBytes = (header & 0x03) == 0 ? 1 : (header & 0x03) == 1 ? 2 : 4;
+            if ((header & 0x03) == 3) {
+                throw std::runtime_error("Indeterminate-length key packets are not supported");
+            }
+            const uint8_t* p = r.take(lengthBytes);
+            for (size_t i = 0; i < lengthBytes; ++i) {
+                length = (length << 8) | p[i];
+            }
+        }
+
+        const uint8_t* body = r.take(length);
+        if (tag == (secret ? kTagSecretKey : kTagPublicKey)) {
+            KeyMaterial material;
+            if (!parseKeyPacket(body, length, secret, material)) {
+                throw std::runtime_error("Key is not an Ed25519 key");
+            }
+            return material;
+        }
+    }
+
+    throw std::runtime_error(secret ? "No secret key packet found" : "No public key packet found");
+}
+
+} // namespace
+
+std::unique_ptr<Ed25519Signer> Ed25519Signer::fromOpenPgpSecretKey(const std::string& secretKey)
+{
+    KeyMaterial material = readKeyMaterial(secretKey, true);
+    std::unique_ptr<Ed25519Signer> signer;
+    try {
+        signer = fromSeed(material.seed.data());
+    } catch (...) {
+        OPENSSL_cleanse(material.seed.data(), material.seed.size());
+        throw;
+    }
+    OPENSSL_cleanse(material.seed.data(), material.seed.size());
+
+    // The public key derived from the seed must match the packet
+    if (signer->m_publicKey != material.publicKey) {
+        throw std::runtime_error("Ed25519 key packet is inconsistent");
+    }
+    return signer;
+}
+
+std::unique_ptr<Ed25519Signer> Ed25519Signer::fromSeed(const uint8_t* seed)
+{
+    std::unique_ptr<Ed25519Signer> signer(new Ed25519Signer());
+    signer->m_key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, nullptr, seed, 32);
+    if (!signer->m_key) {
+        throw std::runtime_error("Failed to load Ed25519 private key");
+    }
+
+    size_t len = signer->m_publicKey.size();
+    if (EVP_PKEY_get_raw_public_key(signer->m_key, signer->m_publicKey.data(), &len) != 1) {
+        throw std::runtime_error("Failed to derive Ed25519 public key");
+    }
+    return signer;
+}
+
+Ed25519Signer::~Ed25519Signer()
+{
+    EVP_PKEY_free(m_key);
+}
+
+Ed25519Signer::Signature Ed25519Signer::sign(const uint8_t* data, size_t size) const
+{
+    Signature signature{};
+    size_t sigLen = signature.size();
+
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    bool ok = ctx &&
+              EVP_DigestSignInit(ctx, nullptr, nullptr, nullptr, m_key) == 1 &&
+              EVP_DigestSign(ctx, signature.data(), &sigLen, data, size) == 1 &&
+              sigLen == signature.size();
+    EVP_MD_CTX_free(ctx);
+
+    if (!ok) {
+        throw std::runtime_error("Ed25519 signing failed");
+    }
+    return signature;
+}
+
+std::optional<Ed25519Signer::PublicKey> Ed25519Signer::publicKeyFromOpenPgp(const std::string& publicKey)
+{
+    try {
+        return readKeyMaterial(publicKey, false).publicKey;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+bool Ed25519Signer::verify(const PublicKey& publicKey, const uint8_t* data, size_t size,
+                           const Signature& signature)
+{
+    EVP_PKEY* key = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, nullptr,
+                                                publicKey.data(), publicKey.size());
+    if (!key) {
+        return false;
+    }
+
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    bool ok = ctx &&
+              EVP_DigestVerifyInit(ctx, nullptr, nullptr, nullptr, key) == 1 &&
+              EVP_DigestVerify(ctx, signature.data(), signature.size(), data, size) == 1;
+
+    EVP_MD_CTX_free(ctx);
+    EVP_PKEY_free(key);
+    return ok;
+}
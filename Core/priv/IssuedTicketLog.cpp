@@ -0,0 +1,54 @@
+#include "IssuedTicketLog.h"
+
+#include <charconv>
+#include <stdexcept>
+
+IssuedTicketLog::IssuedTicketLog(const std::string& path)
+    : m_path(path)
+    , m_out(path, std::ios::app)
+{
+    if (!m_out) {
+        throw std::runtime_error("Cannot open issued ticket log: " + path);
+    }
+}
+
+void IssuedTicketLog::append(const Record& record)
+{
+    // Fields never contain commas: references and hashes are alphanumeric
+    std::lock_guard lock(m_mutex);
+    m_out << record.bookingRef << ',' << record.keyHash << ',' << record.issuedAt << ','
+          << record.travelDate << '\n';
+    m_out.flush();
+}
+
+bool IssuedTicketLog::parseLine(std::string_view line, std::string_view& bookingRef, std::string_view& keyHash,
+                                int64_t& issuedAt, std::string_view& travelDate)
+{
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    if (line.empty() || line.front() == '#') {
+        return false;
+    }
+
+    std::string_view fields[4];
+    for (size_t i = 0; i < 4; ++i) {
+        size_t comma = line.find(',');
+        if ((comma == std::string_view::npos) != (i == 3)) {
+            return false;
+        }
+        fields[i] = line.substr(0, comma);
+        line.remove_prefix(comma == std::string_view::npos ? line.size() : comma + 1);
+    }
+
+    const char* end = fields[2].data() + fields[2].size();
+    auto parsed = std::from_chars(fields[2].data(), end, issuedAt);
+    if (fields[0].empty() || parsed.ec != std::errc() || parsed.ptr != end) {
+        return false;
+    }
+
+    bookingRef = fields[0];
+    keyHash = fields[1];
+    travelDate = fields[3];
+    return true;
+}
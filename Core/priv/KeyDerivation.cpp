@@ -0,0 +1,227 @@
+#include "KeyDerivation.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
+namespace {
+
+constexpr char kSaltPrefix[] = "SBB-USER-KEY-v1|";
+
+constexpr uint8_t kTagSecretKey  = 5;
+constexpr uint8_t kTagUserId     = 13;
+constexpr uint8_t kTagSignature  = 2;
+constexpr uint8_t kAlgoEdDsa     = 22;
+constexpr uint8_t kHashSha256    = 8;
+constexpr uint8_t kSigPositiveId = 0x13;
+
+// OID 1.3.6.1.4.1.11591.15.1 (Ed25519) as used in OpenPGP
+constexpr uint8_t kEd25519Oid[] = {0x2B, 0x06, 0x01, 0x04, 0x01, 0xDA, 0x47, 0x0F, 0x01};
+
+using Bytes = std::vector<uint8_t>;
+
+void putU16(Bytes& out, size_t value)
+{
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putU32(Bytes& out, uint32_t value)
+{
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// OpenPGP MPI: bit count of the value without leading zeros, then the bytes
+void putMpi(Bytes& out, const uint8_t* data, size_t size)
+{
+    while (size > 0 && *data == 0) {
+        ++data;
+        --size;
+    }
+    size_t bits = size == 0 ? 0 : (size - 1) * 8;
+    for (uint8_t top = size == 0 ? 0 : data[0]; top; top >>= 1) {
+        ++bits;
+    }
+    putU16(out, bits);
+    out.insert(out.end(), data, data + size);
+}
+
+// New-format packet header
+void putPacket(Bytes& out, uint8_t tag, const Bytes& body)
+{
+    out.push_back(static_cast<uint8_t>(0xC0 | tag));
+    if (body.size() < 192) {
+        out.push_back(static_cast<uint8_t>(body.size()));
+    } else if (body.size() < 8384) {
+        size_t len = body.size() - 192;
+        out.push_back(static_cast<uint8_t>((len >> 8) + 192));
+        out.push_back(static_cast<uint8_t>(len));
+    } else {
+        out.push_back(0xFF);
+        putU32(out, static_cast<uint32_t>(body.size()));
+    }
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+// RAII wrapper so every error path frees the OpenSSL key
+struct PKey
+{
+    EVP_PKEY* key = nullptr;
+    ~PKey() { EVP_PKEY_free(key); }
+};
+
+} // namespace
+
+KeyDerivation::Seed KeyDerivation::deriveSeed(std::string_view email, std::string_view password)
+{
+    return deriveSeed(email, password, Params());
+}
+
+KeyDerivation::Seed KeyDerivation::deriveSeed(std::string_view email, std::string_view password,
+                                              const Params& params)
+{
+    // Salt binds the key to the (case-insensitive) account
+    std::string salt = kSaltPrefix;
+    for (char c : email) {
+        salt += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    Seed seed{};
+    stretch(password, reinterpret_cast<const uint8_t*>(salt.data()), salt.size(), params,
+            seed.data(), seed.size());
+    return seed;
+}
+
+bool KeyDerivation::isValid(const Params& params)
+{
+    if (params.costLog2 < kMinCostLog2 || params.costLog2 > kMaxCostLog2) {
+        return false;
+    }
+    if (params.blockSize < 1 || params.blockSize > kMaxBlockSize ||
+        params.parallelism < 1 || params.parallelism > kMaxParallelism) {
+        return false;
+    }
+    return 128 * uint64_t(params.blockSize) * (uint64_t(1) << params.costLog2) <= kMaxMemory;
+}
+
+void KeyDerivation::stretch(std::string_view password, const uint8_t* salt, size_t saltSize,
+                            const Params& params, uint8_t* out, size_t outSize)
+{
+    if (!isValid(params)) {
+        throw std::runtime_error("scrypt parameters out of range (N = 2^" + std::to_string(params.costLog2) +
+                                 ", r = " + std::to_string(params.blockSize) +
+                                 ", p = " + std::to_string(params.parallelism) + ")");
+    }
+
+    const uint64_t n = uint64_t(1) << params.costLog2;
+    // scrypt needs 128 * r * (N + p + 2) bytes; leave headroom over OpenSSL's default cap
+    const uint64_t maxMem = 128 * uint64_t(params.blockSize) * (n + params.parallelism + 2) + (1u << 20);
+
+    if (EVP_PBE_scrypt(password.data(), password.size(), salt, saltSize,
+                       n, params.blockSize, params.parallelism, maxMem,
+                       out, outSize) != 1) {
+        throw std::runtime_error("scrypt key derivation failed");
+    }
+}
+
+std::string KeyDerivation::buildSecretKey(const uint8_t* seed, const std::string& userId, uint32_t creationTime)
+{
+    PKey pkey;
+    pkey.key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, nullptr, seed, 32);
+    uint8_t publicKey[32];
+    size_t publicLen = sizeof(publicKey);
+    if (!pkey.key || EVP_PKEY_get_raw_public_key(pkey.key, publicKey, &publicLen) != 1) {
+        throw std::runtime_error("Failed to derive Ed25519 public key");
+    }
+
+    // Public key packet body (v4, EdDSA, Ed25519 curve, 0x40-prefixed point)
+    Bytes publicBody;
+    publicBody.push_back(4);
+    putU32(publicBody, creationTime);
+    publicBody.push_back(kAlgoEdDsa);
+    publicBody.push_back(sizeof(kEd25519Oid));
+    publicBody.insert(publicBody.end(), kEd25519Oid, kEd25519Oid + sizeof(kEd25519Oid));
+    uint8_t point[33] = {0x40};
+    std::copy(publicKey, publicKey + 32, point + 1);
+    putMpi(publicBody, point, sizeof(point));
+
+    // v4 fingerprint: SHA-1 over 0x99, 2-byte length, public key body
+    Bytes fingerprintInput = {0x99};
+    putU16(fingerprintInput, publicBody.size());
+    fingerprintInput.insert(fingerprintInput.end(), publicBody.begin(), publicBody.end());
+    uint8_t fingerprint[SHA_DIGEST_LENGTH];
+    SHA1(fingerprintInput.data(), fingerprintInput.size(), fingerprint);
+
+    // Secret key packet: public body, no S2K protection, seed MPI, checksum
+    Bytes secretBody = publicBody;
+    secretBody.push_back(0);
+    size_t secretStart = secretBody.size();
+    putMpi(secretBody, seed, 32);
+    uint16_t checksum = 0;
+    for (size_t i = secretStart; i < secretBody.size(); ++i) {
+        checksum = static_cast<uint16_t>(checksum + secretBody[i]);
+    }
+    putU16(secretBody, checksum);
+
+    // Self-signature (positive certification) binding the user id
+    Bytes hashedPart = {4, kSigPositiveId, kAlgoEdDsa, kHashSha256};
+    Bytes subpackets = {5, 2};                        // signature creation time
+    putU32(subpackets, creationTime);
+    subpackets.insert(subpackets.end(), {2, 27, 0x03});  // key flags: certify + sign
+    subpackets.insert(subpackets.end(), {22, 33, 4});    // issuer fingerprint (v4)
+    subpackets.insert(subpackets.end(), fingerprint, fingerprint + sizeof(fingerprint));
+    putU16(hashedPart, subpackets.size());
+    hashedPart.insert(hashedPart.end(), subpackets.begin(), subpackets.end());
+
+    Bytes hashInput = fingerprintInput;
+    hashInput.push_back(0xB4);
+    putU32(hashInput, static_cast<uint32_t>(userId.size()));
+    hashInput.insert(hashInput.end(), userId.begin(), userId.end());
+    hashInput.insert(hashInput.end(), hashedPart.begin(), hashedPart.end());
+    hashInput.push_back(4);
+    hashInput.push_back(0xFF);
+    putU32(hashInput, static_cast<uint32_t>(hashedPart.size()));
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(hashInput.data(), hashInput.size(), digest);
+
+    // OpenPGP EdDSA signs the digest itself
+    uint8_t signature[64];
+    size_t signatureLen = sizeof(signature);
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    bool signedOk = ctx &&
+                    EVP_DigestSignInit(ctx, nullptr, nullptr, nullptr, pkey.key) == 1 &&
+                    EVP_DigestSign(ctx, signature, &signatureLen, digest, sizeof(digest)) == 1;
+    EVP_MD_CTX_free(ctx);
+    if (!signedOk) {
+        throw std::runtime_error("Failed to self-sign derived key");
+    }
+
+    Bytes signatureBody = hashedPart;
+    Bytes unhashed = {9, 16};                         // issuer key id
+    unhashed.insert(unhashed.end(), fingerprint + 12, fingerprint + 20);
+    putU16(signatureBody, unhashed.size());
+    signatureBody.insert(signatureBody.end(), unhashed.begin(), unhashed.end());
+    signatureBody.push_back(digest[0]);
+    signatureBody.push_back(digest[1]);
+    putMpi(signatureBody, signature, 32);             // R
+    putMpi(signatureBody, signature + 32, 32);        // S
+
+    Bytes key;
+    putPacket(key, kTagSecretKey, secretBody);
+    putPacket(key, kTagUserId, Bytes(userId.begin(), userId.end()));
+    putPacket(key, kTagSignature, signatureBody);
+
+    OPENSSL_cleanse(secretBody.data(), secretBody.size());
+    std::string result(key.begin(), key.end());
+    OPENSSL_cleanse(key.data(), key.size());
+    return result;
+}
@@ -0,0 +1,73 @@
+#include "KeyFingerprint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <openssl/sha.h>
+
+namespace {
+
+constexpr char kDomain[] = "SBB-KFP";
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+KeyFingerprint KeyFingerprint::fromEd25519(const Ed25519Signer::PublicKey& publicKey)
+{
+    uint8_t input[sizeof(kDomain) - 1 + 32];
+    std::memcpy(input, kDomain, sizeof(kDomain) - 1);
+    std::memcpy(input + sizeof(kDomain) - 1, publicKey.data(), publicKey.size());
+
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(input, sizeof(input), digest);
+
+    Bytes bytes;
+    std::copy(digest, digest + kSize, bytes.begin());
+    return KeyFingerprint(bytes);
+}
+
+KeyFingerprint KeyFingerprint::fromPublicKey(const std::string& publicKey)
+{
+    auto point = Ed25519Signer::publicKeyFromOpenPgp(publicKey);
+    if (!point) {
+        throw std::runtime_error("Public key is not an Ed25519 key");
+    }
+    return fromEd25519(*point);
+}
+
+std::optional<KeyFingerprint> KeyFingerprint::fromHex(std::string_view hex)
+{
+    if (hex.size() != kHexSize) {
+        return std::nullopt;
+    }
+
+    Bytes bytes;
+    for (size_t i = 0; i < kSize; ++i) {
+        int hi = hexValue(hex[2 * i]);
+        int lo = hexValue(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return std::nullopt;
+        }
+        bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return KeyFingerprint(bytes);
+}
+
+std::string KeyFingerprint::toHex() const
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(kHexSize, '0');
+    for (size_t i = 0; i < kSize; ++i) {
+        hex[2 * i]     = digits[m_bytes[i] >> 4];
+        hex[2 * i + 1] = digits[m_bytes[i] & 0x0f];
+    }
+    return hex;
+}
@@ -0,0 +1,124 @@
+#include "KeyPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <openssl/rand.h>
+
+namespace {
+
+constexpr size_t kSeedSize = 32;
+constexpr std::chrono::milliseconds kRecheckInterval(20);
+
+} // namespace
+
+KeyPool::KeyPool(std::string userId, size_t depth, size_t refillThreads)
+    : m_userId(std::move(userId))
+    , m_depth(std::max<size_t>(depth, 1))
+    , m_ready(m_depth)
+{
+    for (size_t i = 0; i < std::max<size_t>(refillThreads, 1); ++i) {
+        m_threads.emplace_back([this] { refillLoop(); });
+    }
+}
+
+KeyPool::~KeyPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wantKeys.notify_all();
+    m_filled.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+std::unique_ptr<SigningKey> KeyPool::generate(const std::string& userId)
+{
+    SecureBuffer seed(kSeedSize);
+    if (RAND_bytes(seed.data(), static_cast<int>(seed.size())) != 1) {
+        throw std::runtime_error("Failed to generate a key seed");
+    }
+    return std::make_unique<SigningKey>(SigningKey::fromSeed(std::move(seed), userId));
+}
+
+std::unique_ptr<SigningKey> KeyPool::take()
+{
+    std::unique_ptr<SigningKey> key;
+    const bool pooled = m_ready.tryPop(key);
+    m_wantKeys.notify_one();
+
+    if (pooled) {
+        m_taken.fetch_add(1, std::memory_order_relaxed);
+        return key;
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return generate(m_userId);
+}
+
+void KeyPool::waitUntilFull()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_filled.wait(lock, [this] { return m_stopping || m_ready.size() >= m_depth; });
+}
+
+KeyPool::Stats KeyPool::stats() const
+{
+    Stats stats;
+    stats.depth = m_depth;
+    stats.ready = m_ready.size();
+    stats.generated = m_generated.load(std::memory_order_relaxed);
+    stats.taken = m_taken.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    stats.generateNanos = m_generateNanos.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void KeyPool::refillLoop()
+{
+    while (true) {
+        {
+            // Claim one slot of the deficit, so several threads do not overfill the pool
+            // take() notifies without the lock, so a wake-up can slip past; the timeout bounds that
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wantKeys.wait_for(lock, kRecheckInterval, [this] {
+                return m_stopping || m_ready.size() + m_inFlight.load(std::memory_order_relaxed) < m_depth;
+            });
+            if (!m_stopping && m_ready.size() + m_inFlight.load(std::memory_order_relaxed) >= m_depth) {
+                continue;
+            }
+            if (m_stopping) {
+                return;
+            }
+            m_inFlight.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::unique_ptr<SigningKey> key;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            key = generate(m_userId);
+        } catch (const std::exception&) {
+            // Leave the slot to the next attempt; take() still generates inline
+            std::this_thread::sleep_for(kRecheckInterval);
+        }
+        m_generateNanos.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now() - start).count()),
+                                  std::memory_order_relaxed);
+
+        bool full = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (key && m_ready.tryPush(std::move(key))) {
+                m_generated.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+            full = m_ready.size() >= m_depth;
+        }
+        if (full) {
+            m_filled.notify_all();
+        }
+    }
+}
@@ -0,0 +1,217 @@
+#include "KeyStore.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char   kMagic[]       = "SBBKEY01";
+constexpr size_t kMagicSize     = sizeof(kMagic) - 1;
+constexpr size_t kSaltSize      = 16;
+constexpr size_t kNonceSize     = 12;
+constexpr size_t kSeedSize      = 32;
+constexpr size_t kTagSize       = 16;
+constexpr size_t kHeaderSize    = kMagicSize + 1 + 4 + 4 + kSaltSize + kNonceSize;
+constexpr size_t kFileSize      = kHeaderSize + kSeedSize + kTagSize;
+
+void putU32(uint8_t* out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+uint32_t getU32(const uint8_t* in)
+{
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | in[3];
+}
+
+// AES-256-GCM over one block of data; returns false on authentication failure
+bool aesGcm(bool encrypt, const uint8_t* key, const uint8_t* nonce,
+            const uint8_t* aad, size_t aadSize,
+            const uint8_t* in, size_t size, uint8_t* out, uint8_t* tag)
+{
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+
+    int len = 0;
+    bool ok = EVP_CipherInit_ex(ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr, encrypt ? 1 : 0) == 1 &&
+              EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, static_cast<int>(kNonceSize), nullptr) == 1 &&
+              EVP_CipherInit_ex(ctx, nullptr, nullptr, key, nonce, -1) == 1 &&
+              EVP_CipherUpdate(ctx, nullptr, &len, aad, static_cast<int>(aadSize)) == 1 &&
+              EVP_CipherUpdate(ctx, out, &len, in, static_cast<int>(size)) == 1;
+
+    if (ok && !encrypt) {
+        ok = EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, static_cast<int>(kTagSize), tag) == 1;
+    }
+    ok = ok && EVP_CipherFinal_ex(ctx, out + len, &len) == 1;
+    if (ok && encrypt) {
+        ok = EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, static_cast<int>(kTagSize), tag) == 1;
+    }
+
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
+}
+
+} // namespace
+
+KeyStore::KeyStore(std::string rootPath)
+    : m_root(std::move(rootPath))
+{
+}
+
+std::string KeyStore::pathFor(std::string_view accountId) const
+{
+    std::string normalized(accountId);
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const uint8_t*>(normalized.data()), normalized.size(), digest);
+
+    static const char digits[] = "0123456789abcdef";
+    std::string name;
+    for (size_t i = 0; i < 16; ++i) {
+        name += digits[digest[i] >> 4];
+        name += digits[digest[i] & 0x0f];
+    }
+    return (fs::path(m_root) / (name + ".key")).string();
+}
+
+bool KeyStore::contains(std::string_view accountId) const
+{
+    std::error_code ec;
+    return fs::exists(pathFor(accountId), ec);
+}
+
+void KeyStore::store(std::string_view accountId, std::string_view password,
+                     const SecureBuffer& seed, const KeyDerivation::Params& params)
+{
+    if (seed.size() != kSeedSize) {
+        throw std::runtime_error("Keystore seed must be 32 bytes");
+    }
+
+    uint8_t file[kFileSize];
+    uint8_t* p = file;
+    std::memcpy(p, kMagic, kMagicSize);
+    p += kMagicSize;
+    *p++ = static_cast<uint8_t>(params.costLog2);
+    putU32(p, params.blockSize);
+    p += 4;
+    putU32(p, params.parallelism);
+    p += 4;
+    uint8_t* salt = p;
+    uint8_t* nonce = p + kSaltSize;
+    if (RAND_bytes(salt, static_cast<int>(kSaltSize + kNonceSize)) != 1) {
+        throw std::runtime_error("Failed to generate keystore salt");
+    }
+
+    SecureBuffer key(32);
+    KeyDerivation::stretch(password, salt, kSaltSize, params, key.data(), key.size());
+
+    if (!aesGcm(true, key.data(), nonce, file, kHeaderSize,
+                seed.data(), kSeedSize, file + kHeaderSize, file + kHeaderSize + kSeedSize)) {
+        throw std::runtime_error("Failed to encrypt keystore entry");
+    }
+
+    fs::path target = pathFor(accountId);
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+    if (ec) {
+        throw std::runtime_error("Failed to create keystore directory: " + ec.message());
+    }
+
+    // Write to a temporary file, sync it and rename, so a crash never leaves
+    // half an entry. mkstemp gives each call its own file, created owner-only
+    // regardless of the umask, so the entry is never readable by others.
+    std::string temp = target.string() + ".tmp.XXXXXX";
+    int fd = ::mkstemp(temp.data());
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create temporary keystore file: " + target.string());
+    }
+    bool written = ::fchmod(fd, S_IRUSR | S_IWUSR) == 0;
+    if (!written) {
+        ::close(fd);
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Failed to restrict keystore entry permissions: " + temp);
+    }
+    for (size_t offset = 0; written && offset < sizeof(file);) {
+        ssize_t n = ::write(fd, file + offset, sizeof(file) - offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        written = n > 0;
+        offset += written ? static_cast<size_t>(n) : 0;
+    }
+    written = written && ::fsync(fd) == 0;
+    written = ::close(fd) == 0 && written;
+    if (!written) {
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Failed to write keystore entry: " + temp);
+    }
+    fs::rename(temp, target, ec);
+    if (ec) {
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Failed to store keystore entry: " + ec.message());
+    }
+}
+
+std::optional<SecureBuffer> KeyStore::unlock(std::string_view accountId, std::string_view password) const
+{
+    std::ifstream in(pathFor(accountId), std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (file.size() != kFileSize || std::memcmp(file.data(), kMagic, kMagicSize) != 0) {
+        throw std::runtime_error("Corrupt keystore entry");
+    }
+
+    const uint8_t* p = file.data() + kMagicSize;
+    KeyDerivation::Params params;
+    params.costLog2 = p[0];
+    params.blockSize = getU32(p + 1);
+    params.parallelism = getU32(p + 5);
+    const uint8_t* salt = p + 9;
+    const uint8_t* nonce = salt + kSaltSize;
+
+    // The parameters are not authenticated until after the derivation, so
+    // bound them first
+    if (!KeyDerivation::isValid(params)) {
+        throw std::runtime_error("Corrupt keystore entry: scrypt parameters out of range");
+    }
+
+    SecureBuffer key(32);
+    KeyDerivation::stretch(password, salt, kSaltSize, params, key.data(), key.size());
+
+    SecureBuffer seed(kSeedSize);
+    uint8_t tag[kTagSize];
+    std::memcpy(tag, file.data() + kHeaderSize + kSeedSize, kTagSize);
+    if (!aesGcm(false, key.data(), nonce, file.data(), kHeaderSize,
+                file.data() + kHeaderSize, kSeedSize, seed.data(), tag)) {
+        throw std::runtime_error("Wrong password or corrupt keystore entry");
+    }
+    return seed;
+}
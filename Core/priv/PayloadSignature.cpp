@@ -0,0 +1,95 @@
+#include "PayloadSignature.h"
+
+#include "PgpKeyManager.h"
+#include "ScanMessage.h"
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace {
+
+// Through the entry's imported key when it has one, so the key is not imported per check
+bool verifyOpenPgp(const PublicKeyDirectory::Entry& key, const uint8_t* data, size_t size,
+                   const std::vector<uint8_t>& signature)
+{
+    if (key.openPgp) {
+        return key.openPgp->verify(data, size, signature.data(), signature.size());
+    }
+    return PgpKeyManager::verifyDetached(key.armored, std::string(reinterpret_cast<const char*>(data), size),
+                                         std::string(signature.begin(), signature.end()));
+}
+
+bool verifyOpenPgp(const PublicKeyDirectory::Entry& key, const ScanMessage& message,
+                   const std::vector<uint8_t>& signature)
+{
+    return verifyOpenPgp(key, message.data(), message.size(), signature);
+}
+
+bool verifyOpenPgp(const PublicKeyDirectory::Entry& key, const std::string& text,
+                   const std::vector<uint8_t>& signature)
+{
+    return verifyOpenPgp(key, reinterpret_cast<const uint8_t*>(text.data()), text.size(), signature);
+}
+
+bool verifyRaw(const PublicKeyDirectory::Entry& key, const ScanMessage& message,
+               const std::vector<uint8_t>& signature)
+{
+    Ed25519Signer::Signature raw;
+    if (key.fingerprint.isNull() || signature.size() != raw.size()) {
+        return false;
+    }
+    std::copy(signature.begin(), signature.end(), raw.begin());
+    return Ed25519Signer::verify(key.point, message.data(), message.size(), raw);
+}
+
+} // namespace
+
+bool PayloadSignature::verifyPit(const ScanPayload& pit, const PublicKeyDirectory::Entry& userKey)
+{
+    if (userKey.armored.empty() || pit.signature.empty()) {
+        return false;
+    }
+    try {
+        switch (pit.version) {
+        case 1:
+            return verifyOpenPgp(userKey, userKey.armored + std::to_string(pit.timestamp), pit.signature);
+        case 2:
+            return verifyRaw(userKey, ScanMessage::pit(pit.fingerprint, pit.timestamp), pit.signature);
+        case 3:
+            return verifyOpenPgp(userKey, ScanMessage::pit(pit.fingerprint, pit.timestamp), pit.signature);
+        default:
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool PayloadSignature::verifyTicket(const ScanPayload& ticket, const PublicKeyDirectory::Entry& userKey,
+                                    const PublicKeyDirectory::Entry& companyKey)
+{
+    if (companyKey.armored.empty() || ticket.signature.empty()) {
+        return false;
+    }
+    try {
+        switch (ticket.version) {
+        case 1:
+            return verifyOpenPgp(companyKey,
+                                 userKey.armored + ticket.bookingRef + std::to_string(ticket.timestamp),
+                                 ticket.signature);
+        case 2:
+            return verifyRaw(companyKey,
+                             ScanMessage::ticket(ticket.fingerprint, ticket.bookingRef, ticket.timestamp),
+                             ticket.signature);
+        case 3:
+            return verifyOpenPgp(companyKey,
+                                 ScanMessage::ticket(ticket.fingerprint, ticket.bookingRef, ticket.timestamp),
+                                 ticket.signature);
+        default:
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+}
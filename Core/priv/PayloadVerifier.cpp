@@ -0,0 +1,124 @@
+#include "PayloadVerifier.h"
+
+#include "PayloadSignature.h"
+#include "RevocationList.h"
+#include "ScanPayload.h"
+
+#include <stdexcept>
+
+PayloadVerifier::PayloadVerifier(PublicKeyDirectory& keys, std::string companyPublicKey,
+                                 PitValidityPolicy policy, std::shared_ptr<const Clock> clock)
+    : m_keys(keys)
+    , m_companyKey(companyPublicKey.empty() ? PublicKeyDirectory::Entry()
+                                            : PublicKeyDirectory::makeEntry(std::move(companyPublicKey)))
+    , m_policy(policy)
+    , m_clock(clock ? std::move(clock) : std::make_shared<SystemWallClock>())
+    // A PIT passes the freshness check for this long, so a replay is only possible inside it
+    , m_replays(policy.maxAgeSeconds + policy.graceSeconds + policy.futureSkewSeconds + 1)
+{
+    if (!m_companyKey.armored.empty() && m_companyKey.fingerprint.isNull()) {
+        throw std::runtime_error("Company public key is not an Ed25519 key");
+    }
+}
+
+void PayloadVerifier::setRevocationList(std::shared_ptr<const RevocationList> revocationList)
+{
+    std::atomic_store(&m_revocationList, std::move(revocationList));
+}
+
+PayloadVerifier::Result PayloadVerifier::finish(Result& result, Verdict verdict)
+{
+    result.verdict = verdict;
+    m_counts[static_cast<size_t>(verdict)].fetch_add(1, std::memory_order_relaxed);
+    return std::move(result);
+}
+
+PayloadVerifier::Result PayloadVerifier::verify(std::string_view pitText, std::string_view ticketText,
+                                                uint32_t gateId)
+{
+    Result result;
+    const int64_t now = m_clock->nowSeconds();
+
+    std::optional<ScanPayload> pit = ScanPayload::parse(pitText, ScanPayload::Kind::Pit);
+    if (!pit) {
+        m_pitStats.record(PitValidityPolicy::Verdict::Malformed);
+        return finish(result, Verdict::Malformed);
+    }
+    result.pitTimestamp = pit->timestamp;
+
+    const PitValidityPolicy::Verdict freshness = m_policy.check(pit->timestamp, now);
+    m_pitStats.record(freshness);
+    if (freshness == PitValidityPolicy::Verdict::Expired) {
+        return finish(result, Verdict::Expired);
+    }
+    if (freshness == PitValidityPolicy::Verdict::FromFuture) {
+        return finish(result, Verdict::FromFuture);
+    }
+    result.inGrace = freshness == PitValidityPolicy::Verdict::ValidInGrace;
+
+    std::optional<ScanPayload> ticket = ScanPayload::parse(ticketText, ScanPayload::Kind::Ticket);
+    if (!ticket) {
+        return finish(result, Verdict::Malformed);
+    }
+    result.ticketTimestamp = ticket->timestamp;
+    result.bookingRef = ticket->bookingRef;
+
+    if (auto revoked = std::atomic_load(&m_revocationList)) {
+        if (revoked->isRevoked(ticket->bookingRef)) {
+            return finish(result, Verdict::Revoked);
+        }
+    }
+
+    if (pit->fingerprint != ticket->fingerprint) {
+        return finish(result, Verdict::KeyMismatch);
+    }
+
+    // The directory is trusted storage, but still check it returned the key the codes name
+    std::shared_ptr<const PublicKeyDirectory::Entry> userKey = m_keys.resolve(pit->fingerprint.toHex());
+    if (!userKey || userKey->fingerprint != pit->fingerprint) {
+        return finish(result, Verdict::UnknownKey);
+    }
+
+    if (!PayloadSignature::verifyPit(*pit, *userKey)) {
+        return finish(result, Verdict::BadPitSignature);
+    }
+
+    if (!m_companyKey.armored.empty()) {
+        result.ticketSignatureChecked = true;
+        if (!PayloadSignature::verifyTicket(*ticket, *userKey, m_companyKey)) {
+            return finish(result, Verdict::BadTicketSignature);
+        }
+    }
+
+    // Only genuine uses are recorded, so forged codes cannot block a gate
+    if (m_replays.checkAndRecord(pit->fingerprint, pit->timestamp, gateId, now)) {
+        return finish(result, Verdict::Replayed);
+    }
+    return finish(result, Verdict::Valid);
+}
+
+std::array<uint64_t, PayloadVerifier::kVerdictCount> PayloadVerifier::verdictCounts() const
+{
+    std::array<uint64_t, kVerdictCount> counts{};
+    for (size_t i = 0; i < kVerdictCount; ++i) {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+const char* PayloadVerifier::verdictName(Verdict verdict)
+{
+    switch (verdict) {
+    case Verdict::Valid:              return "valid";
+    case Verdict::Malformed:          return "malformed";
+    case Verdict::Expired:            return "expired";
+    case Verdict::FromFuture:         return "from_future";
+    case Verdict::Revoked:            return "revoked";
+    case Verdict::KeyMismatch:        return "key_mismatch";
+    case Verdict::UnknownKey:         return "unknown_key";
+    case Verdict::BadPitSignature:    return "bad_pit_signature";
+    case Verdict::BadTicketSignature: return "bad_ticket_signature";
+    case Verdict::Replayed:           return "replayed";
+    }
+    return "unknown";
+}
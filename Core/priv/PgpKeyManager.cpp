@@ -1,5 +1,7 @@
 #include "PgpKeyManager.h"
 
+#include "PgpPublicKey.h"
+
 #include <stdexcept>
 #include <rnp/rnp.h>
 #include <rnp/rnp_err.h>
@@ -15,11 +17,38 @@ PgpKeyManager::PgpKeyManager(const std::string& userId)
 
     // Generate the keypair into this ffi
     generateKey();
+
+    // Resolve the key once; every later operation reuses this handle
+    m_key = locateUserKey();
+    if (!m_key) {
+        rnp_ffi_destroy(m_ffi);
+        m_ffi = nullptr;
+        throw std::runtime_error("Failed to locate generated user key");
+    }
+}
+
+// Constructor for imported keys: create ffi only
+PgpKeyManager::PgpKeyManager(NoKey)
+{
+    if (rnp_ffi_create(&m_ffi, "GPG", "GPG") != RNP_SUCCESS || !m_ffi) {
+        throw std::runtime_error("Failed to create RNP FFI");
+    }
+}
+
+std::unique_ptr<PgpKeyManager> PgpKeyManager::fromSecretKey(const std::string& armoredSecretKey)
+{
+    std::unique_ptr<PgpKeyManager> manager(new PgpKeyManager(NoKey{}));
+    manager->importSecretKey(armoredSecretKey);
+    return manager;
 }
 
-// Destructor: destroy ffi
+// Destructor: release key handle and destroy ffi
 PgpKeyManager::~PgpKeyManager()
 {
+    if (m_key) {
+        rnp_key_handle_destroy(m_key);
+        m_key = nullptr;
+    }
     if (m_ffi) {
         rnp_ffi_destroy(m_ffi);
         m_ffi = nullptr;
@@ -46,6 +75,45 @@ void PgpKeyManager::generateKey()
     rnp_buffer_destroy(gen_results);
 }
 
+void PgpKeyManager::importSecretKey(const std::string& armoredSecretKey)
+{
+    rnp_input_t key_input = nullptr;
+    if (rnp_input_from_memory(&key_input,
+                              reinterpret_cast<const uint8_t*>(armoredSecretKey.data()),
+                              armoredSecretKey.size(),
+                              false) != RNP_SUCCESS) {
+        throw std::runtime_error("Failed to create input for secret key");
+    }
+
+    if (rnp_import_keys(m_ffi, key_input, RNP_LOAD_SAVE_SECRET_KEYS, nullptr) != RNP_SUCCESS) {
+        rnp_input_destroy(key_input);
+        throw std::runtime_error("Failed to import secret key");
+    }
+    rnp_input_destroy(key_input);
+
+    // The imported keyring holds a single key: take the first one
+    rnp_identifier_iterator_t it = nullptr;
+    if (rnp_identifier_iterator_create(m_ffi, &it, "grip") != RNP_SUCCESS) {
+        throw std::runtime_error("Failed to create key iterator");
+    }
+
+    const char* grip = nullptr;
+    if (rnp_identifier_iterator_next(it, &grip) == RNP_SUCCESS && grip) {
+        rnp_locate_key(m_ffi, "grip", grip, &m_key);
+    }
+    rnp_identifier_iterator_destroy(it);
+
+    if (!m_key) {
+        throw std::runtime_error("No key found in imported secret key");
+    }
+
+    char* uid = nullptr;
+    if (rnp_key_get_primary_uid(m_key, &uid) == RNP_SUCCESS && uid) {
+        m_userId = uid;
+        rnp_buffer_destroy(uid);
+    }
+}
+
 // Helper: locate our key by userid (so we can export it)
 rnp_key_handle_t PgpKeyManager::locateUserKey() const
 {
@@ -56,109 +124,92 @@ rnp_key_handle_t PgpKeyManager::locateUserKey() const
     return key;
 }
 
-// Export armored public key (optional)
-std::string PgpKeyManager::exportPublicKeyArmored() const
+// Helper: export our key with the given flags
+std::string PgpKeyManager::exportKey(uint32_t flags) const
 {
-    rnp_key_handle_t key = locateUserKey();
-    if (!key) {
-        throw std::runtime_error("Failed to locate user key for public export");
+    rnp_output_t out = nullptr;
+    if (rnp_output_to_memory(&out, 0) != RNP_SUCCESS) {
+        throw std::runtime_error("Failed to create key output");
     }
 
-    uint32_t flags_pub = RNP_KEY_EXPORT_ARMORED |
-                         RNP_KEY_EXPORT_PUBLIC |
-                         RNP_KEY_EXPORT_SUBKEYS;
-
-    rnp_output_t pub_out = nullptr;
-    if (rnp_output_to_memory(&pub_out, 0) != RNP_SUCCESS) {
-        rnp_key_handle_destroy(key);
-        throw std::runtime_error("Failed to create public key output");
+    if (rnp_key_export(m_key, out, flags) != RNP_SUCCESS) {
+        rnp_output_destroy(out);
+        throw std::runtime_error("Key export failed");
     }
 
-    if (rnp_key_export(key, pub_out, flags_pub) != RNP_SUCCESS) {
-        rnp_output_destroy(pub_out);
-        rnp_key_handle_destroy(key);
-        throw std::runtime_error("Public key export failed");
+    uint8_t* buf = nullptr;
+    size_t   len = 0;
+    if (rnp_output_memory_get_buf(out, &buf, &len, false) != RNP_SUCCESS) {
+        rnp_output_destroy(out);
+        throw std::runtime_error("Failed to get key buffer");
     }
 
-    uint8_t* pub_buf = nullptr;
-    size_t   pub_len = 0;
-    if (rnp_output_memory_get_buf(pub_out, &pub_buf, &pub_len, false) != RNP_SUCCESS) {
-        rnp_output_destroy(pub_out);
-        rnp_key_handle_destroy(key);
-        throw std::runtime_error("Failed to get public key buffer");
-    }
+    std::string key(reinterpret_cast<const char*>(buf), len);
+    rnp_output_destroy(out);
 
-    std::string pubKey(reinterpret_cast<const char*>(pub_buf), pub_len);
-
-    rnp_output_destroy(pub_out);
-    rnp_key_handle_destroy(key);
+    return key;
+}
 
-    return pubKey;
+// Export armored public key (optional) - exported once, then served from cache
+const std::string& PgpKeyManager::exportPublicKeyArmored() const
+{
+    // Callers on several threads share one manager; the first one exports
+    std::call_once(m_publicKeyExported, [this] {
+        m_publicKeyArmored = exportKey(RNP_KEY_EXPORT_ARMORED |
+                                       RNP_KEY_EXPORT_PUBLIC |
+                                       RNP_KEY_EXPORT_SUBKEYS);
+    });
+    return m_publicKeyArmored;
 }
 
-// Export armored secret key (optional)
+// Export armored secret key (optional) - never cached
 std::string PgpKeyManager::exportSecretKeyArmored() const
 {
-    rnp_key_handle_t key = locateUserKey();
-    if (!key) {
-        throw std::runtime_error("Failed to locate user key for secret export");
-    }
-
-    uint32_t flags_sec = RNP_KEY_EXPORT_ARMORED |
-                         RNP_KEY_EXPORT_SECRET |
-                         RNP_KEY_EXPORT_SUBKEYS;
-
-    rnp_output_t sec_out = nullptr;
-    if (rnp_output_to_memory(&sec_out, 0) != RNP_SUCCESS) {
-        rnp_key_handle_destroy(key);
-        throw std::runtime_error("Failed to create secret key output");
-    }
-
-    if (rnp_key_export(key, sec_out, flags_sec) != RNP_SUCCESS) {
-        rnp_output_destroy(sec_out);
-        rnp_key_handle_destroy(key);
-        throw std::runtime_error("Secret key export failed");
-    }
-
-    uint8_t* sec_buf = nullptr;
-    size_t   sec_len = 0;
-    if (rnp_output_memory_get_buf(sec_out, &sec_buf, &sec_len, false) != RNP_SUCCESS) {
-        rnp_output_destroy(sec_out);
-        rnp_key_handle_destroy(key);
-        throw std::runtime_error("Failed to get secret key buffer");
-    }
+    return exportKey(RNP_KEY_EXPORT_ARMORED |
+                     RNP_KEY_EXPORT_SECRET |
+                     RNP_KEY_EXPORT_SUBKEYS);
+}
 
-    std::string secKey(reinterpret_cast<const char*>(sec_buf), sec_len);
+namespace {
 
-    rnp_output_destroy(sec_out);
-    rnp_key_handle_destroy(key);
+// rnp output callbacks that append straight into a caller-owned buffer
+bool appendToBuffer(void* app_ctx, const void* buf, size_t len)
+{
+    auto* out = static_cast<std::vector<uint8_t>*>(app_ctx);
+    const auto* bytes = static_cast<const uint8_t*>(buf);
+    out->insert(out->end(), bytes, bytes + len);
+    return true;
+}
 
-    return secKey;
+void closeBuffer(void*, bool)
+{
 }
 
+} // namespace
+
 // Sign data with the private key
 std::string PgpKeyManager::signData(const std::string& data) const
 {
-    rnp_key_handle_t key = locateUserKey();
-    if (!key) {
-        throw std::runtime_error("Failed to locate user key for signing");
-    }
+    std::vector<uint8_t> signature;
+    signData(reinterpret_cast<const uint8_t*>(data.data()), data.size(), signature);
+    return std::string(signature.begin(), signature.end());
+}
+
+// Sign data with the private key into a caller-provided buffer
+void PgpKeyManager::signData(const uint8_t* data, size_t size, std::vector<uint8_t>& signatureOut) const
+{
+    signatureOut.clear();
 
-    // Create input from data
+    // Create input from data (no copy)
     rnp_input_t input = nullptr;
-    if (rnp_input_from_memory(&input, 
-                              reinterpret_cast<const uint8_t*>(data.c_str()), 
-                              data.size(), 
-                              false) != RNP_SUCCESS) {
-        rnp_key_handle_destroy(key);
+    if (rnp_input_from_memory(&input, data, size, false) != RNP_SUCCESS) {
         throw std::runtime_error("Failed to create input for signing");
     }
 
-    // Create output for signature
+    // Signature bytes are written directly into signatureOut
     rnp_output_t output = nullptr;
-    if (rnp_output_to_memory(&output, 0) != RNP_SUCCESS) {
+    if (rnp_output_to_callback(&output, appendToBuffer, closeBuffer, &signatureOut) != RNP_SUCCESS) {
         rnp_input_destroy(input);
-        rnp_key_handle_destroy(key);
         throw std::runtime_error("Failed to create output for signature");
     }
 
@@ -167,16 +218,14 @@ std::string PgpKeyManager::signData(const std::string& data) const
     if (rnp_op_sign_detached_create(&sign_op, m_ffi, input, output) != RNP_SUCCESS) {
         rnp_output_destroy(output);
         rnp_input_destroy(input);
-        rnp_key_handle_destroy(key);
         throw std::runtime_error("Failed to create signing operation");
     }
 
     // Add signer
-    if (rnp_op_sign_add_signature(sign_op, key, nullptr) != RNP_SUCCESS) {
+    if (rnp_op_sign_add_signature(sign_op, m_key, nullptr) != RNP_SUCCESS) {
         rnp_op_sign_destroy(sign_op);
         rnp_output_destroy(output);
         rnp_input_destroy(input);
-        rnp_key_handle_destroy(key);
         throw std::runtime_error("Failed to add signer");
     }
 
@@ -185,28 +234,22 @@ std::string PgpKeyManager::signData(const std::string& data) const
         rnp_op_sign_destroy(sign_op);
         rnp_output_destroy(output);
         rnp_input_destroy(input);
-        rnp_key_handle_destroy(key);
         throw std::runtime_error("Signing operation failed");
     }
 
-    // Get signature
-    uint8_t* sig_buf = nullptr;
-    size_t sig_len = 0;
-    if (rnp_output_memory_get_buf(output, &sig_buf, &sig_len, false) != RNP_SUCCESS) {
-        rnp_op_sign_destroy(sign_op);
-        rnp_output_destroy(output);
-        rnp_input_destroy(input);
-        rnp_key_handle_destroy(key);
-        throw std::runtime_error("Failed to get signature buffer");
-    }
-
-    std::string signature(reinterpret_cast<const char*>(sig_buf), sig_len);
-
-    // Cleanup
+    // Cleanup (destroying the output flushes any buffered signature bytes)
     rnp_op_sign_destroy(sign_op);
     rnp_output_destroy(output);
     rnp_input_destroy(input);
-    rnp_key_handle_destroy(key);
+}
 
-    return signature;
+// Verify a detached signature against an armored public key, importing it for this one check
+bool PgpKeyManager::verifyDetached(const std::string& publicKeyArmored,
+                                   const std::string& data,
+                                   const std::string& signature)
+{
+    if (publicKeyArmored.empty() || signature.empty()) {
+        return false;
+    }
+    return PgpPublicKey(publicKeyArmored).verify(data, signature);
 }
@@ -0,0 +1,111 @@
+#include "PgpPublicKey.h"
+
+#include <utility>
+#include <rnp/rnp.h>
+#include <rnp/rnp_err.h>
+
+PgpPublicKey::PgpPublicKey(std::string armored)
+    : m_armored(std::move(armored))
+{
+}
+
+PgpPublicKey::~PgpPublicKey()
+{
+    for (rnp_ffi_t ffi : m_idle) {
+        rnp_ffi_destroy(ffi);
+    }
+}
+
+rnp_ffi_t PgpPublicKey::acquire() const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idle.empty()) {
+            rnp_ffi_t ffi = m_idle.back();
+            m_idle.pop_back();
+            return ffi;
+        }
+    }
+    if (m_armored.empty() || m_unusable.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    // No idle context: import the key into a new one, outside the lock
+    rnp_ffi_t ffi = nullptr;
+    if (rnp_ffi_create(&ffi, "GPG", "GPG") != RNP_SUCCESS || !ffi) {
+        return nullptr;
+    }
+
+    rnp_input_t key_input = nullptr;
+    if (rnp_input_from_memory(&key_input,
+                              reinterpret_cast<const uint8_t*>(m_armored.data()),
+                              m_armored.size(),
+                              false) != RNP_SUCCESS) {
+        rnp_ffi_destroy(ffi);
+        return nullptr;
+    }
+
+    bool imported = rnp_import_keys(ffi, key_input, RNP_LOAD_SAVE_PUBLIC_KEYS, nullptr) == RNP_SUCCESS;
+    rnp_input_destroy(key_input);
+    if (!imported) {
+        m_unusable.store(true, std::memory_order_relaxed);
+        rnp_ffi_destroy(ffi);
+        return nullptr;
+    }
+    return ffi;
+}
+
+void PgpPublicKey::release(rnp_ffi_t ffi) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle.push_back(ffi);
+}
+
+bool PgpPublicKey::verify(const uint8_t* data, size_t size, const uint8_t* signature, size_t signatureSize) const
+{
+    if (signatureSize == 0) {
+        return false;
+    }
+    rnp_ffi_t ffi = acquire();
+    if (!ffi) {
+        return false;
+    }
+
+    // Create inputs for data and signature
+    rnp_input_t data_input = nullptr;
+    if (rnp_input_from_memory(&data_input, data, size, false) != RNP_SUCCESS) {
+        release(ffi);
+        return false;
+    }
+
+    rnp_input_t sig_input = nullptr;
+    if (rnp_input_from_memory(&sig_input, signature, signatureSize, false) != RNP_SUCCESS) {
+        rnp_input_destroy(data_input);
+        release(ffi);
+        return false;
+    }
+
+    rnp_op_verify_t verify_op = nullptr;
+    if (rnp_op_verify_detached_create(&verify_op, ffi, data_input, sig_input) != RNP_SUCCESS) {
+        rnp_input_destroy(sig_input);
+        rnp_input_destroy(data_input);
+        release(ffi);
+        return false;
+    }
+
+    bool isValid = (rnp_op_verify_execute(verify_op) == RNP_SUCCESS);
+
+    // Cleanup; the context keeps only the imported key and goes back to the pool
+    rnp_op_verify_destroy(verify_op);
+    rnp_input_destroy(sig_input);
+    rnp_input_destroy(data_input);
+    release(ffi);
+
+    return isValid;
+}
+
+bool PgpPublicKey::verify(const std::string& data, const std::string& signature) const
+{
+    return verify(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                  reinterpret_cast<const uint8_t*>(signature.data()), signature.size());
+}
@@ -0,0 +1,167 @@
+#include "PitValidityPolicy.h"
+
+#include <cctype>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::string trim(const std::string& s)
+{
+    size_t begin = 0;
+    size_t end = s.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(s[begin]))) {
+        ++begin;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(s[end - 1]))) {
+        --end;
+    }
+    return s.substr(begin, end - begin);
+}
+
+int64_t parseSeconds(const std::string& key, const std::string& value)
+{
+    size_t used = 0;
+    long long seconds = 0;
+    try {
+        seconds = std::stoll(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (value.empty() || used != value.size() || seconds < 0) {
+        throw std::runtime_error("Invalid value for " + key + ": '" + value + "'");
+    }
+    if (seconds > PitValidityPolicy::kMaxSeconds) {
+        throw std::runtime_error("Value for " + key + " exceeds " + std::to_string(PitValidityPolicy::kMaxSeconds) +
+                                 " seconds: '" + value + "'");
+    }
+    return seconds;
+}
+
+// a + b and a - b, clamped to the int64_t range instead of overflowing
+int64_t saturatingAdd(int64_t a, int64_t b)
+{
+    if (b > 0 && a > std::numeric_limits<int64_t>::max() - b) {
+        return std::numeric_limits<int64_t>::max();
+    }
+    if (b < 0 && a < std::numeric_limits<int64_t>::min() - b) {
+        return std::numeric_limits<int64_t>::min();
+    }
+    return a + b;
+}
+
+int64_t saturatingSub(int64_t a, int64_t b)
+{
+    if (b < 0 && a > std::numeric_limits<int64_t>::max() + b) {
+        return std::numeric_limits<int64_t>::max();
+    }
+    if (b > 0 && a < std::numeric_limits<int64_t>::min() + b) {
+        return std::numeric_limits<int64_t>::min();
+    }
+    return a - b;
+}
+
+} // namespace
+
+PitValidityPolicy PitValidityPolicy::parse(const std::string& text)
+{
+    PitValidityPolicy policy;
+    std::istringstream in(text);
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error("Expected 'key = value' on line " + std::to_string(lineNumber));
+        }
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+
+        if (key == "max_age") {
+            policy.maxAgeSeconds = parseSeconds(key, value);
+        } else if (key == "future_skew") {
+            policy.futureSkewSeconds = parseSeconds(key, value);
+        } else if (key == "grace") {
+            policy.graceSeconds = parseSeconds(key, value);
+        } else {
+            throw std::runtime_error("Unknown PIT policy key '" + key + "' on line " + std::to_string(lineNumber));
+        }
+    }
+    return policy;
+}
+
+PitValidityPolicy PitValidityPolicy::loadFile(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open PIT policy file: " + path);
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    return parse(text.str());
+}
+
+PitValidityPolicy::Verdict PitValidityPolicy::check(int64_t timestamp, int64_t now) const
+{
+    // The timestamp is untrusted, so the bounds are moved instead of computing its age
+    if (timestamp > saturatingAdd(now, futureSkewSeconds)) {
+        return Verdict::FromFuture;
+    }
+    if (timestamp >= saturatingSub(now, maxAgeSeconds)) {
+        return Verdict::Valid;
+    }
+    if (timestamp >= saturatingSub(now, saturatingAdd(maxAgeSeconds, graceSeconds))) {
+        return Verdict::ValidInGrace;
+    }
+    return Verdict::Expired;
+}
+
+void PitValidityStats::record(PitValidityPolicy::Verdict verdict)
+{
+    switch (verdict) {
+    case PitValidityPolicy::Verdict::Valid:
+        m_valid.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case PitValidityPolicy::Verdict::ValidInGrace:
+        m_validInGrace.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case PitValidityPolicy::Verdict::Expired:
+        m_expired.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case PitValidityPolicy::Verdict::FromFuture:
+        m_fromFuture.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case PitValidityPolicy::Verdict::Malformed:
+        m_malformed.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+}
+
+PitValidityStats::Counts PitValidityStats::snapshot() const
+{
+    Counts counts;
+    counts.valid = m_valid.load(std::memory_order_relaxed);
+    counts.validInGrace = m_validInGrace.load(std::memory_order_relaxed);
+    counts.expired = m_expired.load(std::memory_order_relaxed);
+    counts.fromFuture = m_fromFuture.load(std::memory_order_relaxed);
+    counts.malformed = m_malformed.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void PitValidityStats::reset()
+{
+    m_valid = 0;
+    m_validInGrace = 0;
+    m_expired = 0;
+    m_fromFuture = 0;
+    m_malformed = 0;
+}
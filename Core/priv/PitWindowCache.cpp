@@ -0,0 +1,65 @@
+#include "PitWindowCache.h"
+
+#include <algorithm>
+#include <vector>
+
+PitWindowCache::PitWindowCache(int64_t windowSeconds)
+    : m_window(std::max<int64_t>(windowSeconds, 1))
+{
+}
+
+int64_t PitWindowCache::windowStart(int64_t time) const
+{
+    int64_t start = time - time % m_window;
+    return time < 0 && time % m_window != 0 ? start - m_window : start;
+}
+
+void PitWindowCache::fill(int64_t now, int64_t horizonSeconds, const SignFunction& sign,
+                          const std::atomic<bool>* cancelled)
+{
+    const int64_t first = windowStart(now);
+    const int64_t end = now + std::max<int64_t>(horizonSeconds, 0);
+
+    std::vector<int64_t> missing;
+    {
+        std::lock_guard lock(m_mutex);
+        m_payloads.erase(m_payloads.begin(), m_payloads.lower_bound(first));
+        for (int64_t start = first; start < end; start += m_window) {
+            if (m_payloads.find(start) == m_payloads.end()) {
+                missing.push_back(start);
+            }
+        }
+    }
+
+    // Sign outside the lock so lookups are never blocked by a burst
+    for (int64_t start : missing) {
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::string payload = sign(start);
+        std::lock_guard lock(m_mutex);
+        m_payloads.emplace(start, std::move(payload));
+    }
+}
+
+std::optional<std::string> PitWindowCache::lookup(int64_t now) const
+{
+    std::lock_guard lock(m_mutex);
+    auto it = m_payloads.find(windowStart(now));
+    if (it == m_payloads.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+int64_t PitWindowCache::coveredUntil() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_payloads.empty() ? 0 : m_payloads.rbegin()->first + m_window;
+}
+
+size_t PitWindowCache::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_payloads.size();
+}
@@ -0,0 +1,182 @@
+#include "PublicKeyDirectory.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string toLowerHex(std::string_view keyHash)
+{
+    std::string hash(keyHash);
+    std::transform(hash.begin(), hash.end(), hash.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return hash;
+}
+
+} // namespace
+
+PublicKeyDirectory::PublicKeyDirectory(std::string rootPath, size_t cacheCapacity)
+    : m_root(std::move(rootPath))
+    , m_capacity(std::max<size_t>(cacheCapacity, 1))
+{
+}
+
+bool PublicKeyDirectory::isValidKeyHash(std::string_view keyHash)
+{
+    return keyHash.size() == 16 &&
+           std::all_of(keyHash.begin(), keyHash.end(),
+                       [](unsigned char c) { return std::isxdigit(c) != 0; });
+}
+
+std::string PublicKeyDirectory::pathFor(const std::string& keyHash) const
+{
+    return (fs::path(m_root) / keyHash.substr(0, 2) / (keyHash + ".asc")).string();
+}
+
+void PublicKeyDirectory::registerKey(std::string_view keyHash, const std::string& publicKeyArmored)
+{
+    if (!isValidKeyHash(keyHash)) {
+        throw std::runtime_error("Invalid key hash: " + std::string(keyHash));
+    }
+
+    std::string hash = toLowerHex(keyHash);
+    fs::path target = pathFor(hash);
+
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+    if (ec) {
+        throw std::runtime_error("Failed to create key directory: " + ec.message());
+    }
+
+    // Write to a temporary file and rename, so readers never see half a key.
+    // The name is unique per call, so concurrent registrations of the same
+    // key (threads or processes sharing the directory) never write one file.
+    std::string temp = target.string() + ".tmp.XXXXXX";
+    int fd = ::mkstemp(temp.data());
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create temporary key file: " + target.string());
+    }
+    bool written = ::fchmod(fd, 0644) == 0;
+    for (size_t offset = 0; written && offset < publicKeyArmored.size();) {
+        ssize_t n = ::write(fd, publicKeyArmored.data() + offset, publicKeyArmored.size() - offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        written = n > 0;
+        offset += written ? static_cast<size_t>(n) : 0;
+    }
+    written = ::close(fd) == 0 && written;
+    if (!written) {
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Failed to write public key: " + temp);
+    }
+    fs::rename(temp, target, ec);
+    if (ec) {
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Failed to store public key: " + ec.message());
+    }
+
+    auto entry = std::make_shared<const Entry>(makeEntry(publicKeyArmored));
+    std::lock_guard lock(m_mutex);
+    cacheLocked(hash, std::move(entry));
+}
+
+PublicKeyDirectory::Entry PublicKeyDirectory::makeEntry(std::string publicKeyArmored)
+{
+    Entry entry;
+    entry.armored = std::move(publicKeyArmored);
+    entry.openPgp = std::make_shared<const PgpPublicKey>(entry.armored);
+    if (auto point = Ed25519Signer::publicKeyFromOpenPgp(entry.armored)) {
+        entry.point = *point;
+        entry.fingerprint = KeyFingerprint::fromEd25519(*point);
+    }
+    return entry;
+}
+
+std::optional<std::string> PublicKeyDirectory::find(std::string_view keyHash)
+{
+    std::shared_ptr<const Entry> entry = resolve(keyHash);
+    if (!entry) {
+        return std::nullopt;
+    }
+    return entry->armored;
+}
+
+std::shared_ptr<const PublicKeyDirectory::Entry> PublicKeyDirectory::resolve(std::string_view keyHash)
+{
+    if (!isValidKeyHash(keyHash)) {
+        return nullptr;
+    }
+
+    std::string hash = toLowerHex(keyHash);
+
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_index.find(hash);
+        if (it != m_index.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            ++m_hits;
+            return it->second->second;
+        }
+        ++m_misses;
+    }
+
+    // Cold path: read from disk outside the lock
+    std::ifstream in(pathFor(hash), std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    std::string publicKey = buffer.str();
+    if (publicKey.empty()) {
+        return nullptr;
+    }
+
+    // Parsed outside the lock too, once per cache fill
+    auto entry = std::make_shared<const Entry>(makeEntry(std::move(publicKey)));
+    std::lock_guard lock(m_mutex);
+    cacheLocked(hash, entry);
+    return entry;
+}
+
+void PublicKeyDirectory::cacheLocked(const std::string& keyHash, std::shared_ptr<const Entry> entry)
+{
+    auto it = m_index.find(keyHash);
+    if (it != m_index.end()) {
+        it->second->second = std::move(entry);
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return;
+    }
+
+    m_lru.emplace_front(keyHash, std::move(entry));
+    m_index[keyHash] = m_lru.begin();
+
+    if (m_lru.size() > m_capacity) {
+        m_index.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+}
+
+size_t PublicKeyDirectory::cacheHits() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_hits;
+}
+
+size_t PublicKeyDirectory::cacheMisses() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_misses;
+}
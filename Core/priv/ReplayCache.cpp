@@ -0,0 +1,66 @@
+#include "ReplayCache.h"
+
+#include <cstring>
+
+ReplayCache::ReplayCache(int64_t windowSeconds, size_t capacity)
+    : m_window(windowSeconds)
+    , m_capacity(capacity == 0 ? 1 : capacity)
+{
+}
+
+size_t ReplayCache::KeyHash::operator()(const Key& key) const
+{
+    // The fingerprint is already a hash, so its bytes are mixed in as is
+    uint64_t bits = 0;
+    std::memcpy(&bits, key.fingerprint.data(), sizeof(bits));
+    return static_cast<size_t>(bits ^ (static_cast<uint64_t>(key.timestamp) * 0x9E3779B97F4A7C15ULL));
+}
+
+bool ReplayCache::checkAndRecord(const KeyFingerprint& fingerprint, int64_t pitTimestamp, uint32_t gateId,
+                                 int64_t now)
+{
+    const Key key{fingerprint.bytes(), pitTimestamp};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    expireLocked(now);
+
+    auto [it, inserted] = m_entries.emplace(key, Entry{gateId, now + m_window});
+    if (inserted) {
+        m_order.emplace_back(now + m_window, key);
+        if (m_entries.size() > m_capacity) {
+            m_entries.erase(m_order.front().second);
+            m_order.pop_front();
+        }
+        return false;
+    }
+
+    if (it->second.gateId != gateId) {
+        ++m_replays;
+        return true;
+    }
+    return false;
+}
+
+void ReplayCache::expireLocked(int64_t now)
+{
+    // Entries are appended with non-decreasing expiry, so expired ones are at the front
+    while (!m_order.empty() && m_order.front().first <= now) {
+        auto it = m_entries.find(m_order.front().second);
+        if (it != m_entries.end() && it->second.expiresAt <= now) {
+            m_entries.erase(it);
+        }
+        m_order.pop_front();
+    }
+}
+
+size_t ReplayCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+uint64_t ReplayCache::replays() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_replays;
+}
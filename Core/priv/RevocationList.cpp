@@ -0,0 +1,358 @@
+#include "RevocationList.h"
+#include "PgpKeyManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char   kMagic[8]      = {'S', 'B', 'B', 'R', 'V', 'K', '0', '1'};
+constexpr size_t kHeaderSize    = 8 + 1 + 7 + 8 * 4;
+constexpr size_t kBitsPerKey    = 12;   // ~0.5% false positives with 7 probes
+constexpr size_t kProbes        = 7;
+constexpr size_t kWordsPerBlock = 8;    // 512-bit block = one cache line
+
+// splitmix64 finalizer - keys are dense base-37 numbers, so mix them well
+uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t readU64(const std::string& data, size_t offset)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value = (value << 8) | static_cast<uint8_t>(data[offset + i]);
+    }
+    return value;
+}
+
+void appendU64(std::string& out, uint64_t value)
+{
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+std::vector<uint64_t> readKeys(const std::string& data, size_t offset, uint64_t count)
+{
+    std::vector<uint64_t> keys;
+    keys.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        keys.push_back(readU64(data, offset + i * 8));
+    }
+    return keys;
+}
+
+void sortUnique(std::vector<uint64_t>& keys)
+{
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+std::string readWholeFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open revocation file: " + path);
+    }
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+} // namespace
+
+// ---- Filter ------------------------------------------------------
+
+void RevocationList::Filter::reset(size_t expectedKeys)
+{
+    capacity = std::max<size_t>(expectedKeys, 1024);
+    blocks   = (capacity * kBitsPerKey + 511) / 512;
+    inserted = 0;
+    words.assign(blocks * kWordsPerBlock, 0);
+}
+
+void RevocationList::Filter::insert(uint64_t key)
+{
+    uint64_t h1 = mix(key);
+    uint64_t h2 = mix(h1);
+    uint64_t* block = &words[(h1 % blocks) * kWordsPerBlock];
+    for (size_t i = 0; i < kProbes; ++i) {
+        uint32_t bit = (h2 >> (i * 9)) & 511;
+        block[bit >> 6] |= 1ULL << (bit & 63);
+    }
+    ++inserted;
+}
+
+bool RevocationList::Filter::mayContain(uint64_t key) const
+{
+    if (blocks == 0) {
+        return false;
+    }
+    uint64_t h1 = mix(key);
+    uint64_t h2 = mix(h1);
+    const uint64_t* block = &words[(h1 % blocks) * kWordsPerBlock];
+    for (size_t i = 0; i < kProbes; ++i) {
+        uint32_t bit = (h2 >> (i * 9)) & 511;
+        if (!(block[bit >> 6] & (1ULL << (bit & 63)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---- RevocationList ----------------------------------------------
+
+uint64_t RevocationList::keyFor(std::string_view bookingRef)
+{
+    // Base 37 with 0 reserved, so references of different lengths never collide
+    if (bookingRef.empty() || bookingRef.size() > 12) {
+        return 0;
+    }
+
+    uint64_t key = 0;
+    for (char c : bookingRef) {
+        uint64_t digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = 1 + (c - '0');
+        } else if (c >= 'A' && c <= 'Z') {
+            digit = 11 + (c - 'A');
+        } else if (c >= 'a' && c <= 'z') {
+            digit = 11 + (c - 'a');
+        } else {
+            return 0;
+        }
+        key = key * 37 + digit;
+    }
+    return key;
+}
+
+std::string RevocationList::serialize(FileKind kind, uint64_t version, uint64_t baseVersion,
+                                      std::vector<uint64_t> adds, std::vector<uint64_t> removes)
+{
+    sortUnique(adds);
+    sortUnique(removes);
+
+    std::string out;
+    out.reserve(kHeaderSize + (adds.size() + removes.size()) * 8);
+    out.append(kMagic, sizeof(kMagic));
+    out.push_back(static_cast<char>(kind));
+    out.append(7, '\0');
+    appendU64(out, version);
+    appendU64(out, baseVersion);
+    appendU64(out, adds.size());
+    appendU64(out, removes.size());
+    for (uint64_t key : adds) {
+        appendU64(out, key);
+    }
+    for (uint64_t key : removes) {
+        appendU64(out, key);
+    }
+    return out;
+}
+
+void RevocationList::loadFile(const std::string& path, const std::string& companyPublicKey)
+{
+    std::string data = readWholeFile(path);
+    std::string signature = readWholeFile(path + ".sig");
+
+    if (!PgpKeyManager::verifyDetached(companyPublicKey, data, signature)) {
+        throw std::runtime_error("Revocation file signature is invalid: " + path);
+    }
+
+    load(data);
+}
+
+void RevocationList::load(const std::string& data)
+{
+    if (data.size() < kHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a revocation list file");
+    }
+
+    auto kind          = static_cast<FileKind>(static_cast<uint8_t>(data[8]));
+    uint64_t version   = readU64(data, 16);
+    uint64_t base      = readU64(data, 24);
+    uint64_t addCount  = readU64(data, 32);
+    uint64_t remCount  = readU64(data, 40);
+
+    // Check the counts against the actual size before allocating anything
+    uint64_t payload = data.size() - kHeaderSize;
+    if (payload % 8 != 0 || addCount > payload / 8 || remCount != payload / 8 - addCount) {
+        throw std::runtime_error("Revocation list is truncated or has trailing data");
+    }
+
+    std::vector<uint64_t> adds = readKeys(data, kHeaderSize, addCount);
+    std::vector<uint64_t> removes = readKeys(data, kHeaderSize + addCount * 8, remCount);
+
+    std::unique_lock lock(m_mutex);
+    if (kind == FileKind::Full) {
+        if (!removes.empty()) {
+            throw std::runtime_error("Full revocation list cannot contain removals");
+        }
+        if (version < m_version) {
+            throw std::runtime_error("Revocation list version " + std::to_string(version) +
+                                     " is older than loaded version " + std::to_string(m_version));
+        }
+        applyFull(version, std::move(adds));
+    } else if (kind == FileKind::Delta) {
+        if (base != m_version) {
+            throw std::runtime_error("Revocation delta applies to version " + std::to_string(base) +
+                                     " but loaded version is " + std::to_string(m_version));
+        }
+        if (version <= base) {
+            throw std::runtime_error("Revocation delta to version " + std::to_string(version) +
+                                     " does not advance version " + std::to_string(base));
+        }
+        applyDelta(version, std::move(adds), std::move(removes));
+    } else {
+        throw std::runtime_error("Unknown revocation file kind");
+    }
+}
+
+void RevocationList::applyFull(uint64_t version, std::vector<uint64_t> adds)
+{
+    sortUnique(adds);
+
+    m_base = std::move(adds);
+    m_added.clear();
+    m_removed.clear();
+
+    // Leave headroom so typical deltas fit without resizing the filter
+    m_filter.reset(m_base.size() + m_base.size() / 8);
+    for (uint64_t key : m_base) {
+        m_filter.insert(key);
+    }
+
+    m_version = version;
+}
+
+void RevocationList::applyDelta(uint64_t version, std::vector<uint64_t> adds, std::vector<uint64_t> removes)
+{
+    sortUnique(adds);
+    sortUnique(removes);
+
+    // Invariants: m_added and m_base are disjoint, m_removed is a subset of m_base
+    std::vector<uint64_t> newAdds;
+    std::vector<uint64_t> reinstated;
+    for (uint64_t key : adds) {
+        if (std::binary_search(m_removed.begin(), m_removed.end(), key)) {
+            reinstated.push_back(key);
+        } else if (!std::binary_search(m_base.begin(), m_base.end(), key)) {
+            newAdds.push_back(key);
+        }
+    }
+
+    std::vector<uint64_t> droppedAdds;
+    std::vector<uint64_t> newRemoves;
+    for (uint64_t key : removes) {
+        if (std::binary_search(m_added.begin(), m_added.end(), key) ||
+            std::binary_search(newAdds.begin(), newAdds.end(), key)) {
+            droppedAdds.push_back(key);
+        } else if (std::binary_search(m_base.begin(), m_base.end(), key)) {
+            newRemoves.push_back(key);
+        }
+    }
+
+    // Removals can't clear filter bits; stale bits just fall through to the exact sets
+    for (uint64_t key : newAdds) {
+        m_filter.insert(key);
+    }
+
+    std::vector<uint64_t> merged;
+    merged.reserve(m_added.size() + newAdds.size());
+    std::merge(m_added.begin(), m_added.end(), newAdds.begin(), newAdds.end(), std::back_inserter(merged));
+    m_added.clear();
+    std::set_difference(merged.begin(), merged.end(), droppedAdds.begin(), droppedAdds.end(),
+                        std::back_inserter(m_added));
+
+    std::vector<uint64_t> removed;
+    std::set_difference(m_removed.begin(), m_removed.end(), reinstated.begin(), reinstated.end(),
+                        std::back_inserter(removed));
+    m_removed.clear();
+    std::set_union(removed.begin(), removed.end(), newRemoves.begin(), newRemoves.end(),
+                   std::back_inserter(m_removed));
+
+    m_version = version;
+
+    if (m_added.size() + m_removed.size() > std::max<size_t>(4096, m_base.size() / 8)) {
+        compactLocked();
+    }
+}
+
+void RevocationList::compactLocked()
+{
+    std::vector<uint64_t> kept;
+    kept.reserve(m_base.size() - m_removed.size());
+    std::set_difference(m_base.begin(), m_base.end(), m_removed.begin(), m_removed.end(),
+                        std::back_inserter(kept));
+
+    std::vector<uint64_t> merged;
+    merged.reserve(kept.size() + m_added.size());
+    std::merge(kept.begin(), kept.end(), m_added.begin(), m_added.end(), std::back_inserter(merged));
+
+    m_base = std::move(merged);
+    m_added.clear();
+    m_removed.clear();
+
+    // Only rebuild the filter once it is past what it was sized for
+    if (m_filter.inserted > m_filter.capacity) {
+        m_filter.reset(m_base.size() + m_base.size() / 8);
+        for (uint64_t key : m_base) {
+            m_filter.insert(key);
+        }
+    }
+}
+
+bool RevocationList::containsLocked(uint64_t key) const
+{
+    if (!m_filter.mayContain(key)) {
+        return false;
+    }
+    if (std::binary_search(m_added.begin(), m_added.end(), key)) {
+        return true;
+    }
+    return std::binary_search(m_base.begin(), m_base.end(), key) &&
+           !std::binary_search(m_removed.begin(), m_removed.end(), key);
+}
+
+bool RevocationList::isRevokedKey(uint64_t key) const
+{
+    if (key == 0) {
+        return false;
+    }
+    std::shared_lock lock(m_mutex);
+    return containsLocked(key);
+}
+
+bool RevocationList::isRevoked(std::string_view bookingRef) const
+{
+    return isRevokedKey(keyFor(bookingRef));
+}
+
+uint64_t RevocationList::version() const
+{
+    std::shared_lock lock(m_mutex);
+    return m_version;
+}
+
+size_t RevocationList::size() const
+{
+    std::shared_lock lock(m_mutex);
+    return m_base.size() + m_added.size() - m_removed.size();
+}
+
+size_t RevocationList::memoryFootprint() const
+{
+    std::shared_lock lock(m_mutex);
+    return (m_filter.words.capacity() + m_base.capacity() + m_added.capacity() + m_removed.capacity()) *
+           sizeof(uint64_t);
+}
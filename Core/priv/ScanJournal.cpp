@@ -0,0 +1,357 @@
+#include "ScanJournal.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char     kMagic[8]        = {'S', 'B', 'B', 'J', 'R', 'N', '0', '1'};
+constexpr size_t   kExtent          = 1u << 20;   // grow the file 1 MiB at a time
+constexpr size_t   kChecksumOffset  = ScanJournal::kRecordSize - 4;
+constexpr auto     kCommitInterval  = std::chrono::milliseconds(50);
+
+void putU32(uint8_t* out, uint32_t value)
+{
+    for (int i = 3; i >= 0; --i) {
+        out[i] = static_cast<uint8_t>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+void putU64(uint8_t* out, uint64_t value)
+{
+    for (int i = 7; i >= 0; --i) {
+        out[i] = static_cast<uint8_t>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+uint32_t getU32(const uint8_t* in)
+{
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | in[3];
+}
+
+uint64_t getU64(const uint8_t* in)
+{
+    return (uint64_t(getU32(in)) << 32) | getU32(in + 4);
+}
+
+uint32_t fnv1a(const uint8_t* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void encodeRecord(const ScanJournal::Entry& entry, uint8_t* out)
+{
+    std::memset(out, 0, ScanJournal::kRecordSize);
+    putU64(out + 0, static_cast<uint64_t>(entry.scanTime));
+    putU64(out + 8, static_cast<uint64_t>(entry.pitTimestamp));
+    putU64(out + 16, static_cast<uint64_t>(entry.ticketTimestamp));
+
+    uint32_t flags = entry.flags & ~uint32_t(ScanJournal::BookingRefTruncated);
+    if (entry.bookingRef.size() > ScanJournal::kMaxBookingRef) {
+        flags |= ScanJournal::BookingRefTruncated;
+    }
+    putU32(out + 24, flags);
+    putU32(out + 28, entry.decodeMicros);
+    putU32(out + 32, entry.verifyMicros);
+    putU32(out + 36, entry.totalMicros);
+
+    std::memcpy(out + 40, entry.keyHash.data(), std::min(entry.keyHash.size(), ScanJournal::kMaxKeyHash));
+    const size_t refSize = std::min(entry.bookingRef.size(), ScanJournal::kMaxBookingRef);
+    out[56] = static_cast<uint8_t>(refSize);
+    std::memcpy(out + 57, entry.bookingRef.data(), refSize);
+
+    putU32(out + kChecksumOffset, fnv1a(out, kChecksumOffset));
+}
+
+// False for an empty (zero) or torn record
+bool decodeRecord(const uint8_t* in, ScanJournal::Entry& entry)
+{
+    if (getU64(in) == 0 || getU32(in + kChecksumOffset) != fnv1a(in, kChecksumOffset)) {
+        return false;
+    }
+    entry.scanTime = static_cast<int64_t>(getU64(in + 0));
+    entry.pitTimestamp = static_cast<int64_t>(getU64(in + 8));
+    entry.ticketTimestamp = static_cast<int64_t>(getU64(in + 16));
+    entry.flags = getU32(in + 24);
+    entry.decodeMicros = getU32(in + 28);
+    entry.verifyMicros = getU32(in + 32);
+    entry.totalMicros = getU32(in + 36);
+
+    const char* keyHash = reinterpret_cast<const char*>(in + 40);
+    entry.keyHash.assign(keyHash, strnlen(keyHash, ScanJournal::kMaxKeyHash));
+    const size_t refSize = std::min<size_t>(in[56], ScanJournal::kMaxBookingRef);
+    entry.bookingRef.assign(reinterpret_cast<const char*>(in + 57), refSize);
+    return true;
+}
+
+std::runtime_error systemError(const std::string& what, const std::string& path)
+{
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+ScanJournal::ScanJournal(const std::string& path)
+    : m_path(path)
+{
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (m_fd < 0) {
+        throw systemError("Cannot open scan journal", path);
+    }
+
+    // Two writers would both append at their own end offset and overwrite each other
+    if (::flock(m_fd, LOCK_EX | LOCK_NB) != 0) {
+        const int error = errno;
+        ::close(m_fd);
+        if (error == EWOULDBLOCK) {
+            throw std::runtime_error("Scan journal is already open for writing: " + path);
+        }
+        errno = error;
+        throw systemError("Cannot lock scan journal", path);
+    }
+
+    struct stat st {};
+    if (::fstat(m_fd, &st) != 0) {
+        ::close(m_fd);
+        throw systemError("Cannot stat scan journal", path);
+    }
+
+    try {
+        if (st.st_size == 0) {
+            ensureCapacity(kHeaderSize);
+            std::memcpy(m_map, kMagic, sizeof(kMagic));
+            putU32(m_map + 8, kRecordSize);
+            const auto now = std::chrono::system_clock::now().time_since_epoch();
+            putU64(m_map + 16, std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+            ::msync(m_map, kHeaderSize, MS_SYNC);
+        } else {
+            map(static_cast<size_t>(st.st_size));
+            if (m_mapSize < kHeaderSize || std::memcmp(m_map, kMagic, sizeof(kMagic)) != 0 ||
+                getU32(m_map + 8) != kRecordSize) {
+                throw std::runtime_error("Not a scan journal: " + path);
+            }
+        }
+
+        // Append after the last intact record; a torn tail is overwritten
+        Entry scratch;
+        m_end = kHeaderSize;
+        while (m_end + kRecordSize <= m_mapSize && decodeRecord(m_map + m_end, scratch)) {
+            m_end += kRecordSize;
+        }
+    } catch (...) {
+        if (m_map) {
+            ::munmap(m_map, m_mapSize);
+        }
+        ::close(m_fd);
+        throw;
+    }
+
+    m_thread = std::thread(&ScanJournal::commitLoop, this);
+}
+
+ScanJournal::~ScanJournal()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+
+    if (m_map) {
+        ::msync(m_map, m_mapSize, MS_SYNC);
+        ::munmap(m_map, m_mapSize);
+    }
+    ::close(m_fd);
+}
+
+bool ScanJournal::append(const Entry& entry)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_queue.size() >= kMaxQueued) {
+            ++m_dropped;
+            return false;
+        }
+        m_queue.push_back(entry);
+        ++m_appended;
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+void ScanJournal::flush()
+{
+    std::unique_lock lock(m_mutex);
+    const uint64_t target = m_appended;
+    m_wake.notify_one();
+    m_committed.wait(lock, [&] { return m_committedCount >= target || m_stop; });
+}
+
+ScanJournal::Stats ScanJournal::stats() const
+{
+    std::lock_guard lock(m_mutex);
+    Stats stats;
+    stats.appended = m_appended;
+    stats.committed = m_committedCount;
+    stats.dropped = m_dropped;
+    stats.batches = m_batches;
+    return stats;
+}
+
+void ScanJournal::commitLoop()
+{
+    std::vector<Entry> batch;
+    std::unique_lock lock(m_mutex);
+
+    while (true) {
+        m_wake.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty() && m_stop) {
+            break;
+        }
+
+        // Let a burst of scans accumulate so they share one msync
+        if (!m_stop) {
+            m_wake.wait_for(lock, kCommitInterval, [&] { return m_stop; });
+        }
+
+        batch.swap(m_queue);
+        lock.unlock();
+
+        try {
+            commitBatch(batch);
+        } catch (const std::exception&) {
+            // Disk full or similar: the batch is lost, but the scan path must not fail
+            lock.lock();
+            m_dropped += batch.size();
+            m_committedCount += batch.size();
+            m_committed.notify_all();
+            batch.clear();
+            continue;
+        }
+
+        lock.lock();
+        m_committedCount += batch.size();
+        ++m_batches;
+        m_committed.notify_all();
+        batch.clear();
+    }
+
+    m_committed.notify_all();
+}
+
+void ScanJournal::commitBatch(const std::vector<Entry>& batch)
+{
+    const size_t bytes = batch.size() * kRecordSize;
+    ensureCapacity(m_end + bytes);
+
+    const size_t start = m_end;
+    for (const Entry& entry : batch) {
+        encodeRecord(entry, m_map + m_end);
+        m_end += kRecordSize;
+    }
+
+    // msync needs a page-aligned start
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t syncStart = start - start % page;
+    if (::msync(m_map + syncStart, m_end - syncStart, MS_SYNC) != 0) {
+        throw systemError("Cannot sync scan journal", m_path);
+    }
+}
+
+void ScanJournal::ensureCapacity(size_t bytes)
+{
+    if (bytes <= m_mapSize) {
+        return;
+    }
+
+    const size_t newSize = (bytes + kExtent - 1) / kExtent * kExtent;
+    if (::ftruncate(m_fd, static_cast<off_t>(newSize)) != 0) {
+        throw systemError("Cannot grow scan journal", m_path);
+    }
+    map(newSize);
+}
+
+void ScanJournal::map(size_t size)
+{
+    if (m_map) {
+        ::munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+
+    void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (mapped == MAP_FAILED) {
+        throw systemError("Cannot map scan journal", m_path);
+    }
+    m_map = static_cast<uint8_t*>(mapped);
+    m_mapSize = size;
+}
+
+ScanJournal::Reader::Reader(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw systemError("Cannot open scan journal", path);
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error("Not a scan journal: " + path);
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw systemError("Cannot map scan journal", path);
+    }
+    m_data = static_cast<const uint8_t*>(mapped);
+
+    if (std::memcmp(m_data, kMagic, sizeof(kMagic)) != 0 || getU32(m_data + 8) != kRecordSize) {
+        ::munmap(mapped, m_size);
+        throw std::runtime_error("Not a scan journal: " + path);
+    }
+
+    // Records are read once, front to back
+    ::madvise(mapped, m_size, MADV_SEQUENTIAL);
+    m_slots = (m_size - kHeaderSize) / kRecordSize;
+}
+
+ScanJournal::Reader::~Reader()
+{
+    ::munmap(const_cast<uint8_t*>(m_data), m_size);
+}
+
+bool ScanJournal::Reader::read(size_t index, Entry& entry) const
+{
+    return index < m_slots && decodeRecord(m_data + kHeaderSize + index * kRecordSize, entry);
+}
+
+std::vector<ScanJournal::Entry> ScanJournal::readAll(const std::string& path)
+{
+    Reader reader(path);
+
+    std::vector<Entry> entries;
+    Entry entry;
+    for (size_t i = 0; i < reader.slots() && reader.read(i, entry); ++i) {
+        entries.push_back(entry);
+    }
+    return entries;
+}
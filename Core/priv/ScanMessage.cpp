@@ -0,0 +1,88 @@
+#include "ScanMessage.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr char kPitDomain[]    = "SBB-PIT";
+constexpr char kTicketDomain[] = "SBB-TKT";
+constexpr size_t kDomainSize   = sizeof(kPitDomain) - 1;
+
+KeyFingerprint parseKeyHash(std::string_view keyHash)
+{
+    auto fingerprint = KeyFingerprint::fromHex(keyHash);
+    if (!fingerprint) {
+        throw std::runtime_error("Invalid key hash: " + std::string(keyHash));
+    }
+    return *fingerprint;
+}
+
+} // namespace
+
+ScanMessage ScanMessage::pit(const KeyFingerprint& fingerprint, int64_t timestamp)
+{
+    ScanMessage message;
+    message.append(kPitDomain, kDomainSize);
+    message.append(&kVersion, 1);
+    message.appendFingerprint(fingerprint);
+    message.appendTimestamp(timestamp);
+    return message;
+}
+
+ScanMessage ScanMessage::ticket(const KeyFingerprint& fingerprint, std::string_view bookingRef, int64_t timestamp)
+{
+    if (bookingRef.empty() || bookingRef.size() > kMaxBookingRefSize) {
+        throw std::runtime_error("Invalid booking reference length: " + std::to_string(bookingRef.size()));
+    }
+
+    ScanMessage message;
+    message.append(kTicketDomain, kDomainSize);
+    message.append(&kVersion, 1);
+    message.appendFingerprint(fingerprint);
+    uint8_t refSize = static_cast<uint8_t>(bookingRef.size());
+    message.append(&refSize, 1);
+    message.append(bookingRef.data(), bookingRef.size());
+    message.appendTimestamp(timestamp);
+    return message;
+}
+
+ScanMessage ScanMessage::pit(std::string_view keyHash, int64_t timestamp)
+{
+    return pit(parseKeyHash(keyHash), timestamp);
+}
+
+ScanMessage ScanMessage::ticket(std::string_view keyHash, std::string_view bookingRef, int64_t timestamp)
+{
+    return ticket(parseKeyHash(keyHash), bookingRef, timestamp);
+}
+
+void ScanMessage::append(const void* data, size_t size)
+{
+    // Sizes are bounded by the factories, so this never overflows kMaxSize
+    std::memcpy(m_bytes.data() + m_size, data, size);
+    m_size += size;
+}
+
+void ScanMessage::appendFingerprint(const KeyFingerprint& fingerprint)
+{
+    if (fingerprint.isNull()) {
+        throw std::runtime_error("Missing key fingerprint");
+    }
+
+    uint8_t size = static_cast<uint8_t>(KeyFingerprint::kSize);
+    append(&size, 1);
+    append(fingerprint.bytes().data(), KeyFingerprint::kSize);
+}
+
+void ScanMessage::appendTimestamp(int64_t timestamp)
+{
+    uint64_t value = static_cast<uint64_t>(timestamp);
+    uint8_t bytes[8];
+    for (int i = 7; i >= 0; --i) {
+        bytes[i] = static_cast<uint8_t>(value & 0xff);
+        value >>= 8;
+    }
+    append(bytes, sizeof(bytes));
+}
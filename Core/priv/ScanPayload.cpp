@@ -0,0 +1,94 @@
+#include "ScanPayload.h"
+
+#include "ScanMessage.h"
+
+#include <charconv>
+
+namespace {
+
+constexpr size_t kMaxFields = 5;
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Version from the tag ("PIT", "PIT2", "PIT3"...), 0 if it is not one of ours
+int tagVersion(std::string_view tag, std::string_view base)
+{
+    if (tag.substr(0, base.size()) != base) {
+        return 0;
+    }
+    tag.remove_prefix(base.size());
+    if (tag.empty()) return 1;
+    if (tag == "2") return 2;
+    if (tag == "3") return 3;
+    return 0;
+}
+
+bool parseHex(std::string_view hex, std::vector<uint8_t>& out)
+{
+    if (hex.empty() || hex.size() % 2 != 0 || hex.size() / 2 > ScanPayload::kMaxSignatureSize) {
+        return false;
+    }
+    out.resize(hex.size() / 2);
+    for (size_t i = 0; i < out.size(); ++i) {
+        int hi = hexValue(hex[2 * i]);
+        int lo = hexValue(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+bool parseTimestamp(std::string_view text, int64_t& out)
+{
+    const char* end = text.data() + text.size();
+    auto parsed = std::from_chars(text.data(), end, out);
+    // Unix seconds; a negative value is never a real signing time
+    return !text.empty() && parsed.ec == std::errc() && parsed.ptr == end && out >= 0;
+}
+
+} // namespace
+
+std::optional<ScanPayload> ScanPayload::parse(std::string_view text, Kind kind)
+{
+    const size_t fieldCount = kind == Kind::Pit ? 4 : 5;
+    std::string_view fields[kMaxFields];
+    for (size_t i = 0; i < fieldCount; ++i) {
+        size_t colon = text.find(':');
+        if ((colon == std::string_view::npos) != (i == fieldCount - 1)) {
+            return std::nullopt;
+        }
+        fields[i] = text.substr(0, colon);
+        text.remove_prefix(colon == std::string_view::npos ? text.size() : colon + 1);
+    }
+
+    ScanPayload payload;
+    payload.kind = kind;
+    payload.version = tagVersion(fields[0], kind == Kind::Pit ? "PIT" : "TICKET");
+    if (payload.version == 0) {
+        return std::nullopt;
+    }
+
+    std::string_view keyHash = kind == Kind::Pit ? fields[1] : fields[3];
+    auto fingerprint = KeyFingerprint::fromHex(keyHash);
+    if (!fingerprint || !parseTimestamp(fields[2], payload.timestamp) ||
+        !parseHex(fields[fieldCount - 1], payload.signature)) {
+        return std::nullopt;
+    }
+    payload.fingerprint = *fingerprint;
+
+    if (kind == Kind::Ticket) {
+        if (fields[1].empty() || fields[1].size() > ScanMessage::kMaxBookingRefSize) {
+            return std::nullopt;
+        }
+        payload.bookingRef.assign(fields[1]);
+    }
+    return payload;
+}
@@ -0,0 +1,140 @@
+#include "ScanQueue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+template <typename T>
+void raiseTo(std::atomic<T>& maximum, T value)
+{
+    T current = maximum.load(std::memory_order_relaxed);
+    while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+ScanQueue::ScanQueue(size_t capacity, Policy policy, DropHandler onDrop)
+    : m_queue(capacity)
+    , m_policy(policy)
+    , m_onDrop(std::move(onDrop))
+{
+}
+
+int64_t ScanQueue::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ScanQueue::PushResult ScanQueue::push(Scan&& scan)
+{
+    if (isClosed()) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return PushResult::Rejected;
+    }
+
+    scan.stamps.enqueued = now();
+    const int64_t captured = scan.stamps.captured;
+    const int64_t enqueued = scan.stamps.enqueued;
+    bool droppedOldest = false;
+    while (!m_queue.tryPush(std::move(scan))) {
+        if (m_policy == Policy::Backpressure) {
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            return PushResult::Rejected;
+        }
+        // A consumer may empty the slot first; either way there is room on the next try
+        Scan oldest;
+        if (m_queue.tryPop(oldest)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            droppedOldest = true;
+            if (m_onDrop) {
+                m_onDrop(std::move(oldest));
+            }
+        }
+    }
+
+    m_pushed.fetch_add(1, std::memory_order_relaxed);
+    if (captured != 0) {
+        const uint64_t intake = static_cast<uint64_t>(std::max<int64_t>(0, enqueued - captured));
+        m_stamped.fetch_add(1, std::memory_order_relaxed);
+        m_intakeNanos.fetch_add(intake, std::memory_order_relaxed);
+        raiseTo(m_maxIntakeNanos, intake);
+    }
+    raiseTo(m_highWater, m_queue.size());
+    wakeConsumer();
+    return droppedOldest ? PushResult::AcceptedDroppedOldest : PushResult::Accepted;
+}
+
+void ScanQueue::wakeConsumer()
+{
+    // Pairs with the fence in pop(): either the sleeper sees the new scan, or we see the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.notify_one();
+    }
+}
+
+bool ScanQueue::pop(Scan& scan, std::chrono::milliseconds timeout)
+{
+    if (tryPop(scan)) {
+        return true;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_sleepers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool found = false;
+    while (!(found = tryPop(scan)) && !isClosed()) {
+        if (m_ready.wait_until(lock, deadline) == std::cv_status::timeout) {
+            found = tryPop(scan);
+            break;
+        }
+    }
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    return found;
+}
+
+bool ScanQueue::tryPop(Scan& scan)
+{
+    if (!m_queue.tryPop(scan)) {
+        return false;
+    }
+    scan.stamps.dequeued = now();
+    const uint64_t wait = static_cast<uint64_t>(std::max<int64_t>(0, scan.stamps.dequeued - scan.stamps.enqueued));
+    m_popped.fetch_add(1, std::memory_order_relaxed);
+    m_waitNanos.fetch_add(wait, std::memory_order_relaxed);
+    raiseTo(m_maxWaitNanos, wait);
+    return true;
+}
+
+void ScanQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed.store(true, std::memory_order_release);
+    }
+    m_ready.notify_all();
+}
+
+ScanQueue::Stats ScanQueue::stats() const
+{
+    Stats stats;
+    stats.capacity = m_queue.capacity();
+    stats.depth = m_queue.size();
+    stats.highWater = m_highWater.load(std::memory_order_relaxed);
+    stats.pushed = m_pushed.load(std::memory_order_relaxed);
+    stats.popped = m_popped.load(std::memory_order_relaxed);
+    stats.rejected = m_rejected.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.stamped = m_stamped.load(std::memory_order_relaxed);
+    stats.intakeNanos = m_intakeNanos.load(std::memory_order_relaxed);
+    stats.maxIntakeNanos = m_maxIntakeNanos.load(std::memory_order_relaxed);
+    stats.waitNanos = m_waitNanos.load(std::memory_order_relaxed);
+    stats.maxWaitNanos = m_maxWaitNanos.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,69 @@
+#include "SecureBuffer.h"
+
+#include <new>
+#include <utility>
+
+#include <openssl/crypto.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+SecureBuffer::SecureBuffer(size_t size)
+    : m_size(size)
+{
+    if (size == 0) {
+        return;
+    }
+    // Anonymous mappings are page-aligned and zero-filled
+    void* pages = mmap(nullptr, mappedSize(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED) {
+        m_size = 0;
+        throw std::bad_alloc();
+    }
+    m_data = static_cast<uint8_t*>(pages);
+    m_locked = mlock(m_data, mappedSize()) == 0;
+}
+
+SecureBuffer::~SecureBuffer()
+{
+    release();
+}
+
+SecureBuffer::SecureBuffer(SecureBuffer&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_locked(std::exchange(other.m_locked, false))
+{
+}
+
+SecureBuffer& SecureBuffer::operator=(SecureBuffer&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_locked = std::exchange(other.m_locked, false);
+    }
+    return *this;
+}
+
+size_t SecureBuffer::mappedSize() const
+{
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return (m_size + pageSize - 1) / pageSize * pageSize;
+}
+
+void SecureBuffer::release() noexcept
+{
+    if (!m_data) {
+        return;
+    }
+    OPENSSL_cleanse(m_data, m_size);
+    // The pages belong to this buffer alone, so unlocking them is safe
+    if (m_locked) {
+        munlock(m_data, mappedSize());
+    }
+    munmap(m_data, mappedSize());
+    m_data = nullptr;
+    m_size = 0;
+    m_locked = false;
+}
@@ -0,0 +1,56 @@
+#include "SigningKey.h"
+
+#include "KeyDerivation.h"
+#include "PgpKeyManager.h"
+
+#include <stdexcept>
+
+#include <openssl/crypto.h>
+
+SigningKey SigningKey::fromSeed(SecureBuffer seed, const std::string& userId)
+{
+    if (seed.size() != 32) {
+        throw std::runtime_error("Ed25519 seed must be 32 bytes");
+    }
+
+    SigningKey key;
+    key.m_raw = Ed25519Signer::fromSeed(seed.data());
+    key.m_fingerprint = KeyFingerprint::fromEd25519(key.m_raw->publicKey());
+
+    // The secret key packet only lives long enough for rnp to import it
+    std::string secretKey = KeyDerivation::buildSecretKey(seed.data(), userId);
+    try {
+        key.m_pgp = PgpKeyManager::fromSecretKey(secretKey);
+    } catch (...) {
+        OPENSSL_cleanse(&secretKey[0], secretKey.size());
+        throw;
+    }
+    OPENSSL_cleanse(&secretKey[0], secretKey.size());
+
+    key.m_seed = std::move(seed);
+    return key;
+}
+
+SigningKey::~SigningKey() = default;
+SigningKey::SigningKey(SigningKey&&) noexcept = default;
+SigningKey& SigningKey::operator=(SigningKey&&) noexcept = default;
+
+const std::string& SigningKey::userId() const
+{
+    return m_pgp->userId();
+}
+
+const std::string& SigningKey::publicKeyArmored() const
+{
+    return m_pgp->exportPublicKeyArmored();
+}
+
+void SigningKey::signOpenPgp(const uint8_t* data, size_t size, std::vector<uint8_t>& signatureOut) const
+{
+    m_pgp->signData(data, size, signatureOut);
+}
+
+Ed25519Signer::Signature SigningKey::signRaw(const uint8_t* data, size_t size) const
+{
+    return m_raw->sign(data, size);
+}
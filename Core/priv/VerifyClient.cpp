@@ -0,0 +1,105 @@
+#include "VerifyClient.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::runtime_error connectionError(const char* what)
+{
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return std::runtime_error("Daemon did not answer in time");
+    }
+    return std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+VerifyClient::VerifyClient(const std::string& socketPath, std::chrono::milliseconds timeout)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + socketPath);
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    m_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fd < 0 || ::connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        const std::string reason = std::strerror(errno);
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+        throw std::runtime_error("Cannot connect to " + socketPath + ": " + reason);
+    }
+
+    if (timeout > std::chrono::milliseconds::zero()) {
+        timeval limit{};
+        limit.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        limit.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+        ::setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+        ::setsockopt(m_fd, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit));
+    }
+}
+
+VerifyClient::~VerifyClient()
+{
+    ::close(m_fd);
+}
+
+VerifyProtocol::VerifyResponse VerifyClient::verify(const std::string& pit, const std::string& ticket,
+                                                    uint32_t gateId)
+{
+    VerifyProtocol::VerifyRequest request;
+    request.id = ++m_nextId;
+    request.gateId = gateId;
+    request.pit = pit;
+    request.ticket = ticket;
+    m_out.clear();
+    VerifyProtocol::appendVerifyRequest(request, m_out);
+
+    for (size_t sent = 0; sent < m_out.size();) {
+        ssize_t n = ::send(m_fd, m_out.data() + sent, m_out.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw connectionError("Daemon connection lost");
+        }
+        sent += static_cast<size_t>(n);
+    }
+
+    m_in.clear();
+    while (true) {
+        const auto* data = reinterpret_cast<const uint8_t*>(m_in.data());
+        if (size_t size = VerifyProtocol::frameSize(data, m_in.size())) {
+            const VerifyProtocol::Frame frame = VerifyProtocol::parseFrame(data, size);
+            if (frame.type == VerifyProtocol::Type::Error &&
+                VerifyProtocol::parseError(frame) == VerifyProtocol::ErrorReason::Overloaded) {
+                throw std::runtime_error("Daemon is overloaded");
+            }
+            if (frame.type != VerifyProtocol::Type::VerifyResult) {
+                throw std::runtime_error("Daemon answered with an error frame");
+            }
+            return VerifyProtocol::parseVerifyResponse(frame);
+        }
+        char chunk[4096];
+        ssize_t n = ::read(m_fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n == 0) {
+            throw std::runtime_error("Daemon connection lost");
+        }
+        if (n < 0) {
+            throw connectionError("Daemon connection lost");
+        }
+        m_in.append(chunk, static_cast<size_t>(n));
+    }
+}
@@ -0,0 +1,265 @@
+#include "VerifyProtocol.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t kHeaderSize = 1 + 4;  // type + id
+
+// Builds one frame in out, patching the length prefix when done
+class FrameWriter
+{
+public:
+    FrameWriter(std::string& out, VerifyProtocol::Type type, uint32_t id)
+        : m_out(out), m_start(out.size())
+    {
+        u32(0);  // length, patched by finish()
+        u8(static_cast<uint8_t>(type));
+        u32(id);
+    }
+
+    void u8(uint8_t value) { m_out.push_back(static_cast<char>(value)); }
+
+    void u16(uint16_t value)
+    {
+        u8(static_cast<uint8_t>(value >> 8));
+        u8(static_cast<uint8_t>(value));
+    }
+
+    void u32(uint32_t value)
+    {
+        u16(static_cast<uint16_t>(value >> 16));
+        u16(static_cast<uint16_t>(value));
+    }
+
+    void u64(uint64_t value)
+    {
+        u32(static_cast<uint32_t>(value >> 32));
+        u32(static_cast<uint32_t>(value));
+    }
+
+    void bytes(std::string_view data) { m_out.append(data.data(), data.size()); }
+
+    void finish()
+    {
+        const size_t length = m_out.size() - m_start - VerifyProtocol::kLengthSize;
+        if (length > VerifyProtocol::kMaxFrameSize) {
+            m_out.resize(m_start);
+            throw std::runtime_error("Verify frame too large");
+        }
+        for (size_t i = 0; i < 4; ++i) {
+            m_out[m_start + i] = static_cast<char>((length >> (24 - 8 * i)) & 0xff);
+        }
+    }
+
+private:
+    std::string& m_out;
+    size_t       m_start;
+};
+
+class BodyReader
+{
+public:
+    explicit BodyReader(std::string_view body) : m_body(body) {}
+
+    uint8_t u8()
+    {
+        need(1);
+        uint8_t value = static_cast<uint8_t>(m_body[m_pos]);
+        m_pos += 1;
+        return value;
+    }
+
+    uint16_t u16()
+    {
+        uint16_t hi = u8();
+        return static_cast<uint16_t>((hi << 8) | u8());
+    }
+
+    uint32_t u32()
+    {
+        uint32_t hi = u16();
+        return (hi << 16) | u16();
+    }
+
+    uint64_t u64()
+    {
+        uint64_t hi = u32();
+        return (hi << 32) | u32();
+    }
+
+    std::string bytes(size_t size)
+    {
+        need(size);
+        std::string value(m_body.substr(m_pos, size));
+        m_pos += size;
+        return value;
+    }
+
+    void end() const
+    {
+        if (m_pos != m_body.size()) {
+            throw std::runtime_error("Trailing bytes in verify frame");
+        }
+    }
+
+private:
+    void need(size_t size) const
+    {
+        if (m_body.size() - m_pos < size) {
+            throw std::runtime_error("Truncated verify frame");
+        }
+    }
+
+    std::string_view m_body;
+    size_t           m_pos = 0;
+};
+
+void expectType(const VerifyProtocol::Frame& frame, VerifyProtocol::Type type)
+{
+    if (frame.type != type) {
+        throw std::runtime_error("Unexpected verify frame type");
+    }
+}
+
+} // namespace
+
+void VerifyProtocol::appendVerifyRequest(const VerifyRequest& request, std::string& out)
+{
+    if (request.pit.size() > kMaxPayloadSize || request.ticket.size() > kMaxPayloadSize) {
+        throw std::runtime_error("QR payload too large for a verify request");
+    }
+    FrameWriter writer(out, Type::Verify, request.id);
+    writer.u32(request.gateId);
+    writer.u16(static_cast<uint16_t>(request.pit.size()));
+    writer.bytes(request.pit);
+    writer.u16(static_cast<uint16_t>(request.ticket.size()));
+    writer.bytes(request.ticket);
+    writer.finish();
+}
+
+void VerifyProtocol::appendStatsRequest(uint32_t id, std::string& out)
+{
+    FrameWriter writer(out, Type::Stats, id);
+    writer.finish();
+}
+
+void VerifyProtocol::appendVerifyResponse(const VerifyResponse& response, std::string& out)
+{
+    FrameWriter writer(out, Type::VerifyResult, response.id);
+    writer.u8(response.verdict);
+    writer.u8(response.flags);
+    writer.u64(static_cast<uint64_t>(response.pitTimestamp));
+    writer.u64(static_cast<uint64_t>(response.ticketTimestamp));
+    // Booking references are at most ScanMessage::kMaxBookingRefSize characters
+    const size_t refSize = std::min<size_t>(response.bookingRef.size(), 255);
+    writer.u8(static_cast<uint8_t>(refSize));
+    writer.bytes(std::string_view(response.bookingRef).substr(0, refSize));
+    writer.finish();
+}
+
+void VerifyProtocol::appendStatsResponse(const StatsResponse& response, std::string& out)
+{
+    FrameWriter writer(out, Type::StatsResult, response.id);
+    const size_t count = std::min<size_t>(response.verdictCounts.size(), 255);
+    writer.u8(static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        writer.u64(response.verdictCounts[i]);
+    }
+    writer.u64(response.replayEntries);
+    writer.u64(response.keyCacheHits);
+    writer.u64(response.keyCacheMisses);
+    writer.finish();
+}
+
+void VerifyProtocol::appendError(uint32_t id, ErrorReason reason, std::string& out)
+{
+    FrameWriter writer(out, Type::Error, id);
+    writer.u8(static_cast<uint8_t>(reason));
+    writer.finish();
+}
+
+size_t VerifyProtocol::frameSize(const uint8_t* data, size_t size)
+{
+    if (size < kLengthSize) {
+        return 0;
+    }
+    const size_t length = (size_t(data[0]) << 24) | (size_t(data[1]) << 16) | (size_t(data[2]) << 8) | data[3];
+    if (length < kHeaderSize || length > kMaxFrameSize) {
+        throw std::runtime_error("Invalid verify frame length: " + std::to_string(length));
+    }
+    return size >= kLengthSize + length ? kLengthSize + length : 0;
+}
+
+VerifyProtocol::Frame VerifyProtocol::parseFrame(const uint8_t* data, size_t size)
+{
+    if (size < kLengthSize + kHeaderSize) {
+        throw std::runtime_error("Truncated verify frame");
+    }
+    std::string_view all(reinterpret_cast<const char*>(data), size);
+    BodyReader header(all.substr(kLengthSize, kHeaderSize));
+
+    Frame frame;
+    frame.type = static_cast<Type>(header.u8());
+    frame.id = header.u32();
+    frame.body = all.substr(kLengthSize + kHeaderSize);
+    return frame;
+}
+
+VerifyProtocol::VerifyRequest VerifyProtocol::parseVerifyRequest(const Frame& frame)
+{
+    expectType(frame, Type::Verify);
+    BodyReader reader(frame.body);
+
+    VerifyRequest request;
+    request.id = frame.id;
+    request.gateId = reader.u32();
+    request.pit = reader.bytes(reader.u16());
+    request.ticket = reader.bytes(reader.u16());
+    reader.end();
+    return request;
+}
+
+VerifyProtocol::VerifyResponse VerifyProtocol::parseVerifyResponse(const Frame& frame)
+{
+    expectType(frame, Type::VerifyResult);
+    BodyReader reader(frame.body);
+
+    VerifyResponse response;
+    response.id = frame.id;
+    response.verdict = reader.u8();
+    response.flags = reader.u8();
+    response.pitTimestamp = static_cast<int64_t>(reader.u64());
+    response.ticketTimestamp = static_cast<int64_t>(reader.u64());
+    response.bookingRef = reader.bytes(reader.u8());
+    reader.end();
+    return response;
+}
+
+VerifyProtocol::StatsResponse VerifyProtocol::parseStatsResponse(const Frame& frame)
+{
+    expectType(frame, Type::StatsResult);
+    BodyReader reader(frame.body);
+
+    StatsResponse response;
+    response.id = frame.id;
+    response.verdictCounts.resize(reader.u8());
+    for (uint64_t& count : response.verdictCounts) {
+        count = reader.u64();
+    }
+    response.replayEntries = reader.u64();
+    response.keyCacheHits = reader.u64();
+    response.keyCacheMisses = reader.u64();
+    reader.end();
+    return response;
+}
+
+VerifyProtocol::ErrorReason VerifyProtocol::parseError(const Frame& frame)
+{
+    expectType(frame, Type::Error);
+    BodyReader reader(frame.body);
+    ErrorReason reason = static_cast<ErrorReason>(reader.u8());
+    reader.end();
+    return reason;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+/**
+ * BoundedQueue
+ *
+ * Fixed-capacity multi-producer, multi-consumer queue (a bounded ring in
+ * the style of Dmitry Vyukov's). Every slot carries a sequence number that
+ * says whose turn it is, so push and pop are one compare-and-swap on a
+ * shared index plus a store to the slot: no locks, and no allocation after
+ * construction.
+ *
+ * - tryPush() fails when the queue is full and tryPop() when it is empty.
+ *   Callers choose what happens then: wait, drop the new item, or pop the
+ *   oldest to make room.
+ * - Capacity is rounded up to a power of two.
+ * - size() is a snapshot and may be stale while other threads push or pop.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+    {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        m_mask = rounded - 1;
+        m_slots = std::make_unique<Slot[]>(rounded);
+        for (size_t i = 0; i < rounded; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedQueue()
+    {
+        // No other thread may use the queue any more, so every slot in [head, tail) is filled
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (size_t pos = m_head.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            m_slots[pos & m_mask].value()->~T();
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Move value in; false (value untouched) if the queue is full
+    bool tryPush(T&& value)
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t turn = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (turn == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (slot.storage) T(std::move(value));
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (turn < 0) {
+                return false;  // the slot still holds an item from one lap ago
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Move the oldest item into out; false if the queue is empty
+    bool tryPop(T& out)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t turn = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (turn == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* value = slot.value();
+                    out = std::move(*value);
+                    value->~T();
+                    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (turn < 0) {
+                return false;
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+    size_t size() const
+    {
+        // The two indexes are read at different moments, so clamp the difference
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return tail > head ? std::min(tail - head, capacity()) : 0;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t                  m_mask = 0;
+
+    // Producers and consumers contend on different cache lines
+    alignas(64) std::atomic<size_t> m_tail{0};
+    alignas(64) std::atomic<size_t> m_head{0};
+};
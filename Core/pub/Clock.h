@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Clock
+ *
+ * Source of "now" (seconds since the epoch) for time-based checks, so they
+ * can be driven by a fake clock in tests.
+ *
+ * - SystemWallClock : the system clock, read on every call. PITs are
+ *                     stamped with the wall time of another device, so the
+ *                     check has to follow NTP corrections and the time a
+ *                     handheld spends suspended rather than extrapolate
+ *                     from a reading taken at startup.
+ * - ManualClock     : set and advanced explicitly.
+ *
+ * Implementations are thread-safe.
+ */
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+    virtual int64_t nowSeconds() const = 0;
+};
+
+class SystemWallClock : public Clock
+{
+public:
+    int64_t nowSeconds() const override;
+};
+
+class ManualClock : public Clock
+{
+public:
+    explicit ManualClock(int64_t nowSeconds = 0) : m_now(nowSeconds) {}
+
+    int64_t nowSeconds() const override;
+    void set(int64_t nowSeconds);
+    void advance(int64_t seconds);
+
+private:
+    mutable std::mutex m_mutex;
+    int64_t m_now;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+typedef struct evp_pkey_st EVP_PKEY;
+
+/**
+ * Ed25519Signer
+ *
+ * Raw Ed25519 fast path for the scan payloads. It uses the same EdDSA keys
+ * that PgpKeyManager generates, but signs and verifies directly with
+ * Ed25519 (via OpenSSL) instead of building an OpenPGP signature packet:
+ *
+ * - Signatures are a fixed 64 bytes (OpenPGP packets are ~119 bytes)
+ * - Verification needs no rnp context and no key import, only the 32-byte
+ *   public point, which can be extracted once from the armored public key
+ *
+ * Keys are read from OpenPGP key packets: legacy EdDSA (algorithm 22 with
+ * the Ed25519 curve OID) and native Ed25519 (algorithm 27). Secret keys must
+ * be unprotected, which is how PgpKeyManager generates them.
+ */
+class Ed25519Signer
+{
+public:
+    using PublicKey = std::array<uint8_t, 32>;
+    using Signature = std::array<uint8_t, 64>;
+
+    /**
+     * Create a signer from an exported OpenPGP secret key (armored or binary).
+     *
+     * Throws std::runtime_error if the key is not an unprotected Ed25519 key.
+     */
+    static std::unique_ptr<Ed25519Signer> fromOpenPgpSecretKey(const std::string& secretKey);
+
+    // Create a signer from a raw 32-byte Ed25519 seed
+    static std::unique_ptr<Ed25519Signer> fromSeed(const uint8_t* seed);
+
+    ~Ed25519Signer();
+
+    Ed25519Signer(const Ed25519Signer&) = delete;
+    Ed25519Signer& operator=(const Ed25519Signer&) = delete;
+
+    // Sign size bytes at data. Throws std::runtime_error on failure.
+    Signature sign(const uint8_t* data, size_t size) const;
+
+    const PublicKey& publicKey() const { return m_publicKey; }
+
+    // Extract the Ed25519 public point from an OpenPGP public key (armored or binary)
+    static std::optional<PublicKey> publicKeyFromOpenPgp(const std::string& publicKey);
+
+    static bool verify(const PublicKey& publicKey, const uint8_t* data, size_t size,
+                       const Signature& signature);
+
+private:
+    Ed25519Signer() = default;
+
+    EVP_PKEY* m_key = nullptr;
+    PublicKey m_publicKey{};
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * IssuedTicketLog
+ *
+ * Append-only record of issued tickets, the reference side of the
+ * end-of-day audit (Tools/scanAudit). One CSV line per ticket:
+ *
+ *     booking_ref,key_hash,issued_at,travel_date
+ *
+ * key_hash is the 16-hex user key hash also carried in the QR codes,
+ * issued_at is seconds since the epoch and travel_date is YYYY-MM-DD.
+ * Lines starting with '#' are comments.
+ *
+ * append() is thread-safe and flushes every line.
+ */
+class IssuedTicketLog
+{
+public:
+    struct Record
+    {
+        std::string bookingRef;
+        std::string keyHash;
+        int64_t     issuedAt = 0;
+        std::string travelDate;
+    };
+
+    // Opens path for appending; throws std::runtime_error if it cannot
+    explicit IssuedTicketLog(const std::string& path);
+
+    void append(const Record& record);
+
+    const std::string& path() const { return m_path; }
+
+    // Parse one line (without the newline); false for comments and malformed lines
+    static bool parseLine(std::string_view line, std::string_view& bookingRef, std::string_view& keyHash,
+                          int64_t& issuedAt, std::string_view& travelDate);
+
+private:
+    std::string   m_path;
+    std::mutex    m_mutex;
+    std::ofstream m_out;
+};
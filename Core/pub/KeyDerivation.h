@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * KeyDerivation
+ *
+ * Derives a user's Ed25519 signing key from their credentials, so the same
+ * email and password always give the same key (and the same key hash in the
+ * QR codes) without running a key generation on every login.
+ *
+ * - deriveSeed()     : scrypt(password, salt = domain tag + normalized email)
+ *                      into a 32-byte Ed25519 seed. Cost is tunable via Params;
+ *                      changing it changes every derived key.
+ * - buildSecretKey() : wraps a seed into a complete, unprotected OpenPGP
+ *                      transferable secret key (key packet, user id and a
+ *                      self-signature), ready for PgpKeyManager::fromSecretKey.
+ *                      The creation time is fixed and Ed25519 signatures are
+ *                      deterministic, so the output is byte-for-byte stable.
+ *
+ * Throws std::runtime_error on failure.
+ */
+class KeyDerivation
+{
+public:
+    using Seed = std::array<uint8_t, 32>;
+
+    // scrypt parameters; the defaults take ~100 ms and 32 MiB on a laptop
+    struct Params
+    {
+        uint64_t costLog2    = 15;  // N = 2^costLog2
+        uint32_t blockSize   = 8;   // r
+        uint32_t parallelism = 1;   // p
+    };
+
+    // Accepted costLog2 range: below 2^10 the KDF adds little work for an
+    // attacker, above 2^20 one derivation needs 1 GiB at the default r = 8
+    static constexpr uint64_t kMinCostLog2 = 10;
+    static constexpr uint64_t kMaxCostLog2 = 20;
+    static constexpr uint32_t kMaxBlockSize = 16;
+    static constexpr uint32_t kMaxParallelism = 4;
+    static constexpr uint64_t kMaxMemory = uint64_t(1) << 30;  // 128 * r * N
+
+    // True if params are within the bounds above. Parameters read from disk
+    // must be checked before use, so a tampered file cannot make a single
+    // unlock allocate gigabytes or run for minutes.
+    static bool isValid(const Params& params);
+
+    // Creation time written into derived keys (2025-01-01T00:00:00Z)
+    static constexpr uint32_t kCreationTime = 1735689600;
+
+    static Seed deriveSeed(std::string_view email, std::string_view password);
+    static Seed deriveSeed(std::string_view email, std::string_view password, const Params& params);
+
+    // Raw scrypt into out (also used for keystore encryption keys); throws
+    // if params are not isValid()
+    static void stretch(std::string_view password, const uint8_t* salt, size_t saltSize,
+                        const Params& params, uint8_t* out, size_t outSize);
+
+    // Binary OpenPGP secret key for the 32-byte seed and userid
+    static std::string buildSecretKey(const uint8_t* seed, const std::string& userId,
+                                      uint32_t creationTime = kCreationTime);
+};
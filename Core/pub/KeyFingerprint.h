@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Ed25519Signer.h"
+
+/**
+ * KeyFingerprint
+ *
+ * Canonical identity of a user key, as carried in PIT and ticket QR codes
+ * (the 16-hex "key hash" field) and signed inside ScanMessage:
+ *
+ *     SHA-256("SBB-KFP" || 32-byte Ed25519 public point), first 8 bytes
+ *
+ * It is derived from the key packet, not from the armored text, so armor
+ * headers, line endings or re-exports of the same key never change it.
+ * Compute it once when a key is unlocked or imported and pass the value
+ * around; comparing and encoding it is a fixed-size copy.
+ */
+class KeyFingerprint
+{
+public:
+    static constexpr size_t kSize    = 8;
+    static constexpr size_t kHexSize = 2 * kSize;
+
+    using Bytes = std::array<uint8_t, kSize>;
+
+    // Null fingerprint (no key)
+    KeyFingerprint() = default;
+    explicit KeyFingerprint(const Bytes& bytes) : m_bytes(bytes), m_valid(true) {}
+
+    static KeyFingerprint fromEd25519(const Ed25519Signer::PublicKey& publicKey);
+
+    /**
+     * Fingerprint of an OpenPGP public key (armored or binary).
+     *
+     * Throws std::runtime_error if the key is not an Ed25519 key.
+     */
+    static KeyFingerprint fromPublicKey(const std::string& publicKey);
+
+    // Parse the 16-hex QR field (either case); nullopt if malformed
+    static std::optional<KeyFingerprint> fromHex(std::string_view hex);
+
+    bool isNull() const { return !m_valid; }
+    const Bytes& bytes() const { return m_bytes; }
+
+    // Lowercase 16-hex form used on the wire and as directory key
+    std::string toHex() const;
+
+    friend bool operator==(const KeyFingerprint& a, const KeyFingerprint& b)
+    {
+        return a.m_valid == b.m_valid && a.m_bytes == b.m_bytes;
+    }
+    friend bool operator!=(const KeyFingerprint& a, const KeyFingerprint& b) { return !(a == b); }
+
+private:
+    Bytes m_bytes{};
+    bool  m_valid = false;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "SigningKey.h"
+
+/**
+ * KeyPool
+ *
+ * Keeps freshly generated signing keys ready for accounts that need a new
+ * random key, so a burst of sign-ups takes keys off a queue instead of
+ * paying for seed generation, Ed25519 setup and the rnp import one after
+ * another.
+ *
+ * - Keys wait in a BoundedQueue of the configured depth. take() pops one
+ *   without locking.
+ * - Background threads top the pool up whenever a key is taken.
+ * - If the pool is empty, take() generates a key on the calling thread and
+ *   counts a miss.
+ *
+ * Every key carries the pool's user id. Keys derived from credentials
+ * (KeyDerivation) cannot come from a pool. Thread-safe.
+ */
+class KeyPool
+{
+public:
+    struct Stats
+    {
+        size_t   depth = 0;          // configured capacity
+        size_t   ready = 0;          // keys waiting now
+        uint64_t generated = 0;      // by the refill threads
+        uint64_t taken = 0;          // handed out from the pool
+        uint64_t misses = 0;         // take() found the pool empty and generated inline
+        uint64_t generateNanos = 0;  // total refill-thread time spent generating
+    };
+
+    // Starts refillThreads (at least one) that fill the pool to depth
+    KeyPool(std::string userId, size_t depth, size_t refillThreads = 1);
+    ~KeyPool();
+
+    KeyPool(const KeyPool&) = delete;
+    KeyPool& operator=(const KeyPool&) = delete;
+
+    // A key no one else has. Throws std::runtime_error if inline generation fails.
+    std::unique_ptr<SigningKey> take();
+
+    // Block until the pool is full (or has stopped), e.g. before an expected burst
+    void waitUntilFull();
+
+    Stats stats() const;
+
+    // New key from a random seed
+    static std::unique_ptr<SigningKey> generate(const std::string& userId);
+
+private:
+    void refillLoop();
+
+    const std::string m_userId;
+    const size_t      m_depth;
+
+    BoundedQueue<std::unique_ptr<SigningKey>> m_ready;
+
+    // Refill threads sleep here while the pool is full; the keys themselves never pass the lock
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_wantKeys;
+    std::condition_variable m_filled;
+    bool                    m_stopping = false;
+
+    std::atomic<size_t>   m_inFlight{0};  // being generated, counted against depth
+    std::atomic<uint64_t> m_generated{0};
+    std::atomic<uint64_t> m_taken{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_generateNanos{0};
+
+    std::vector<std::thread> m_threads;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "KeyDerivation.h"
+#include "SecureBuffer.h"
+
+/**
+ * KeyStore
+ *
+ * Encrypted on-disk store of users' Ed25519 seeds, one file per account:
+ *
+ *     <root>/<first 32 hex of SHA-256(lowercased account id)>.key
+ *
+ * Each file holds the seed encrypted with AES-256-GCM under a key stretched
+ * from the password with scrypt (random salt and nonce per file). The scrypt
+ * parameters are stored in the file, so they can be raised for new entries
+ * without breaking existing ones.
+ *
+ *     "SBBKEY01" | costLog2 u8 | r u32 | p u32 | salt[16] | nonce[12]
+ *     | ciphertext[32] | tag[16]          (integers big-endian)
+ *
+ * Everything before the ciphertext is authenticated as associated data.
+ */
+class KeyStore
+{
+public:
+    explicit KeyStore(std::string rootPath);
+
+    bool contains(std::string_view accountId) const;
+
+    /**
+     * Encrypt and store a 32-byte seed (replaces an existing entry).
+     *
+     * Throws std::runtime_error on failure.
+     */
+    void store(std::string_view accountId, std::string_view password,
+               const SecureBuffer& seed, const KeyDerivation::Params& params);
+
+    /**
+     * Decrypt the seed for an account; std::nullopt if there is no entry.
+     *
+     * Throws std::runtime_error if the password is wrong or the file is corrupt.
+     */
+    std::optional<SecureBuffer> unlock(std::string_view accountId, std::string_view password) const;
+
+    const std::string& rootPath() const { return m_root; }
+
+private:
+    std::string pathFor(std::string_view accountId) const;
+
+    std::string m_root;
+};
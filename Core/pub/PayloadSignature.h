@@ -0,0 +1,37 @@
+#pragma once
+
+#include "PublicKeyDirectory.h"
+#include "ScanPayload.h"
+
+/**
+ * PayloadSignature
+ *
+ * Signature checks for PIT and ticket payloads of every version, shared by
+ * TicketOwnership (the inspector) and PayloadVerifier (verifyDaemon) so the
+ * two accept exactly the same codes:
+ *
+ *     version 1 : OpenPGP detached signature over the armored user key and
+ *                 decimal text (PIT: key + timestamp,
+ *                 ticket: key + booking ref + timestamp)
+ *     version 2 : raw Ed25519 signature over the canonical ScanMessage
+ *     version 3 : OpenPGP detached signature over the canonical ScanMessage
+ *
+ * Keys are passed already parsed, so the Ed25519 point and fingerprint are
+ * never recomputed per scan, and OpenPGP checks reuse the entry's imported
+ * PgpPublicKey. Both checks return false on any failure,
+ * including an unknown version or a version 2 payload whose signer is not
+ * an Ed25519 key; they never throw.
+ */
+class PayloadSignature
+{
+public:
+    // PIT signed by the user's key; the message uses the fingerprint in the payload
+    static bool verifyPit(const ScanPayload& pit, const PublicKeyDirectory::Entry& userKey);
+
+    // Ticket signed by the company key (version 1 also signs the user's armored key)
+    static bool verifyTicket(const ScanPayload& ticket, const PublicKeyDirectory::Entry& userKey,
+                             const PublicKeyDirectory::Entry& companyKey);
+
+private:
+    PayloadSignature() = delete;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Clock.h"
+#include "PitValidityPolicy.h"
+#include "PublicKeyDirectory.h"
+#include "ReplayCache.h"
+
+class RevocationList;
+
+/**
+ * PayloadVerifier
+ *
+ * Qt-free counterpart of TicketOwnership::verifyOwnership for services
+ * that verify on behalf of several inspectors (Tools/verifyDaemon). For a
+ * PIT and a ticket payload it checks, in order:
+ *
+ *     format, PIT freshness, revocation, PIT/ticket fingerprints,
+ *     the user key from the directory, PIT signature, ticket signature,
+ *     and finally replay of the PIT at another gate
+ *
+ * and stops at the first failure. All payload versions are accepted; the
+ * signatures are checked by PayloadSignature, as in the inspector. The
+ * ticket signature is only checked when a company key was given.
+ *
+ * verify() is thread-safe; the revocation list may be swapped while
+ * verifications run.
+ */
+class PayloadVerifier
+{
+public:
+    enum class Verdict : uint8_t {
+        Valid = 0,
+        Malformed,
+        Expired,
+        FromFuture,
+        Revoked,
+        KeyMismatch,
+        UnknownKey,
+        BadPitSignature,
+        BadTicketSignature,
+        Replayed,
+    };
+    static constexpr size_t kVerdictCount = static_cast<size_t>(Verdict::Replayed) + 1;
+
+    struct Result
+    {
+        Verdict     verdict = Verdict::Malformed;
+        bool        inGrace = false;                 // PIT accepted by the grace window
+        bool        ticketSignatureChecked = false;
+        int64_t     pitTimestamp = 0;
+        int64_t     ticketTimestamp = 0;
+        std::string bookingRef;
+    };
+
+    /**
+     * keys must outlive the verifier. companyPublicKey may be empty.
+     *
+     * Throws std::runtime_error if companyPublicKey is given but is not an
+     * Ed25519 key.
+     */
+    PayloadVerifier(PublicKeyDirectory& keys, std::string companyPublicKey,
+                    PitValidityPolicy policy, std::shared_ptr<const Clock> clock);
+
+    Result verify(std::string_view pit, std::string_view ticket, uint32_t gateId);
+
+    void setRevocationList(std::shared_ptr<const RevocationList> revocationList);
+
+    const PitValidityPolicy& policy() const { return m_policy; }
+    PitValidityStats& pitStats() { return m_pitStats; }
+    const ReplayCache& replayCache() const { return m_replays; }
+
+    // Verifications so far, by verdict
+    std::array<uint64_t, kVerdictCount> verdictCounts() const;
+
+    static const char* verdictName(Verdict verdict);
+
+private:
+    Result finish(Result& result, Verdict verdict);
+
+    PublicKeyDirectory&                      m_keys;
+    PublicKeyDirectory::Entry                m_companyKey;  // armored empty if none
+    PitValidityPolicy                        m_policy;
+    std::shared_ptr<const Clock>             m_clock;
+    std::shared_ptr<const RevocationList>    m_revocationList;  // atomic access only
+    ReplayCache                              m_replays;
+    PitValidityStats                         m_pitStats;
+    std::array<std::atomic<uint64_t>, kVerdictCount> m_counts{};
+};
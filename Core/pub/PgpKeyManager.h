@@ -1,17 +1,25 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <rnp/rnp.h>
 
 /**
  * PgpKeyManager
  *
  * - Owns the rnp_ffi_t context
- * - Generates a simple Ed25519 signing key for a given userid
+ * - Generates a simple Ed25519 signing key for a given userid, or imports
+ *   an existing armored secret key (fromSecretKey)
+ * - Resolves the key handle once and keeps it for its lifetime, so signing
+ *   never searches the keyring again
  * - Exposes:
  *     - ffi()     : rnp_ffi_t context for signing/verifying
  *     - userId()  : userid used for the key (e.g. "demo@example.com")
  * - Optionally can export armored public/secret keys for debugging / inspector.
+ *   The armored public key is exported once (thread-safe) and cached.
  */
 class PgpKeyManager
 {
@@ -25,26 +33,64 @@ public:
      */
     explicit PgpKeyManager(const std::string& userId = "demo@example.com");
 
+    /**
+     * Construct from an existing (unprotected) secret key, armored or binary.
+     *
+     * Throws std::runtime_error on any failure.
+     */
+    static std::unique_ptr<PgpKeyManager> fromSecretKey(const std::string& armoredSecretKey);
+
     // Clean up rnp state
     ~PgpKeyManager();
 
+    // Owns rnp handles - not copyable
+    PgpKeyManager(const PgpKeyManager&) = delete;
+    PgpKeyManager& operator=(const PgpKeyManager&) = delete;
+
     // rnp context (used by RailcardQrGenerator)
     rnp_ffi_t ffi() const { return m_ffi; }
 
+    // Resolved key handle, valid for the lifetime of this object
+    rnp_key_handle_t keyHandle() const { return m_key; }
+
     // The userid we used for the key (also used as signer id)
     const std::string& userId() const { return m_userId; }
 
     // Optional: export armored keys if you want to show / debug them
-    std::string exportPublicKeyArmored() const;
+    const std::string& exportPublicKeyArmored() const;
     std::string exportSecretKeyArmored() const;
 
     // Sign data with the private key and return the signature
     std::string signData(const std::string& data) const;
 
+    /**
+     * Sign size bytes at data, writing the binary detached signature into
+     * signatureOut. The buffer is cleared but keeps its capacity, so callers
+     * that sign repeatedly can reuse it without reallocating.
+     *
+     * Throws std::runtime_error on failure.
+     */
+    void signData(const uint8_t* data, size_t size, std::vector<uint8_t>& signatureOut) const;
+
+    // Verify a binary detached signature over data with an armored public key.
+    // Imports the key on every call; keep a PgpPublicKey for repeated checks.
+    static bool verifyDetached(const std::string& publicKeyArmored,
+                               const std::string& data,
+                               const std::string& signature);
+
 private:
-    rnp_ffi_t   m_ffi = nullptr;
-    std::string m_userId;
+    struct NoKey {};
+    explicit PgpKeyManager(NoKey);           // ffi only; key is imported by fromSecretKey
+
+    rnp_ffi_t        m_ffi = nullptr;
+    rnp_key_handle_t m_key = nullptr;
+    std::string      m_userId;
+
+    mutable std::string    m_publicKeyArmored;  // filled on first export, under m_publicKeyExported
+    mutable std::once_flag m_publicKeyExported;
 
     void generateKey();                      // Generate key into m_ffi
+    void importSecretKey(const std::string& armoredSecretKey);
     rnp_key_handle_t locateUserKey() const;  // Find key by userid
+    std::string exportKey(uint32_t flags) const;
 };
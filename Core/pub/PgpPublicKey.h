@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <rnp/rnp.h>
+
+/**
+ * PgpPublicKey
+ *
+ * An armored OpenPGP public key, imported into rnp once and kept for
+ * repeated detached-signature checks.
+ *
+ * - Each verify() borrows an FFI context that already holds the imported
+ *   key, and returns it afterwards, so the key is never re-imported
+ * - Contexts are created on demand, one per concurrent verifier: a user
+ *   key seen at one gate at a time keeps a single context, a company key
+ *   checked by every worker ends up with one per worker
+ * - A key rnp cannot import is remembered as unusable; verify() then
+ *   returns false without trying again
+ *
+ * Thread-safe.
+ */
+class PgpPublicKey
+{
+public:
+    explicit PgpPublicKey(std::string armored);
+    ~PgpPublicKey();
+
+    // Owns rnp contexts - not copyable
+    PgpPublicKey(const PgpPublicKey&) = delete;
+    PgpPublicKey& operator=(const PgpPublicKey&) = delete;
+
+    const std::string& armored() const { return m_armored; }
+
+    // Verify a binary detached signature over data with this key
+    bool verify(const uint8_t* data, size_t size, const uint8_t* signature, size_t signatureSize) const;
+    bool verify(const std::string& data, const std::string& signature) const;
+
+private:
+    rnp_ffi_t acquire() const;               // idle context, or a new one; nullptr if the key is unusable
+    void release(rnp_ffi_t ffi) const;
+
+    std::string m_armored;
+
+    mutable std::mutex             m_mutex;
+    mutable std::vector<rnp_ffi_t> m_idle;   // contexts with the key imported, not in use
+    mutable std::atomic<bool>      m_unusable{false};
+};
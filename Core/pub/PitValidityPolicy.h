@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * PitValidityPolicy
+ *
+ * Decides whether a PIT timestamp is fresh enough, given the inspector's
+ * current time. A PIT of age = now - timestamp is
+ *
+ *     FromFuture    age < -futureSkewSeconds
+ *     Valid         -futureSkewSeconds <= age <= maxAgeSeconds
+ *     ValidInGrace  maxAgeSeconds < age <= maxAgeSeconds + graceSeconds
+ *     Expired       age > maxAgeSeconds + graceSeconds
+ *
+ * Grace acceptances are reported separately so deployments can see how
+ * often the nominal window is too tight before widening it. The defaults
+ * (20 s, no skew, no grace) are the original fixed rule.
+ *
+ * Config file: one "key = value" per line, '#' starts a comment:
+ *
+ *     max_age     = 20
+ *     future_skew = 5
+ *     grace       = 10
+ *
+ * parse() / loadFile() throw std::runtime_error on unknown keys, malformed
+ * or negative values, values over kMaxSeconds, or an unreadable file.
+ *
+ * check() compares without subtracting, so any timestamp a payload carries
+ * is safe to pass in.
+ */
+class PitValidityPolicy
+{
+public:
+    // Malformed is never returned by check(); it is for callers that reject
+    // a PIT before its timestamp is known, so all outcomes share one type
+    enum class Verdict { Valid, ValidInGrace, Expired, FromFuture, Malformed };
+
+    // Upper bound for each configured value
+    static constexpr int64_t kMaxSeconds = 24 * 60 * 60;
+
+    int64_t maxAgeSeconds     = 20;
+    int64_t futureSkewSeconds = 0;
+    int64_t graceSeconds      = 0;
+
+    static PitValidityPolicy parse(const std::string& text);
+    static PitValidityPolicy loadFile(const std::string& path);
+
+    Verdict check(int64_t timestamp, int64_t now) const;
+
+    static bool accepts(Verdict verdict)
+    {
+        return verdict == Verdict::Valid || verdict == Verdict::ValidInGrace;
+    }
+};
+
+/**
+ * PitValidityStats
+ *
+ * Lock-free counters of PIT checks by outcome.
+ */
+class PitValidityStats
+{
+public:
+    struct Counts
+    {
+        uint64_t valid        = 0;
+        uint64_t validInGrace = 0;
+        uint64_t expired      = 0;
+        uint64_t fromFuture   = 0;
+        uint64_t malformed    = 0;
+
+        uint64_t rejected() const { return expired + fromFuture + malformed; }
+    };
+
+    void record(PitValidityPolicy::Verdict verdict);
+
+    Counts snapshot() const;
+    void reset();
+
+private:
+    std::atomic<uint64_t> m_valid{0};
+    std::atomic<uint64_t> m_validInGrace{0};
+    std::atomic<uint64_t> m_expired{0};
+    std::atomic<uint64_t> m_fromFuture{0};
+    std::atomic<uint64_t> m_malformed{0};
+};
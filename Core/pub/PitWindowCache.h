@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+/**
+ * PitWindowCache
+ *
+ * Pre-signed PIT payloads for upcoming time windows. Time is cut into fixed
+ * windows aligned to the epoch; the PIT for a window is signed over the
+ * window's start time, so it is an ordinary PIT that verifies with the usual
+ * age check while its window is current.
+ *
+ * fill() signs every missing window up to a horizon in one burst (typically
+ * on a background thread), and lookup() makes showing a PIT a table lookup.
+ * Windows that have passed are dropped on the next fill().
+ *
+ * All methods are thread-safe. The sign callback runs without the lock held.
+ */
+class PitWindowCache
+{
+public:
+    // Builds the complete payload for the window starting at windowStart
+    using SignFunction = std::function<std::string(int64_t windowStart)>;
+
+    explicit PitWindowCache(int64_t windowSeconds);
+
+    int64_t windowSeconds() const { return m_window; }
+
+    // Start of the window containing time
+    int64_t windowStart(int64_t time) const;
+
+    // Sign the windows in [windowStart(now), now + horizonSeconds) that are not
+    // cached yet, oldest first. Stops before the next signature once *cancelled
+    // is set; windows signed so far are kept.
+    void fill(int64_t now, int64_t horizonSeconds, const SignFunction& sign,
+              const std::atomic<bool>* cancelled = nullptr);
+
+    // Payload for the window containing now, if it was pre-signed
+    std::optional<std::string> lookup(int64_t now) const;
+
+    // End of the last pre-signed window (0 if the cache is empty)
+    int64_t coveredUntil() const;
+
+    size_t size() const;
+
+private:
+    int64_t m_window;
+
+    mutable std::mutex             m_mutex;
+    std::map<int64_t, std::string> m_payloads;  // window start -> payload
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Ed25519Signer.h"
+#include "KeyFingerprint.h"
+#include "PgpPublicKey.h"
+
+/**
+ * PublicKeyDirectory
+ *
+ * Local directory of registered user public keys, indexed by the short key
+ * hash carried in PIT and ticket QR codes (16 lowercase hex characters).
+ *
+ * - On disk: one armored key per file, sharded by the first two hex digits
+ *       <root>/a3/a3f5d8c2e1b4f7a9.asc
+ * - In memory: a bounded LRU cache of recently resolved keys, so repeat
+ *   lookups at a gate never touch the filesystem
+ *
+ * The directory does not compute key hashes itself; callers pass the same
+ * hash they put into the QR codes. A key is parsed once when it is cached,
+ * so verifiers get its fingerprint and Ed25519 point from resolve() instead
+ * of re-reading the armored text on every scan. OpenPGP signature checks go
+ * through the entry's PgpPublicKey, which imports the key into rnp on first
+ * use and keeps it while the entry stays cached.
+ *
+ * All methods are thread-safe.
+ */
+class PublicKeyDirectory
+{
+public:
+    struct Entry
+    {
+        std::string              armored;
+        KeyFingerprint           fingerprint;  // null if the key is not an Ed25519 key
+        Ed25519Signer::PublicKey point{};      // only meaningful with a fingerprint
+        std::shared_ptr<const PgpPublicKey> openPgp;  // set by makeEntry()
+    };
+
+    explicit PublicKeyDirectory(std::string rootPath, size_t cacheCapacity = 4096);
+
+    /**
+     * Store a key under its hash (overwrites an existing entry).
+     *
+     * Throws std::runtime_error if the key cannot be written.
+     */
+    void registerKey(std::string_view keyHash, const std::string& publicKeyArmored);
+
+    // Resolve a key by hash; std::nullopt if it was never registered
+    std::optional<std::string> find(std::string_view keyHash);
+
+    // Same, with the parsed key; nullptr if it was never registered
+    std::shared_ptr<const Entry> resolve(std::string_view keyHash);
+
+    // Parse an armored key the way the cache does, for keys that are not in a directory
+    static Entry makeEntry(std::string publicKeyArmored);
+
+    const std::string& rootPath() const { return m_root; }
+    size_t cacheHits() const;
+    size_t cacheMisses() const;
+
+    // True for 16 hex characters; anything else is rejected before touching disk
+    static bool isValidKeyHash(std::string_view keyHash);
+
+private:
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<const Entry>>>;  // hash -> key, most recent first
+
+    std::string pathFor(const std::string& keyHash) const;
+    void cacheLocked(const std::string& keyHash, std::shared_ptr<const Entry> entry);
+
+    std::string m_root;
+    size_t      m_capacity;
+
+    mutable std::mutex                                  m_mutex;
+    LruList                                             m_lru;
+    std::unordered_map<std::string, LruList::iterator>  m_index;
+    size_t                                              m_hits = 0;
+    size_t                                              m_misses = 0;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "KeyFingerprint.h"
+
+/**
+ * ReplayCache
+ *
+ * Remembers which gate accepted each PIT (key fingerprint + PIT timestamp)
+ * while the PIT could still pass the freshness check. The same PIT shown
+ * at a second gate inside that window is a replay: a photographed or shared
+ * code, not the passenger's live one. Rescans at the same gate are fine.
+ *
+ * Entries expire windowSeconds after they were recorded; memory is bounded
+ * by the scan rate over one window, and capacity caps it beyond that by
+ * dropping the oldest entries.
+ *
+ * All methods are thread-safe.
+ */
+class ReplayCache
+{
+public:
+    explicit ReplayCache(int64_t windowSeconds, size_t capacity = 1 << 20);
+
+    /**
+     * Record a use of the PIT at gateId and return true if a different gate
+     * recorded the same PIT within the window. The first gate keeps the
+     * entry, so a replay never takes it over.
+     */
+    bool checkAndRecord(const KeyFingerprint& fingerprint, int64_t pitTimestamp, uint32_t gateId, int64_t now);
+
+    size_t size() const;
+    uint64_t replays() const;
+
+private:
+    struct Key
+    {
+        KeyFingerprint::Bytes fingerprint;
+        int64_t               timestamp;
+
+        bool operator==(const Key& other) const
+        {
+            return timestamp == other.timestamp && fingerprint == other.fingerprint;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        uint32_t gateId;
+        int64_t  expiresAt;
+    };
+
+    void expireLocked(int64_t now);
+
+    int64_t m_window;
+    size_t  m_capacity;
+
+    mutable std::mutex                      m_mutex;
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+    std::deque<std::pair<int64_t, Key>>     m_order;  // (expiresAt, key), oldest first
+    uint64_t                                m_replays = 0;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * RevocationList
+ *
+ * Offline list of revoked booking references (refunded, cancelled or
+ * fraud-flagged tickets) for inspectors.
+ *
+ * - Booking references are packed losslessly into 64-bit keys
+ * - A blocked Bloom filter answers "definitely not revoked" with a single
+ *   cache-line probe, which is the answer for almost every scan
+ * - Filter hits are confirmed against exact sorted key sets
+ * - Delta files add/remove keys on top of the loaded version without
+ *   rebuilding the filter; deltas are merged into the base set lazily
+ *
+ * File format (all integers big-endian):
+ *     magic        "SBBRVK01"
+ *     kind         u8   (0 = full list, 1 = delta)
+ *     reserved     7 bytes
+ *     version      u64  (version this file produces)
+ *     baseVersion  u64  (delta only: version it applies on top of)
+ *     addCount     u64
+ *     removeCount  u64  (always 0 for full lists)
+ *     adds         addCount    x u64 keys
+ *     removes      removeCount x u64 keys
+ *
+ * Files are signed by the company with a detached OpenPGP signature stored
+ * next to them as "<file>.sig". Versions only move forward: a full list
+ * older than the loaded one is refused, so replaying an old signed file
+ * cannot un-revoke tickets.
+ *
+ * All methods are thread-safe; lookups only take a shared lock.
+ */
+class RevocationList
+{
+public:
+    enum class FileKind : uint8_t { Full = 0, Delta = 1 };
+
+    RevocationList() = default;
+
+    /**
+     * Load a signed full or delta file and verify "<path>.sig" with the
+     * company's armored public key.
+     *
+     * Throws std::runtime_error if the file is unreadable, malformed, not
+     * signed by the company, a full list older than version(), or a delta
+     * that does not apply to version().
+     */
+    void loadFile(const std::string& path, const std::string& companyPublicKey);
+
+    /**
+     * Apply an already-verified full or delta list.
+     *
+     * Throws std::runtime_error on malformed data, a full list older than
+     * version(), or a delta that is not based on version() or does not
+     * produce a newer one.
+     */
+    void load(const std::string& data);
+
+    // O(1) in the common (not revoked) case
+    bool isRevoked(std::string_view bookingRef) const;
+    bool isRevokedKey(uint64_t key) const;
+
+    uint64_t version() const;
+    size_t size() const;
+
+    // Heap bytes held by the filter and key sets
+    size_t memoryFootprint() const;
+
+    /**
+     * Pack a booking reference (up to 12 characters of [A-Z0-9], case
+     * insensitive) into a 64-bit key. Returns 0 for references that cannot
+     * be packed; 0 is never a valid key.
+     */
+    static uint64_t keyFor(std::string_view bookingRef);
+
+    // Build a file body (unsigned) - used by issuing tools and benchmarks
+    static std::string serialize(FileKind kind, uint64_t version, uint64_t baseVersion,
+                                 std::vector<uint64_t> adds, std::vector<uint64_t> removes);
+
+private:
+    struct Filter
+    {
+        std::vector<uint64_t> words;  // 512-bit blocks, 8 words each
+        size_t blocks = 0;
+        size_t capacity = 0;          // keys the filter was sized for
+        size_t inserted = 0;
+
+        void reset(size_t expectedKeys);
+        void insert(uint64_t key);
+        bool mayContain(uint64_t key) const;
+    };
+
+    void applyFull(uint64_t version, std::vector<uint64_t> adds);
+    void applyDelta(uint64_t version, std::vector<uint64_t> adds, std::vector<uint64_t> removes);
+    void compactLocked();
+    bool containsLocked(uint64_t key) const;
+
+    mutable std::shared_mutex m_mutex;
+    Filter                    m_filter;
+    std::vector<uint64_t>     m_base;      // sorted, from the last full load/compaction
+    std::vector<uint64_t>     m_added;     // sorted, pending delta additions
+    std::vector<uint64_t>     m_removed;   // sorted, pending delta removals
+    uint64_t                  m_version = 0;
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * ScanJournal
+ *
+ * Append-only binary log of inspector scans, kept for end-of-shift upload
+ * and audit.
+ *
+ * - append() only queues the entry, so the scan path never waits on disk
+ * - A background thread commits queued entries in groups: it writes the
+ *   whole batch into the memory-mapped file, then issues one msync
+ * - The file grows in fixed extents and is remapped when an extent fills.
+ *   Unused space is zero, and readers stop at the first record whose
+ *   checksum does not match, so a crash loses at most the uncommitted batch
+ * - The writer holds an exclusive flock() on the file for its lifetime, so a
+ *   second inspector started on the same journal fails instead of appending
+ *   over the first one's records. Readers do not lock.
+ *
+ * File format (integers big-endian):
+ *     header   32 bytes: magic "SBBJRN01" | recordSize u32 | reserved u32
+ *                        | createdAt u64 (ms since epoch) | reserved u64
+ *     records  recordSize bytes each:
+ *         scanTime        i64   ms since epoch
+ *         pitTimestamp    i64
+ *         ticketTimestamp i64
+ *         flags           u32   Flag bits
+ *         decodeMicros    u32
+ *         verifyMicros    u32
+ *         totalMicros     u32
+ *         keyHash         16 bytes (hex, zero padded)
+ *         bookingRefSize  u8
+ *         bookingRef      32 bytes (zero padded; longer refs are truncated)
+ *         reserved        3 bytes
+ *         checksum        u32   FNV-1a over the preceding bytes
+ *
+ * Throws std::runtime_error if the file cannot be opened, locked, mapped or
+ * is not a journal.
+ */
+class ScanJournal
+{
+public:
+    enum Flag : uint32_t {
+        Valid                = 1u << 0,
+        PitParsed            = 1u << 1,
+        TicketParsed         = 1u << 2,
+        KeysMatch            = 1u << 3,
+        PitSignatureValid    = 1u << 4,
+        TicketSignatureValid = 1u << 5,
+        TicketRevoked        = 1u << 6,
+        BookingRefTruncated  = 1u << 7
+    };
+
+    struct Entry
+    {
+        int64_t     scanTime        = 0;
+        int64_t     pitTimestamp    = 0;
+        int64_t     ticketTimestamp = 0;
+        uint32_t    flags           = 0;
+        uint32_t    decodeMicros    = 0;
+        uint32_t    verifyMicros    = 0;
+        uint32_t    totalMicros     = 0;
+        std::string keyHash;
+        std::string bookingRef;
+    };
+
+    struct Stats
+    {
+        uint64_t appended  = 0;
+        uint64_t committed = 0;
+        uint64_t dropped   = 0;   // queue was full
+        uint64_t batches   = 0;
+    };
+
+    static constexpr size_t kHeaderSize      = 32;
+    static constexpr size_t kRecordSize      = 96;
+    static constexpr size_t kMaxKeyHash      = 16;
+    static constexpr size_t kMaxBookingRef   = 32;
+    static constexpr size_t kMaxQueued       = 65536;
+
+    // Opens (or creates) the journal and starts the commit thread
+    explicit ScanJournal(const std::string& path);
+    ~ScanJournal();
+
+    ScanJournal(const ScanJournal&) = delete;
+    ScanJournal& operator=(const ScanJournal&) = delete;
+
+    // Queue an entry; never blocks on I/O. Returns false if the queue is full.
+    bool append(const Entry& entry);
+
+    // Block until everything appended so far is committed
+    void flush();
+
+    Stats stats() const;
+    const std::string& path() const { return m_path; }
+
+    // Read every intact record (stops at the first torn or empty record)
+    static std::vector<Entry> readAll(const std::string& path);
+
+    /**
+     * Random access to the records of a journal file, without copying it.
+     * read() is const and thread-safe, so disjoint index ranges can be
+     * decoded in parallel. Throws std::runtime_error like the constructor.
+     */
+    class Reader
+    {
+    public:
+        explicit Reader(const std::string& path);
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        // Record slots in the file, including unused space at the end
+        size_t slots() const { return m_slots; }
+
+        // False if the slot is empty or torn
+        bool read(size_t index, Entry& entry) const;
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t         m_size = 0;
+        size_t         m_slots = 0;
+    };
+
+private:
+    void commitLoop();
+    void commitBatch(const std::vector<Entry>& batch);
+    void ensureCapacity(size_t bytes);
+    void map(size_t size);
+
+    std::string m_path;
+    int         m_fd = -1;
+    uint8_t*    m_map = nullptr;
+    size_t      m_mapSize = 0;
+    size_t      m_end = 0;       // offset of the next record
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_committed;
+    std::vector<Entry>      m_queue;
+    uint64_t                m_appended = 0;
+    uint64_t                m_committedCount = 0;
+    uint64_t                m_dropped = 0;
+    uint64_t                m_batches = 0;
+    bool                    m_stop = false;
+    std::thread             m_thread;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "KeyFingerprint.h"
+
+/**
+ * ScanMessage
+ *
+ * Canonical binary message signed by the version 2 and 3 scan payloads
+ * (PIT2 / TICKET2 with raw Ed25519, PIT3 / TICKET3 with OpenPGP). Unlike
+ * the version 1 payloads, which sign the armored public key concatenated
+ * with decimal text, the message is small, fixed in layout and built on
+ * the stack:
+ *
+ *     domain tag (7 bytes)   "SBB-PIT" or "SBB-TKT"
+ *     version    (1 byte)
+ *     key hash   (1 byte length + 8-byte KeyFingerprint)
+ *     booking ref (1 byte length + bytes, tickets only)
+ *     timestamp  (8 bytes, big-endian signed seconds since epoch)
+ *
+ * The domain tag keeps a PIT signature from ever verifying as a ticket
+ * signature and vice versa.
+ *
+ * Factories throw std::runtime_error on a null fingerprint, an invalid key
+ * hash or an over-long booking reference.
+ */
+class ScanMessage
+{
+public:
+    static constexpr uint8_t kVersion = 2;
+    static constexpr size_t kMaxBookingRefSize = 64;
+    static constexpr size_t kMaxSize = 7 + 1 + 1 + 8 + 1 + kMaxBookingRefSize + 8;
+
+    static ScanMessage pit(const KeyFingerprint& fingerprint, int64_t timestamp);
+    static ScanMessage ticket(const KeyFingerprint& fingerprint, std::string_view bookingRef, int64_t timestamp);
+
+    // Same, from the 16-hex QR field
+    static ScanMessage pit(std::string_view keyHash, int64_t timestamp);
+    static ScanMessage ticket(std::string_view keyHash, std::string_view bookingRef, int64_t timestamp);
+
+    const uint8_t* data() const { return m_bytes.data(); }
+    size_t size() const { return m_size; }
+
+private:
+    ScanMessage() = default;
+
+    void append(const void* data, size_t size);
+    void appendFingerprint(const KeyFingerprint& fingerprint);
+    void appendTimestamp(int64_t timestamp);
+
+    std::array<uint8_t, kMaxSize> m_bytes{};
+    size_t m_size = 0;
+};
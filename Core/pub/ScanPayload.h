@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "KeyFingerprint.h"
+
+/**
+ * ScanPayload
+ *
+ * A PIT or ticket QR payload, parsed without Qt:
+ *
+ *     PIT<v>:keyHash:timestamp:signature
+ *     TICKET<v>:bookingRef:timestamp:keyHash:signature
+ *
+ * <v> is empty (version 1), "2" or "3"; see TicketOwnership::PayloadVersion.
+ * keyHash is the 16-hex KeyFingerprint and signature is hex. parse() checks
+ * the format only; freshness and signatures are the caller's business.
+ */
+class ScanPayload
+{
+public:
+    enum class Kind : uint8_t { Pit, Ticket };
+
+    static constexpr size_t kMaxSignatureSize = 1024;
+
+    Kind                 kind = Kind::Pit;
+    int                  version = 0;
+    KeyFingerprint       fingerprint;
+    std::string          bookingRef;  // tickets only
+    int64_t              timestamp = 0;
+    std::vector<uint8_t> signature;
+
+    // std::nullopt if text is not a well-formed payload of the given kind
+    static std::optional<ScanPayload> parse(std::string_view text, Kind kind);
+};
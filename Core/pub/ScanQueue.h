@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "BoundedQueue.h"
+
+/**
+ * ScanQueue
+ *
+ * Bounded hand-off of decoded scans from any number of producers (camera or
+ * decoder threads, daemon connections) to a pool of verifier threads. The
+ * queue itself is a lock-free BoundedQueue; a mutex is only taken to wake a
+ * consumer that found it empty.
+ *
+ * When the queue is full, the overflow policy decides:
+ * - Backpressure : push() refuses the new scan; the producer sheds it or
+ *                  tells its client to retry, so slow signature checks never
+ *                  pile up unbounded work
+ * - DropOldest   : the oldest waiting scan is dropped to make room, for live
+ *                  gates where only the passengers in front of the camera
+ *                  matter. The victim is handed to the drop handler on the
+ *                  pushing thread, so its producer can still answer for it
+ *
+ * Every scan carries steady-clock stamps for each stage it passed. The
+ * producer sets the captured and decoded stamps, push() and pop() set the
+ * enqueue and dequeue stamps. stats() accumulates the captured-to-enqueued
+ * and enqueued-to-dequeued times. Thread-safe.
+ */
+class ScanQueue
+{
+public:
+    enum class Policy { Backpressure, DropOldest };
+
+    enum class PushResult {
+        Accepted,
+        AcceptedDroppedOldest,  // DropOldest made room
+        Rejected,               // Backpressure, queue full
+    };
+
+    // Steady-clock nanoseconds (see now()); 0 = stage not reached
+    struct Stamps
+    {
+        int64_t captured = 0;   // frame taken or request received
+        int64_t decoded  = 0;   // QR payload extracted
+        int64_t enqueued = 0;
+        int64_t dequeued = 0;
+    };
+
+    struct Scan
+    {
+        std::string pit;
+        std::string ticket;
+        uint32_t    gateId = 0;
+        uint64_t    source = 0;  // producer's own id (camera, connection)
+        uint32_t    id = 0;      // producer's request id
+        Stamps      stamps;
+    };
+
+    struct Stats
+    {
+        size_t   capacity = 0;
+        size_t   depth = 0;          // waiting now
+        size_t   highWater = 0;      // deepest the queue has been
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        uint64_t rejected = 0;       // Backpressure
+        uint64_t dropped = 0;        // DropOldest victims
+        uint64_t stamped = 0;        // pushed scans that carried a captured stamp
+        uint64_t intakeNanos = 0;    // total captured-to-enqueue time of stamped scans
+        uint64_t maxIntakeNanos = 0;
+        uint64_t waitNanos = 0;      // total enqueue-to-dequeue time of popped scans
+        uint64_t maxWaitNanos = 0;
+    };
+
+    // Receives each scan DropOldest evicts
+    using DropHandler = std::function<void(Scan&&)>;
+
+    // Capacity is rounded up to a power of two
+    ScanQueue(size_t capacity, Policy policy, DropHandler onDrop = {});
+
+    ScanQueue(const ScanQueue&) = delete;
+    ScanQueue& operator=(const ScanQueue&) = delete;
+
+    // Never blocks. On Rejected the scan is left untouched.
+    PushResult push(Scan&& scan);
+
+    // Oldest scan, waiting up to timeout for one. False on timeout, or once
+    // the queue is closed and empty.
+    bool pop(Scan& scan, std::chrono::milliseconds timeout);
+
+    // Wake every waiting consumer; later pushes are rejected
+    void close();
+    bool isClosed() const { return m_closed.load(std::memory_order_acquire); }
+
+    Policy policy() const { return m_policy; }
+    Stats stats() const;
+
+    static int64_t now();
+
+private:
+    bool tryPop(Scan& scan);
+    void wakeConsumer();
+
+    BoundedQueue<Scan> m_queue;
+    const Policy       m_policy;
+    const DropHandler  m_onDrop;
+
+    std::atomic<bool> m_closed{false};
+
+    // Consumers that found the queue empty sleep here; producers only lock it if one does
+    std::mutex              m_mutex;
+    std::condition_variable m_ready;
+    std::atomic<size_t>     m_sleepers{0};
+
+    std::atomic<size_t>   m_highWater{0};
+    std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_popped{0};
+    std::atomic<uint64_t> m_rejected{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_stamped{0};
+    std::atomic<uint64_t> m_intakeNanos{0};
+    std::atomic<uint64_t> m_maxIntakeNanos{0};
+    std::atomic<uint64_t> m_waitNanos{0};
+    std::atomic<uint64_t> m_maxWaitNanos{0};
+};
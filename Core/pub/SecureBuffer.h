@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SecureBuffer
+ *
+ * Fixed-size byte buffer for secret key material:
+ * - Locked into RAM with mlock() so it is never written to swap
+ *   (best effort: isLocked() is false if RLIMIT_MEMLOCK is exhausted).
+ *   mlock works on whole pages and does not nest, so every buffer gets
+ *   pages of its own from mmap; releasing one buffer can never unlock
+ *   another's. Each buffer therefore uses at least one page of the
+ *   RLIMIT_MEMLOCK budget.
+ * - Zeroed before it is released
+ * - Move-only, so secrets are handed over rather than duplicated
+ */
+class SecureBuffer
+{
+public:
+    SecureBuffer() = default;
+    explicit SecureBuffer(size_t size);
+    ~SecureBuffer();
+
+    SecureBuffer(SecureBuffer&& other) noexcept;
+    SecureBuffer& operator=(SecureBuffer&& other) noexcept;
+
+    SecureBuffer(const SecureBuffer&) = delete;
+    SecureBuffer& operator=(const SecureBuffer&) = delete;
+
+    uint8_t* data() { return m_data; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool isLocked() const { return m_locked; }
+
+private:
+    void release() noexcept;
+    size_t mappedSize() const;
+
+    uint8_t* m_data = nullptr;
+    size_t   m_size = 0;
+    bool     m_locked = false;
+};
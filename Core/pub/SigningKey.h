@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Ed25519Signer.h"
+#include "KeyFingerprint.h"
+#include "SecureBuffer.h"
+
+class PgpKeyManager;
+
+/**
+ * SigningKey
+ *
+ * Unlocked user signing key for the rest of a session. It is built once from
+ * a raw Ed25519 seed (held in a locked SecureBuffer) and keeps both signing
+ * paths ready:
+ *
+ * - signOpenPgp() : OpenPGP detached signatures through a resolved rnp key
+ * - signRaw()     : raw Ed25519 signatures (PIT2 / TICKET2 payloads)
+ *
+ * The armored secret key is never exported again after unlock, so signing
+ * never re-imports key text. Move-only; share it with std::shared_ptr.
+ */
+class SigningKey
+{
+public:
+    /**
+     * Take ownership of a 32-byte seed and import it as the key for userId.
+     *
+     * Throws std::runtime_error on failure.
+     */
+    static SigningKey fromSeed(SecureBuffer seed, const std::string& userId);
+
+    ~SigningKey();
+
+    SigningKey(SigningKey&&) noexcept;
+    SigningKey& operator=(SigningKey&&) noexcept;
+
+    SigningKey(const SigningKey&) = delete;
+    SigningKey& operator=(const SigningKey&) = delete;
+
+    const std::string& userId() const;
+    const std::string& publicKeyArmored() const;
+
+    // Canonical key identity, computed once at unlock
+    const KeyFingerprint& fingerprint() const { return m_fingerprint; }
+
+    // OpenPGP detached signature into signatureOut (see PgpKeyManager::signData)
+    void signOpenPgp(const uint8_t* data, size_t size, std::vector<uint8_t>& signatureOut) const;
+
+    Ed25519Signer::Signature signRaw(const uint8_t* data, size_t size) const;
+
+    // False if the seed could not be locked into RAM (RLIMIT_MEMLOCK)
+    bool isMemoryLocked() const { return m_seed.isLocked(); }
+
+private:
+    SigningKey() = default;
+
+    SecureBuffer                   m_seed;
+    std::unique_ptr<PgpKeyManager> m_pgp;
+    std::unique_ptr<Ed25519Signer> m_raw;
+    KeyFingerprint                 m_fingerprint;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "VerifyProtocol.h"
+
+/**
+ * VerifyClient
+ *
+ * Synchronous client for Tools/verifyDaemon over its Unix domain socket:
+ * one request in flight per connection, answered before verify() returns.
+ * Inspectors use it to share the daemon's warm key cache, revocation list
+ * and replay cache; verifyLoad uses it to load the daemon.
+ *
+ * Not thread-safe; give each thread its own client.
+ */
+class VerifyClient
+{
+public:
+    /**
+     * Connect to the daemon. timeout bounds each send and each wait for the
+     * response (zero waits forever).
+     *
+     * Throws std::runtime_error if the socket cannot be connected.
+     */
+    explicit VerifyClient(const std::string& socketPath,
+                          std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+    ~VerifyClient();
+
+    VerifyClient(const VerifyClient&) = delete;
+    VerifyClient& operator=(const VerifyClient&) = delete;
+
+    /**
+     * Verify one PIT/ticket pair at gateId.
+     *
+     * Throws std::runtime_error if the connection fails, the daemon does not
+     * answer in time or answers with an error frame (Overloaded included).
+     * A late answer could be mistaken for the next one, so the client is not
+     * usable after a throw; connect a new one.
+     */
+    VerifyProtocol::VerifyResponse verify(const std::string& pit, const std::string& ticket, uint32_t gateId);
+
+private:
+    int         m_fd = -1;
+    uint32_t    m_nextId = 0;
+    std::string m_out;
+    std::string m_in;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * VerifyProtocol
+ *
+ * Binary protocol between inspector clients and Tools/verifyDaemon over a
+ * Unix stream socket. Every message is one frame (integers big-endian):
+ *
+ *     length   u32   bytes that follow, 5..kMaxFrameSize
+ *     type     u8
+ *     id       u32   chosen by the client, echoed in the response
+ *     body
+ *
+ * Bodies by type:
+ *
+ *     Verify        gate u32, pit length u16, pit, ticket length u16, ticket
+ *     Stats         (empty)
+ *     VerifyResult  verdict u8 (PayloadVerifier::Verdict), flags u8,
+ *                   pit timestamp i64, ticket timestamp i64,
+ *                   booking ref length u8, booking ref
+ *     StatsResult   verdict count u8, that many u64 counters (by verdict),
+ *                   replay cache entries u64, key cache hits u64,
+ *                   key cache misses u64
+ *     Error         reason u8 (ErrorReason)
+ *
+ * A client may pipeline requests; responses can arrive out of order and
+ * are matched by id. The gate id names the terminal for the replay check.
+ *
+ * The append* functions add one complete frame to out. The parse*
+ * functions throw std::runtime_error on malformed input.
+ */
+class VerifyProtocol
+{
+public:
+    static constexpr size_t kLengthSize     = 4;
+    static constexpr size_t kMaxFrameSize   = 16 * 1024;
+    static constexpr size_t kMaxPayloadSize = 4096;  // one QR payload
+
+    enum class Type : uint8_t {
+        Verify       = 0x01,
+        Stats        = 0x02,
+        VerifyResult = 0x81,
+        StatsResult  = 0x82,
+        Error        = 0xFF,
+    };
+
+    enum Flags : uint8_t {
+        InGrace                = 1 << 0,
+        TicketSignatureChecked = 1 << 1,
+    };
+
+    enum class ErrorReason : uint8_t {
+        MalformedRequest = 1,
+        UnknownType      = 2,
+        Overloaded       = 3,
+    };
+
+    struct Frame
+    {
+        Type             type = Type::Error;
+        uint32_t         id = 0;
+        std::string_view body;
+    };
+
+    struct VerifyRequest
+    {
+        uint32_t    id = 0;
+        uint32_t    gateId = 0;
+        std::string pit;
+        std::string ticket;
+    };
+
+    struct VerifyResponse
+    {
+        uint32_t    id = 0;
+        uint8_t     verdict = 0;
+        uint8_t     flags = 0;
+        int64_t     pitTimestamp = 0;
+        int64_t     ticketTimestamp = 0;
+        std::string bookingRef;
+    };
+
+    struct StatsResponse
+    {
+        uint32_t              id = 0;
+        std::vector<uint64_t> verdictCounts;
+        uint64_t              replayEntries = 0;
+        uint64_t              keyCacheHits = 0;
+        uint64_t              keyCacheMisses = 0;
+    };
+
+    static void appendVerifyRequest(const VerifyRequest& request, std::string& out);
+    static void appendStatsRequest(uint32_t id, std::string& out);
+    static void appendVerifyResponse(const VerifyResponse& response, std::string& out);
+    static void appendStatsResponse(const StatsResponse& response, std::string& out);
+    static void appendError(uint32_t id, ErrorReason reason, std::string& out);
+
+    /**
+     * Size of the frame at the start of data, length prefix included, or 0
+     * if fewer than that many bytes are available yet.
+     *
+     * Throws std::runtime_error if the announced length is out of range.
+     */
+    static size_t frameSize(const uint8_t* data, size_t size);
+
+    // data/size must be exactly one frame (see frameSize); body points into data
+    static Frame parseFrame(const uint8_t* data, size_t size);
+
+    static VerifyRequest parseVerifyRequest(const Frame& frame);
+    static VerifyResponse parseVerifyResponse(const Frame& frame);
+    static StatsResponse parseStatsResponse(const Frame& frame);
+    static ErrorReason parseError(const Frame& frame);
+};
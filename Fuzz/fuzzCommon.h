@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+
+// Shared by the libFuzzer harnesses in this directory.
+
+// Property violations abort, so libFuzzer saves the input as a crash
+#define FUZZ_CHECK(condition)                                                          \
+    do {                                                                               \
+        if (!(condition)) {                                                            \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                              \
+        }                                                                              \
+    } while (0)
+
+// Verification clock for every harness; the seed corpus is signed at this time
+constexpr int64_t kFuzzNow = 1732368000;
+
+// Payload harness input is "<pit>\n<ticket>"; without a newline the whole input is both
+inline std::pair<std::string_view, std::string_view> splitPayloads(const uint8_t* data, size_t size)
+{
+    std::string_view input(reinterpret_cast<const char*>(data), size);
+    const size_t newline = input.find('\n');
+    if (newline == std::string_view::npos) {
+        return {input, input};
+    }
+    return {input.substr(0, newline), input.substr(newline + 1)};
+}
@@ -0,0 +1,188 @@
+// fuzzSeedCorpus - write the seed corpus for the harnesses in this directory
+//
+// Mints a user and a company key and writes real, correctly signed PIT and
+// ticket payloads of every version (timestamped kFuzzNow), plus near misses
+// that stop at each verification step, and verifyDaemon frames carrying them:
+//
+//   <dir>/payloads/          fuzzScanPayload, fuzzTicketOwnership
+//   <dir>/verify-protocol/   fuzzVerifyProtocol
+//
+// Keys are fresh on every run, so the corpus is generated rather than
+// checked in.
+//
+// Usage: fuzzSeedCorpus <dir>
+
+#include "fuzzCommon.h"
+
+#include "Ed25519Signer.h"
+#include "KeyFingerprint.h"
+#include "PgpKeyManager.h"
+#include "ScanMessage.h"
+#include "VerifyProtocol.h"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+namespace {
+
+struct Signer
+{
+    explicit Signer(const std::string& userId)
+        : pgp(userId)
+        , raw(Ed25519Signer::fromOpenPgpSecretKey(pgp.exportSecretKeyArmored()))
+        , fingerprint(KeyFingerprint::fromEd25519(raw->publicKey()))
+    {
+    }
+
+    // Signature in the given payload version over the v1 text or the canonical message
+    std::string sign(int version, const std::string& legacyText, const ScanMessage& message) const
+    {
+        std::vector<uint8_t> signature;
+        if (version == 2) {
+            const Ed25519Signer::Signature rawSignature = raw->sign(message.data(), message.size());
+            signature.assign(rawSignature.begin(), rawSignature.end());
+        } else if (version == 1) {
+            pgp.signData(reinterpret_cast<const uint8_t*>(legacyText.data()), legacyText.size(), signature);
+        } else {
+            pgp.signData(message.data(), message.size(), signature);
+        }
+
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        for (uint8_t byte : signature) {
+            hex += digits[byte >> 4];
+            hex += digits[byte & 0x0f];
+        }
+        return hex;
+    }
+
+    PgpKeyManager                  pgp;
+    std::unique_ptr<Ed25519Signer> raw;
+    KeyFingerprint                 fingerprint;
+};
+
+std::string suffix(int version)
+{
+    return version == 1 ? "" : std::to_string(version);
+}
+
+std::string pit(const Signer& user, int version, int64_t timestamp)
+{
+    const std::string legacyText = user.pgp.exportPublicKeyArmored() + std::to_string(timestamp);
+    return "PIT" + suffix(version) + ":" + user.fingerprint.toHex() + ":" + std::to_string(timestamp) + ":" +
+           user.sign(version, legacyText, ScanMessage::pit(user.fingerprint, timestamp));
+}
+
+std::string ticket(const Signer& company, const Signer& user, const std::string& bookingRef, int version)
+{
+    const std::string legacyText = user.pgp.exportPublicKeyArmored() + bookingRef + std::to_string(kFuzzNow);
+    return "TICKET" + suffix(version) + ":" + bookingRef + ":" + std::to_string(kFuzzNow) + ":" +
+           user.fingerprint.toHex() + ":" +
+           company.sign(version, legacyText, ScanMessage::ticket(user.fingerprint, bookingRef, kFuzzNow));
+}
+
+void writeSeed(const std::string& dir, const std::string& name, const std::string& data)
+{
+    std::ofstream out(dir + "/" + name, std::ios::binary | std::ios::trunc);
+    out << data;
+    if (!out) {
+        throw std::runtime_error("Cannot write " + dir + "/" + name);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <dir>\n", argv[0]);
+        return 2;
+    }
+    const std::string root = argv[1];
+    const std::string payloads = root + "/payloads";
+    const std::string protocol = root + "/verify-protocol";
+    for (const std::string& dir : {root, payloads, protocol}) {
+        ::mkdir(dir.c_str(), 0755);
+    }
+
+    try {
+        const Signer user("fuzz-user@example.com");
+        const Signer other("fuzz-other@example.com");
+        const Signer company("fuzz-company@example.com");
+
+        std::string stream;
+        uint32_t id = 0;
+        for (int version = 1; version <= 3; ++version) {
+            const std::string v = "v" + std::to_string(version);
+            const std::string goodPit = pit(user, version, kFuzzNow);
+            const std::string goodTicket = ticket(company, user, "FUZZ0001", version);
+
+            writeSeed(payloads, v + "-pair", goodPit + "\n" + goodTicket);
+            writeSeed(payloads, v + "-pit", goodPit);
+            writeSeed(payloads, v + "-ticket", goodTicket);
+            writeSeed(payloads, v + "-expired", pit(user, version, kFuzzNow - 3600) + "\n" + goodTicket);
+            writeSeed(payloads, v + "-key-mismatch", pit(other, version, kFuzzNow) + "\n" + goodTicket);
+            writeSeed(payloads, v + "-truncated", goodPit.substr(0, goodPit.size() / 2) + "\n" +
+                                                  goodTicket.substr(0, goodTicket.size() / 2));
+
+            VerifyProtocol::VerifyRequest request;
+            request.id = ++id;
+            request.gateId = 7;
+            request.pit = goodPit;
+            request.ticket = goodTicket;
+            std::string frame;
+            VerifyProtocol::appendVerifyRequest(request, frame);
+            writeSeed(protocol, v + "-verify", frame);
+            stream += frame;
+
+            VerifyProtocol::VerifyResponse response;
+            response.id = id;
+            response.flags = VerifyProtocol::TicketSignatureChecked;
+            response.pitTimestamp = kFuzzNow;
+            response.ticketTimestamp = kFuzzNow;
+            response.bookingRef = "FUZZ0001";
+            frame.clear();
+            VerifyProtocol::appendVerifyResponse(response, frame);
+            writeSeed(protocol, v + "-verify-result", frame);
+        }
+
+        // Timestamps at the ends of the int64 range, for the freshness check's arithmetic
+        const std::string fingerprint = user.fingerprint.toHex();
+        const std::string v3Ticket = ticket(company, user, "FUZZ0001", 3);
+        writeSeed(payloads, "timestamp-min", "PIT3:" + fingerprint + ":-9223372036854775808:00\n" + v3Ticket);
+        writeSeed(payloads, "timestamp-max", "PIT3:" + fingerprint + ":9223372036854775807:00\n" + v3Ticket);
+
+        std::string frame;
+        VerifyProtocol::appendStatsRequest(++id, frame);
+        writeSeed(protocol, "stats", frame);
+        stream += frame;
+
+        VerifyProtocol::StatsResponse stats;
+        stats.id = id;
+        stats.verdictCounts = {412, 0, 3, 1, 0, 2, 0, 0, 0, 1};
+        stats.replayEntries = 57;
+        stats.keyCacheHits = 400;
+        stats.keyCacheMisses = 12;
+        frame.clear();
+        VerifyProtocol::appendStatsResponse(stats, frame);
+        writeSeed(protocol, "stats-result", frame);
+
+        frame.clear();
+        VerifyProtocol::appendError(id, VerifyProtocol::ErrorReason::Overloaded, frame);
+        writeSeed(protocol, "error", frame);
+
+        // A pipelined client, as the daemon reads it
+        writeSeed(protocol, "pipelined", stream);
+
+        std::printf("Seed corpus written to %s\n", root.c_str());
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "fuzzSeedCorpus: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
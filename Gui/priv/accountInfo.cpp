@@ -1,22 +1,27 @@
 #include "accountInfo.h"
 
-AccountInfo::AccountInfo(const QString& email, const QString& publicKey, const QString& privateKey)
+AccountInfo::AccountInfo(const QString& email, const QString& publicKey, std::shared_ptr<const SigningKey> signingKey)
     : email_(email)
     , publicKey_(publicKey)
-    , privateKey_(privateKey)
+    , signingKey_(std::move(signingKey))
 {
+    if (signingKey_) {
+        keyFingerprint_ = signingKey_->fingerprint();
+    }
 }
 
-void AccountInfo::setKeys(const QString& email, const QString& publicKey, const QString& privateKey)
+void AccountInfo::setKeys(const QString& email, const QString& publicKey, std::shared_ptr<const SigningKey> signingKey)
 {
     email_ = email;
     publicKey_ = publicKey;
-    privateKey_ = privateKey;
+    signingKey_ = std::move(signingKey);
+    keyFingerprint_ = signingKey_ ? signingKey_->fingerprint() : KeyFingerprint();
 }
 
 void AccountInfo::clear()
 {
     email_.clear();
     publicKey_.clear();
-    privateKey_.clear();
+    keyFingerprint_ = KeyFingerprint();
+    signingKey_.reset();
 }
\ No newline at end of file
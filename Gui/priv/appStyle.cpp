@@ -0,0 +1,162 @@
+#include "appStyle.h"
+#include <QApplication>
+#include <QStyle>
+#include <QWidget>
+
+namespace {
+
+// Rules are scoped by role, so unlike the per-widget sheets they replace they
+// do not cascade into children (no more "background: transparent; border: none"
+// on every label inside a card).
+const char* const kStyleSheet = R"(
+/* ---- Pages and headers ---- */
+QWidget[role="page"] { background-color: #f5f5f5; }
+QScrollArea[role="page"] { border: none; background-color: #f5f5f5; }
+QWidget[role="header"] { background-color: #eb0000; }
+QLabel[role="logo"] { background: transparent; border: none; padding: 0; }
+QLabel[role="headerTitle"] { color: white; font-size: 18px; font-weight: 600; }
+QLabel[role="title"] { font-size: 28px; font-weight: 600; color: #333; }
+QLabel[role="subtitle"] { font-size: 14px; color: #666; }
+QLabel[role="hint"] { font-size: 13px; color: #666; }
+
+/* ---- Cards and panels ---- */
+QWidget[role="card"] { background-color: white; border-radius: 12px; }
+QWidget[role="panel"] { background-color: white; border: 1px solid #e0e0e0; border-radius: 12px; }
+QLabel[role="panelTitle"] { font-size: 16px; font-weight: 600; color: #333; }
+
+/* ---- Form fields ([error="true"] after a failed submit) ---- */
+QLabel[role="fieldLabel"] { font-weight: 600; font-size: 13px; color: #333; margin-bottom: 4px; }
+QLineEdit[role="field"], QDateEdit[role="field"], QTimeEdit[role="field"] {
+    padding: 10px 14px; border: 2px solid #e0e0e0; border-radius: 6px;
+    color: #000; font-size: 14px; background-color: #fafafa;
+}
+QLineEdit[role="field"][variant="large"] { padding: 12px 16px; border-radius: 8px; }
+QLineEdit[role="field"]:focus, QDateEdit[role="field"]:focus, QTimeEdit[role="field"]:focus {
+    border-color: #eb0000; background-color: white;
+}
+QLineEdit[role="field"][error="true"] { border-color: #eb0000; }
+QDateEdit[role="field"] { padding-right: 30px; }
+QDateEdit[role="field"]::down-arrow {
+    width: 12px; height: 8px; image: none;
+    border-left: 5px solid transparent; border-right: 5px solid transparent; border-top: 6px solid #666;
+}
+QDateEdit[role="field"]::down-arrow:hover { border-top: 6px solid #eb0000; }
+QTimeEdit[role="field"]::drop-down { border: none; width: 25px; }
+
+QCalendarWidget QToolButton { color: black; background-color: white; font-size: 14px; font-weight: 600; }
+QCalendarWidget QMenu { color: black; background-color: white; }
+QCalendarWidget QSpinBox {
+    color: black; background-color: white; selection-background-color: #eb0000; selection-color: white;
+}
+QCalendarWidget QWidget#qt_calendar_navigationbar { background-color: #f5f5f5; }
+QCalendarWidget QTableView { selection-background-color: #eb0000; selection-color: white; }
+QCalendarWidget QWidget { alternate-background-color: #f5f5f5; }
+QCalendarWidget QAbstractItemView:enabled { color: black; background-color: white; }
+QCalendarWidget QAbstractItemView:disabled { color: #999; }
+
+/* ---- Status lines ([state="ok"] / [state="error"]) ---- */
+QLabel[role="status"] { font-size: 13px; color: #666; }
+QLabel[role="status"][state="ok"] { color: #27ae60; font-weight: 600; }
+QLabel[role="status"][state="error"] { color: #eb0000; font-weight: 600; }
+QLabel[role="timer"] { font-size: 14px; font-weight: 600; color: #eb0000; }
+
+/* ---- Buttons ---- */
+QPushButton[role="primary"] {
+    background-color: #eb0000; color: white; font-weight: 600;
+    font-size: 15px; border: none; border-radius: 8px;
+}
+QPushButton[role="primary"]:hover { background-color: #c00000; }
+QPushButton[role="primary"]:pressed { background-color: #a00000; }
+QPushButton[role="primary"]:disabled { background-color: #e0e0e0; color: #999; }
+
+QPushButton[role="secondary"] {
+    background-color: white; color: #666; font-weight: 600;
+    font-size: 14px; border: 2px solid #e0e0e0; border-radius: 8px;
+}
+QPushButton[role="secondary"]:hover { background-color: #f5f5f5; border-color: #ccc; }
+
+QPushButton[role="accent"] {
+    background-color: #3498db; color: white; font-weight: bold;
+    font-size: 14px; border: none; border-radius: 8px;
+}
+QPushButton[role="accent"]:hover { background-color: #2980b9; }
+QPushButton[role="accent"]:pressed { background-color: #21618c; }
+
+QPushButton[role="light"] {
+    background-color: white; color: black; font-weight: bold;
+    font-size: 14px; border: none; border-radius: 8px;
+}
+QPushButton[role="light"]:hover { background-color: #f5f5f5; }
+
+/* ---- Navigation ---- */
+QWidget[role="navBar"] { background-color: white; border-top: 1px solid #e0e0e0; }
+QPushButton[role="nav"] { background-color: transparent; border: none; border-radius: 8px; padding: 8px; }
+QPushButton[role="nav"]:hover { background-color: #f5f5f5; }
+QPushButton[role="nav"]:pressed { background-color: #e0e0e0; }
+
+/* ---- Tickets ---- */
+QWidget[role="ticketCard"] { background-color: white; border-radius: 12px; border: 1px solid #e0e0e0; }
+QLabel[role="ticketRef"] { font-size: 16px; font-weight: 600; color: #666; }
+QLabel[role="ticketStation"] { font-size: 20px; font-weight: bold; color: #000; }
+QLabel[role="ticketArrow"] { font-size: 20px; color: #eb0000; }
+QLabel[role="ticketIcon"] { font-size: 16px; }
+QLabel[role="ticketDetail"] { font-size: 15px; color: #666; }
+QFrame[role="divider"] { background-color: #e0e0e0; border: none; }
+QLabel[role="empty"] { font-size: 16px; color: #999; padding: 60px; }
+
+QScrollArea[role="ticketList"] { border: none; background-color: transparent; }
+QScrollArea[role="ticketList"] QScrollBar:vertical {
+    border: none; background: #e5e5e5; width: 10px; border-radius: 5px;
+}
+QScrollArea[role="ticketList"] QScrollBar::handle:vertical { background: #bbb; border-radius: 5px; min-height: 30px; }
+QScrollArea[role="ticketList"] QScrollBar::handle:vertical:hover { background: #999; }
+QScrollArea[role="ticketList"] QScrollBar::add-line:vertical,
+QScrollArea[role="ticketList"] QScrollBar::sub-line:vertical { height: 0px; }
+
+/* ---- QR codes ---- */
+QWidget[role="overlay"] { background-color: rgba(0, 0, 0, 0.95); }
+QLabel[role="overlayTitle"] { font-size: 24px; font-weight: bold; color: white; }
+QLabel[role="qrCode"] { background-color: white; padding: 10px; border-radius: 12px; }
+QLabel[role="qrPreview"] {
+    background-color: #fafafa; border: 2px dashed #e0e0e0; border-radius: 8px; color: #666;
+}
+
+/* ---- Inspector verdict ([verdict="valid"] / [verdict="invalid"]) ---- */
+QWidget[role="resultPanel"] { background-color: white; border: 1px solid #e0e0e0; border-radius: 12px; }
+QWidget[role="resultPanel"][verdict="valid"] { background-color: #d5f4e6; border: 2px solid #27ae60; }
+QWidget[role="resultPanel"][verdict="invalid"] { background-color: #ffe6e6; border: 2px solid #eb0000; }
+QLabel[role="resultIcon"] { font-size: 36px; font-weight: 600; }
+QLabel[role="resultText"] { font-size: 18px; font-weight: 600; color: #666; }
+QLabel[role="resultDetails"] { font-size: 13px; color: #666; }
+QLabel[verdict="valid"] { color: #27ae60; font-weight: 600; }
+QLabel[verdict="invalid"] { color: #eb0000; font-weight: 600; }
+
+/* ---- Inspector diagnostics ---- */
+QTableWidget[role="diagnosticsTable"] { border: none; font-size: 12px; gridline-color: #eeeeee; }
+QLabel[role="diagnosticsCounters"] { font-size: 12px; color: #666; }
+)";
+
+} // namespace
+
+void AppStyle::install(QApplication& app)
+{
+    app.setStyleSheet(QString::fromLatin1(kStyleSheet));
+}
+
+void AppStyle::setRole(QWidget* widget, const char* role)
+{
+    widget->setProperty("role", QString::fromLatin1(role));
+}
+
+void AppStyle::setState(QWidget* widget, const char* name, const QVariant& value)
+{
+    if (widget->property(name) == value) {
+        return;
+    }
+    widget->setProperty(name, value);
+
+    // Qt does not re-match rules when a dynamic property changes
+    widget->style()->unpolish(widget);
+    widget->style()->polish(widget);
+    widget->update();
+}
@@ -1,18 +1,25 @@
 #include "bookingReference.h"
+#include "appStyle.h"
+#include "cardShadow.h"
 #include "qrCodeGen.h"
+#include "ticketOwnership.h"
+#include "ScanMessage.h"
+#include "companyKeys.h"
+#include "scanHandoff.h"
+#include "startupProfiler.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFrame>
 #include <QPixmap>
-#include <QGraphicsDropShadowEffect>
+#include <QStyle>
+#include <QStyleOption>
+#include <QPainter>
 #include <QTimer>
 #include <QScrollArea>
 #include <QDateTime>
-#include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <rnp/rnp.h>
-#include <rnp/rnp_err.h>
 
 // ============ TicketCard Implementation ============
 
@@ -22,22 +29,16 @@ TicketCard::TicketCard(const TicketInfo& ticket, QWidget* parent)
 {
 
     auto mainLayout = new QVBoxLayout(this);
-    mainLayout->setContentsMargins(20, 20, 20, 20);
+    mainLayout->setContentsMargins(QMargins(20, 20, 20, 20) + CardShadow::margins());
     mainLayout->setSpacing(16);
     
-    // Modern card styling with rounded corners and shadow
-    setStyleSheet(
-        "TicketCard { "
-        "  background-color: white; "
-        "  border-radius: 12px; "
-        "  border: 1px solid #e0e0e0; "
-        "}"
-    );
+    // Modern card styling with rounded corners and shadow (see paintEvent)
+    AppStyle::setRole(this, "ticketCard");
 
     // Header: Booking reference and status
     auto headerLayout = new QHBoxLayout();
     auto refLabel = new QLabel("Ref: " + ticket_.bookingReference(), this);
-    refLabel->setStyleSheet("font-size: 16px; font-weight: 600; color: #666; border: none; background: transparent;");
+    AppStyle::setRole(refLabel, "ticketRef");
     
     headerLayout->addWidget(refLabel);
     headerLayout->addStretch();
@@ -47,13 +48,13 @@ TicketCard::TicketCard(const TicketInfo& ticket, QWidget* parent)
     routeLayout->setSpacing(12);
     
     auto fromLabel = new QLabel(ticket_.departure(), this);
-    fromLabel->setStyleSheet("font-size: 20px; font-weight: bold; color: #000; border: none; background: transparent;");
+    AppStyle::setRole(fromLabel, "ticketStation");
     
     auto arrowLabel = new QLabel("→", this);
-    arrowLabel->setStyleSheet("font-size: 20px; color: #eb0000; border: none; background: transparent;");
+    AppStyle::setRole(arrowLabel, "ticketArrow");
     
     auto toLabel = new QLabel(ticket_.destination(), this);
-    toLabel->setStyleSheet("font-size: 20px; font-weight: bold; color: #000; border: none; background: transparent;");
+    AppStyle::setRole(toLabel, "ticketStation");
     
     routeLayout->addWidget(fromLabel);
     routeLayout->addWidget(arrowLabel);
@@ -65,14 +66,14 @@ TicketCard::TicketCard(const TicketInfo& ticket, QWidget* parent)
     dateTimeLayout->setSpacing(20);
     
     auto dateIcon = new QLabel("📅", this);
-    dateIcon->setStyleSheet("font-size: 16px; border: none; background: transparent;");
+    AppStyle::setRole(dateIcon, "ticketIcon");
     auto dateLabel = new QLabel(ticket_.date().toString("MMM d, yyyy"), this);
-    dateLabel->setStyleSheet("font-size: 15px; color: #666; border: none; background: transparent;");
+    AppStyle::setRole(dateLabel, "ticketDetail");
     
     auto timeIcon = new QLabel("🕐", this);
-    timeIcon->setStyleSheet("font-size: 16px; border: none; background: transparent;");
+    AppStyle::setRole(timeIcon, "ticketIcon");
     auto timeLabel = new QLabel(ticket_.time().toString("hh:mm"), this);
-    timeLabel->setStyleSheet("font-size: 15px; color: #666; border: none; background: transparent;");
+    AppStyle::setRole(timeLabel, "ticketDetail");
     
     dateTimeLayout->addWidget(dateIcon);
     dateTimeLayout->addWidget(dateLabel);
@@ -84,25 +85,14 @@ TicketCard::TicketCard(const TicketInfo& ticket, QWidget* parent)
     // Divider line
     auto divider = new QFrame(this);
     divider->setFrameShape(QFrame::HLine);
-    divider->setStyleSheet("background-color: #e0e0e0; border: none;");
+    AppStyle::setRole(divider, "divider");
     divider->setFixedHeight(1);
 
     // QR Code button with modern SBB styling
     auto qrButton = new QPushButton("View QR Code", this);
     qrButton->setFixedHeight(44);
     qrButton->setCursor(Qt::PointingHandCursor);
-    qrButton->setStyleSheet(
-        "QPushButton { "
-        "  background-color: #eb0000; color: white; font-weight: 600; "
-        "  font-size: 14px; border: none; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { "
-        "  background-color: #c00000; "
-        "} "
-        "QPushButton:pressed { "
-        "  background-color: #a00000; "
-        "}"
-    );
+    AppStyle::setRole(qrButton, "primary");
     connect(qrButton, &QPushButton::clicked, this, [this]() {
         emit qrCodeRequested(ticket_);
     });
@@ -117,6 +107,20 @@ TicketCard::TicketCard(const TicketInfo& ticket, QWidget* parent)
     setLayout(mainLayout);
 }
 
+void TicketCard::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    const QRect card = rect().marginsRemoved(CardShadow::margins());
+    CardShadow::paint(painter, card, CORNER_RADIUS);
+
+    // Background and border from the application stylesheet, inside the shadow
+    QStyleOption option;
+    option.initFrom(this);
+    option.rect = card;
+    style()->drawPrimitive(QStyle::PE_Widget, &option, &painter, this);
+}
+
 // ============ BookingReference Implementation ============
 
 BookingReference::BookingReference(QWidget* parent)
@@ -130,21 +134,7 @@ BookingReference::BookingReference(QWidget* parent)
     scrollArea_ = new QScrollArea(this);
     scrollArea_->setWidgetResizable(true);
     scrollArea_->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    scrollArea_->setStyleSheet(
-        "QScrollArea { border: none; background-color: transparent; } "
-        "QScrollBar:vertical { "
-        "  border: none; background: #e5e5e5; width: 10px; border-radius: 5px; "
-        "} "
-        "QScrollBar::handle:vertical { "
-        "  background: #bbb; border-radius: 5px; min-height: 30px; "
-        "} "
-        "QScrollBar::handle:vertical:hover { "
-        "  background: #999; "
-        "} "
-        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical { "
-        "  height: 0px; "
-        "}"
-    );
+    AppStyle::setRole(scrollArea_, "ticketList");
 
     // Container widget inside scroll area
     ticketContainer_ = new QWidget();
@@ -158,7 +148,7 @@ BookingReference::BookingReference(QWidget* parent)
 
     // No tickets message with modern styling
     noTicketLabel_ = new QLabel("No tickets yet\n\nBook your first ticket from the Home page", this);
-    noTicketLabel_->setStyleSheet("font-size: 16px; color: #999; padding: 60px; line-height: 1.6;");
+    AppStyle::setRole(noTicketLabel_, "empty");
     noTicketLabel_->setAlignment(Qt::AlignCenter);
 
     mainLayout->addWidget(scrollArea_, 1);
@@ -176,7 +166,7 @@ void BookingReference::setupQROverlay()
 {
     // Create centered QR overlay
     qrOverlay_ = new QWidget(this);
-    qrOverlay_->setStyleSheet("background-color: rgba(0, 0, 0, 0.95);");
+    AppStyle::setRole(qrOverlay_, "overlay");
     qrOverlay_->hide();
     
     auto overlayLayout = new QVBoxLayout(qrOverlay_);
@@ -187,7 +177,7 @@ void BookingReference::setupQROverlay()
     
     // Title
     qrTitleLabel_ = new QLabel("Scan Ticket", qrOverlay_);
-    qrTitleLabel_->setStyleSheet("font-size: 24px; font-weight: bold; color: white;");
+    AppStyle::setRole(qrTitleLabel_, "overlayTitle");
     qrTitleLabel_->setAlignment(Qt::AlignCenter);
     overlayLayout->addWidget(qrTitleLabel_);
     
@@ -196,7 +186,7 @@ void BookingReference::setupQROverlay()
     // QR Code image (will be generated when ticket is shown)
     qrImageLabel_ = new QLabel(qrOverlay_);
     qrImageLabel_->setAlignment(Qt::AlignCenter);
-    qrImageLabel_->setStyleSheet("background-color: white; padding: 20px; border-radius: 12px;");
+    AppStyle::setRole(qrImageLabel_, "qrCode");
     qrImageLabel_->setFixedSize(320, 320);
     
     overlayLayout->addWidget(qrImageLabel_, 0, Qt::AlignCenter);
@@ -206,35 +196,28 @@ void BookingReference::setupQROverlay()
     // Download button
     downloadQRButton_ = new QPushButton("Download QR Code", qrOverlay_);
     downloadQRButton_->setFixedSize(200, 50);
-    downloadQRButton_->setStyleSheet(
-        "QPushButton { "
-        "  background-color: #3498db; color: white; font-weight: bold; "
-        "  font-size: 16px; border: none; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { "
-        "  background-color: #2980b9; "
-        "}"
-    );
+    AppStyle::setRole(downloadQRButton_, "accent");
     connect(downloadQRButton_, &QPushButton::clicked, this, &BookingReference::downloadCurrentQRCode);
     
+    // Hand the code to a running inspector without saving it (--both / --handoff)
+    handoffButton_ = new QPushButton("Show to Inspector", qrOverlay_);
+    handoffButton_->setFixedSize(200, 50);
+    AppStyle::setRole(handoffButton_, "accent");
+    handoffButton_->setVisible(ScanHandoff::isEnabled());
+    connect(handoffButton_, &QPushButton::clicked, this, &BookingReference::showCurrentQRCodeToInspector);
+    
     // Close button
     auto closeButton = new QPushButton("Close", qrOverlay_);
     closeButton->setFixedSize(200, 50);
-    closeButton->setStyleSheet(
-        "QPushButton { "
-        "  background-color: white; color: black; font-weight: bold; "
-        "  font-size: 16px; border: none; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { "
-        "  background-color: #f5f5f5; "
-        "}"
-    );
+    AppStyle::setRole(closeButton, "light");
     connect(closeButton, &QPushButton::clicked, this, &BookingReference::hideQRCode);
     
     auto buttonLayout = new QHBoxLayout();
     buttonLayout->addStretch();
     buttonLayout->addWidget(downloadQRButton_);
     buttonLayout->addSpacing(10);
+    buttonLayout->addWidget(handoffButton_);
+    buttonLayout->addSpacing(10);
     buttonLayout->addWidget(closeButton);
     buttonLayout->addStretch();
     overlayLayout->addLayout(buttonLayout);
@@ -251,7 +234,9 @@ void BookingReference::showQRCode(const TicketInfo& ticket)
     qrTitleLabel_->setText("Ticket: " + ticket.bookingReference());
     
     try {
-        if (!companyInfo_ || !companyInfo_->isValid()) {
+        // Blocks only if the background key bootstrap has not finished yet
+        const CompanyInfo& companyInfo = sharedCompanyInfo();
+        if (!companyInfo.isValid()) {
             throw std::runtime_error("Company info not available");
         }
         
@@ -261,144 +246,65 @@ void BookingReference::showQRCode(const TicketInfo& ticket)
             timestamp = QDateTime::currentSecsSinceEpoch();
         }
         
-        // Create data to sign: userPublicKey + bookingReference + timestamp
-        QString dataToSign = ticket.userPublicKey() + ticket.bookingReference() + QString::number(timestamp);
+        // Fingerprint was taken from the account at booking time
+        const KeyFingerprint& fingerprint = ticket.userKeyFingerprint();
+        if (fingerprint.isNull()) {
+            throw std::runtime_error("Ticket has no user key");
+        }
         
-        // If ticket already has signed data, use it; otherwise generate signature
+        // If ticket already has signed data, use it (always an OpenPGP signature);
+        // otherwise generate a signature in the configured payload version
         QString signatureHex = ticket.signedData();
+        int version = TicketOwnership::PayloadOpenPgp;
         
-        if (signatureHex.isEmpty()) {
-            // Sign using company's private key
-            rnp_ffi_t ffi = nullptr;
-            if (rnp_ffi_create(&ffi, "GPG", "GPG") != RNP_SUCCESS || !ffi) {
-                throw std::runtime_error("Failed to create RNP FFI for signing");
-            }
-            
-            // Import company's private key
-            QByteArray privateKeyBytes = companyInfo_->privateKey().toUtf8();
-            rnp_input_t key_input = nullptr;
-            if (rnp_input_from_memory(&key_input,
-                                      reinterpret_cast<const uint8_t*>(privateKeyBytes.constData()),
-                                      privateKeyBytes.size(),
-                                      false) != RNP_SUCCESS) {
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to create input for company private key");
-            }
-            
-            if (rnp_import_keys(ffi, key_input, RNP_LOAD_SAVE_SECRET_KEYS, nullptr) != RNP_SUCCESS) {
-                rnp_input_destroy(key_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to import company private key");
-            }
-            rnp_input_destroy(key_input);
-            
-            // Sign the data
-            QByteArray dataBytes = dataToSign.toUtf8();
-            rnp_input_t data_input = nullptr;
-            if (rnp_input_from_memory(&data_input,
-                                      reinterpret_cast<const uint8_t*>(dataBytes.constData()),
-                                      dataBytes.size(),
-                                      false) != RNP_SUCCESS) {
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to create input for data");
-            }
-            
-            rnp_output_t sig_output = nullptr;
-            if (rnp_output_to_memory(&sig_output, 0) != RNP_SUCCESS) {
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to create output for signature");
-            }
-            
-            rnp_op_sign_t sign_op = nullptr;
-            if (rnp_op_sign_detached_create(&sign_op, ffi, data_input, sig_output) != RNP_SUCCESS) {
-                rnp_output_destroy(sig_output);
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to create signing operation");
-            }
-            
-            // Get company key
-            rnp_identifier_iterator_t it = nullptr;
-            if (rnp_identifier_iterator_create(ffi, &it, "grip") != RNP_SUCCESS) {
-                rnp_op_sign_destroy(sign_op);
-                rnp_output_destroy(sig_output);
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to create key iterator");
+        if (signatureHex.isEmpty() &&
+            TicketOwnership::issuePayloadVersion() == TicketOwnership::PayloadEd25519) {
+            // Raw Ed25519 over the canonical binary message (TICKET2)
+            version = TicketOwnership::PayloadEd25519;
+            if (!companyFastSigner_) {
+                companyFastSigner_ = Ed25519Signer::fromOpenPgpSecretKey(companyInfo.privateKey().toStdString());
             }
             
-            const char* grip = nullptr;
-            rnp_key_handle_t key = nullptr;
-            if (rnp_identifier_iterator_next(it, &grip) == RNP_SUCCESS && grip) {
-                if (rnp_locate_key(ffi, "grip", grip, &key) != RNP_SUCCESS || !key) {
-                    rnp_identifier_iterator_destroy(it);
-                    rnp_op_sign_destroy(sign_op);
-                    rnp_output_destroy(sig_output);
-                    rnp_input_destroy(data_input);
-                    rnp_ffi_destroy(ffi);
-                    throw std::runtime_error("Failed to locate company key");
-                }
+            QByteArray refBytes = ticket.bookingReference().toUtf8();
+            ScanMessage message = ScanMessage::ticket(fingerprint,
+                                                      std::string_view(refBytes.constData(), refBytes.size()),
+                                                      timestamp);
+            Ed25519Signer::Signature signature = companyFastSigner_->sign(message.data(), message.size());
+            signatureHex = QByteArray::fromRawData(reinterpret_cast<const char*>(signature.data()),
+                                                   static_cast<int>(signature.size())).toHex();
+        } else if (signatureHex.isEmpty()) {
+            // Import the company key once; later tickets reuse the resolved key
+            if (!companySigner_) {
+                companySigner_ = PgpKeyManager::fromSecretKey(companyInfo.privateKey().toStdString());
             }
-            rnp_identifier_iterator_destroy(it);
             
-            if (!key) {
-                rnp_op_sign_destroy(sign_op);
-                rnp_output_destroy(sig_output);
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("No company key found");
+            if (TicketOwnership::issuePayloadVersion() == TicketOwnership::PayloadOpenPgpMessage) {
+                // OpenPGP over the canonical binary message (TICKET3)
+                version = TicketOwnership::PayloadOpenPgpMessage;
+                QByteArray refBytes = ticket.bookingReference().toUtf8();
+                ScanMessage message = ScanMessage::ticket(fingerprint,
+                                                          std::string_view(refBytes.constData(), refBytes.size()),
+                                                          timestamp);
+                companySigner_->signData(message.data(), message.size(), signatureBuffer_);
+            } else {
+                // Version 1: sign userPublicKey + bookingReference + timestamp
+                QString dataToSign = ticket.userPublicKey() + ticket.bookingReference() + QString::number(timestamp);
+                QByteArray dataBytes = dataToSign.toUtf8();
+                companySigner_->signData(reinterpret_cast<const uint8_t*>(dataBytes.constData()),
+                                         static_cast<size_t>(dataBytes.size()),
+                                         signatureBuffer_);
             }
             
-            if (rnp_op_sign_add_signature(sign_op, key, nullptr) != RNP_SUCCESS) {
-                rnp_key_handle_destroy(key);
-                rnp_op_sign_destroy(sign_op);
-                rnp_output_destroy(sig_output);
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to add company signer");
-            }
-            
-            if (rnp_op_sign_execute(sign_op) != RNP_SUCCESS) {
-                rnp_key_handle_destroy(key);
-                rnp_op_sign_destroy(sign_op);
-                rnp_output_destroy(sig_output);
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Company signing failed");
-            }
-            
-            uint8_t* sig_buf = nullptr;
-            size_t sig_len = 0;
-            if (rnp_output_memory_get_buf(sig_output, &sig_buf, &sig_len, false) != RNP_SUCCESS) {
-                rnp_key_handle_destroy(key);
-                rnp_op_sign_destroy(sign_op);
-                rnp_output_destroy(sig_output);
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to get company signature");
-            }
-            
-            QByteArray signature(reinterpret_cast<const char*>(sig_buf), sig_len);
-            signatureHex = signature.toHex();
-            
-            rnp_key_handle_destroy(key);
-            rnp_op_sign_destroy(sign_op);
-            rnp_output_destroy(sig_output);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
+            signatureHex = QByteArray::fromRawData(reinterpret_cast<const char*>(signatureBuffer_.data()),
+                                                   static_cast<int>(signatureBuffer_.size())).toHex();
         }
         
-        // Create user's public key hash (first 16 chars of SHA-256)
-        QByteArray userPublicKeyBytes = ticket.userPublicKey().toUtf8();
-        QByteArray userKeyHash = QCryptographicHash::hash(userPublicKeyBytes, QCryptographicHash::Sha256);
-        QString userPublicKeyHash = userKeyHash.toHex().left(16);
-        
         // Create ticket QR code: TICKET:bookingRef:timestamp:userPubKeyHash:companySignature
-        QString ticketData = QString("TICKET:%1:%2:%3:%4")
+        QString ticketData = QString("%1:%2:%3:%4:%5")
+            .arg(TicketOwnership::ticketTag(version))
             .arg(ticket.bookingReference())
             .arg(timestamp)
-            .arg(userPublicKeyHash)
+            .arg(QString::fromStdString(fingerprint.toHex()))
             .arg(signatureHex);
         
         QImage qrImage = QRCodeGenerator::generateQRCode(ticketData, 280);
@@ -425,6 +331,20 @@ void BookingReference::hideQRCode()
     qrOverlay_->hide();
 }
 
+void BookingReference::showCurrentQRCodeToInspector()
+{
+    if (qrImageLabel_->pixmap().isNull()) {
+        QMessageBox::warning(this, "No QR Code", "No QR code is currently displayed.");
+        return;
+    }
+    
+    ScanHandoff::sendFrame(qrImageLabel_->pixmap().toImage(), this, [this](bool sent) {
+        if (!sent) {
+            QMessageBox::warning(this, "Inspector", "Could not reach the inspector. Is it running?");
+        }
+    });
+}
+
 void BookingReference::downloadCurrentQRCode()
 {
     if (qrImageLabel_->pixmap().isNull()) {
@@ -474,7 +394,10 @@ void BookingReference::addTicket(const TicketInfo& ticket)
     scrollArea_->show();
 
     // Create new ticket card
+    QElapsedTimer buildTimer;
+    buildTimer.start();
     auto ticketCard = new TicketCard(ticket, ticketContainer_);
+    StartupProfiler::markBuilt(ticketCard, "ticket card", buildTimer);
     
     // Connect QR code signal
     connect(ticketCard, &TicketCard::qrCodeRequested, this, &BookingReference::showQRCode);
@@ -0,0 +1,126 @@
+#include "cardShadow.h"
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <qdrawutil.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> g_enabled{true};
+
+const QColor kShadowColor(0, 0, 0, 45);
+
+// One box-blur pass over the alpha channel, along rows or along columns.
+// Pixels outside the image count as transparent.
+void blurAlpha(QImage& image, int radius, bool horizontal)
+{
+    const int lines = horizontal ? image.height() : image.width();
+    const int length = horizontal ? image.width() : image.height();
+    const int window = 2 * radius + 1;
+    std::vector<int> alpha(length);
+
+    for (int l = 0; l < lines; ++l) {
+        auto pixel = [&](int i) -> QRgb& {
+            return horizontal ? reinterpret_cast<QRgb*>(image.scanLine(l))[i]
+                              : reinterpret_cast<QRgb*>(image.scanLine(i))[l];
+        };
+        for (int i = 0; i < length; ++i) {
+            alpha[i] = qAlpha(pixel(i));
+        }
+
+        int sum = 0;
+        for (int i = 0; i < radius && i < length; ++i) {
+            sum += alpha[i];
+        }
+        for (int i = 0; i < length; ++i) {
+            if (i + radius < length) {
+                sum += alpha[i + radius];
+            }
+            // Premultiplied black: only the alpha byte is set
+            pixel(i) = static_cast<QRgb>(sum / window) << 24;
+            if (i - radius >= 0) {
+                sum -= alpha[i - radius];
+            }
+        }
+    }
+}
+
+// Smallest rounded rectangle with the given corners (1px straight edges),
+// blurred and padded by the blur radius on every side
+QPixmap renderTile(int cornerRadius, qreal pixelRatio)
+{
+    const int margin = CardShadow::BLUR_RADIUS;
+    const int side = 2 * (margin + cornerRadius) + 1;
+
+    QImage image(QSize(side, side) * pixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.scale(pixelRatio, pixelRatio);
+        QPainterPath path;
+        path.addRoundedRect(QRectF(margin, margin, 2 * cornerRadius + 1, 2 * cornerRadius + 1),
+                            cornerRadius, cornerRadius);
+        painter.fillPath(path, Qt::black);
+    }
+
+    // Three box blurs approximate a Gaussian with sigma ~ BLUR_RADIUS / 2
+    const int passRadius = std::max(1, qRound(CardShadow::BLUR_RADIUS * pixelRatio / 3));
+    for (int pass = 0; pass < 3; ++pass) {
+        blurAlpha(image, passRadius, true);
+        blurAlpha(image, passRadius, false);
+    }
+
+    {
+        QPainter painter(&image);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        painter.fillRect(image.rect(), kShadowColor);
+    }
+
+    QPixmap tile = QPixmap::fromImage(image);
+    tile.setDevicePixelRatio(pixelRatio);
+    return tile;
+}
+
+} // namespace
+
+QMargins CardShadow::margins()
+{
+    return QMargins(BLUR_RADIUS, BLUR_RADIUS - OFFSET_Y, BLUR_RADIUS, BLUR_RADIUS + OFFSET_Y);
+}
+
+void CardShadow::paint(QPainter& painter, const QRect& card, int cornerRadius)
+{
+    if (!g_enabled || card.isEmpty()) {
+        return;
+    }
+
+    const qreal pixelRatio = painter.device() ? painter.device()->devicePixelRatioF() : 1.0;
+    const QString key = QStringLiteral("cardShadow:%1*%2").arg(cornerRadius).arg(pixelRatio);
+
+    QPixmap tile;
+    if (!QPixmapCache::find(key, &tile)) {
+        tile = renderTile(cornerRadius, pixelRatio);
+        QPixmapCache::insert(key, tile);
+    }
+
+    // Corners are copied as they are, edges and the centre are stretched
+    const int corner = BLUR_RADIUS + cornerRadius;
+    const QRect target = card.adjusted(-BLUR_RADIUS, -BLUR_RADIUS, BLUR_RADIUS, BLUR_RADIUS).translated(0, OFFSET_Y);
+    qDrawBorderPixmap(&painter, target, QMargins(corner, corner, corner, corner), tile);
+}
+
+void CardShadow::setEnabled(bool enabled)
+{
+    g_enabled = enabled;
+}
+
+bool CardShadow::isEnabled()
+{
+    return g_enabled;
+}
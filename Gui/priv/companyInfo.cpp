@@ -8,6 +8,18 @@ CompanyInfo::CompanyInfo()
     generateKeys();
 }
 
+CompanyInfo::CompanyInfo(const QString& secretKeyArmored)
+{
+    try {
+        auto keyManager = PgpKeyManager::fromSecretKey(secretKeyArmored.toStdString());
+        publicKey_ = QString::fromStdString(keyManager->exportPublicKeyArmored());
+        privateKey_ = secretKeyArmored;
+    } catch (const std::exception&) {
+        publicKey_.clear();
+        privateKey_.clear();
+    }
+}
+
 void CompanyInfo::generateKeys()
 {
     try {
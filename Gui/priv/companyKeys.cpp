@@ -0,0 +1,86 @@
+#include "companyKeys.h"
+#include "startupProfiler.h"
+#include "Ed25519Signer.h"
+#include <QFile>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+std::once_flag g_started;
+std::shared_future<std::shared_ptr<const CompanyInfo>> g_companyInfo;
+QString g_secretKeyFile;
+
+QString g_pinnedPublicKey;
+bool g_trustOwnKey = false;
+
+const std::shared_future<std::shared_ptr<const CompanyInfo>>& companyInfoFuture()
+{
+    std::call_once(g_started, [] {
+        g_companyInfo = std::async(std::launch::async, [secretKeyFile = g_secretKeyFile] {
+            std::shared_ptr<const CompanyInfo> info;
+            if (secretKeyFile.isEmpty()) {
+                info = std::make_shared<const CompanyInfo>();
+            } else {
+                QFile file(secretKeyFile);
+                const QString secretKey = file.open(QIODevice::ReadOnly) ? QString::fromUtf8(file.readAll())
+                                                                         : QString();
+                info = std::make_shared<const CompanyInfo>(secretKey);
+            }
+            StartupProfiler::mark("company keys ready");
+            return info;
+        }).share();
+    });
+    return g_companyInfo;
+}
+
+} // namespace
+
+void setCompanySecretKeyFile(const QString& path)
+{
+    g_secretKeyFile = path;
+}
+
+void prefetchCompanyKeys()
+{
+    companyInfoFuture();
+}
+
+const CompanyInfo& sharedCompanyInfo()
+{
+    return *companyInfoFuture().get();
+}
+
+bool companyKeysReady()
+{
+    return companyInfoFuture().wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool loadCompanyPublicKey(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray key = file.readAll();
+    if (!Ed25519Signer::publicKeyFromOpenPgp(key.toStdString())) {
+        return false;
+    }
+    g_pinnedPublicKey = QString::fromUtf8(key);
+    return true;
+}
+
+void trustOwnCompanyKey()
+{
+    g_trustOwnKey = true;
+}
+
+QString companyPublicKey()
+{
+    if (!g_pinnedPublicKey.isEmpty()) {
+        return g_pinnedPublicKey;
+    }
+    return g_trustOwnKey ? sharedCompanyInfo().publicKey() : QString();
+}
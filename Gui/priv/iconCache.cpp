@@ -0,0 +1,41 @@
+#include "iconCache.h"
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QPixmapCache>
+#include <QDebug>
+
+QString IconCache::path(const QString& name)
+{
+    return QStringLiteral(":/icons/") + name;
+}
+
+QPixmap IconCache::pixmap(const QString& name, const QSize& size)
+{
+    const qreal pixelRatio = qApp ? qApp->devicePixelRatio() : 1.0;
+    const QString key = QStringLiteral("icon:%1@%2x%3*%4")
+                            .arg(name)
+                            .arg(size.width())
+                            .arg(size.height())
+                            .arg(pixelRatio);
+
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+
+    // SVGs are rendered straight at the target size rather than rasterised
+    // at their natural size and scaled down
+    QImageReader reader(path(name));
+    const QSize target = size * pixelRatio;
+    reader.setScaledSize(reader.size().isValid() ? reader.size().scaled(target, Qt::KeepAspectRatio) : target);
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Failed to load icon" << name << ":" << reader.errorString();
+        return QPixmap();
+    }
+
+    pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(pixelRatio);
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
@@ -1,6 +1,9 @@
 #include "identificationToken.h"
+#include "appStyle.h"
 #include "qrCodeGen.h"
-#include "PgpKeyManager.h"
+#include "ticketOwnership.h"
+#include "ScanMessage.h"
+#include "scanHandoff.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPixmap>
@@ -8,8 +11,59 @@
 #include <QDateTime>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <rnp/rnp.h>
-#include <rnp/rnp_err.h>
+#include <QMetaObject>
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <optional>
+
+namespace {
+
+std::atomic<int> g_precomputeHorizon{0};
+
+// Complete PIT payload for timestamp, in the configured payload version
+QString signedPIT(const SigningKey& key, const QString& publicKey,
+                  qint64 timestamp, std::vector<uint8_t>& signatureBuffer)
+{
+    const int version = TicketOwnership::issuePayloadVersion();
+    QString signatureHex;
+    
+    if (version == TicketOwnership::PayloadEd25519) {
+        // Raw Ed25519 over the canonical binary message (PIT2)
+        ScanMessage message = ScanMessage::pit(key.fingerprint(), timestamp);
+        Ed25519Signer::Signature signature = key.signRaw(message.data(), message.size());
+        signatureHex = QByteArray::fromRawData(reinterpret_cast<const char*>(signature.data()),
+                                               static_cast<int>(signature.size())).toHex();
+    } else if (version == TicketOwnership::PayloadOpenPgpMessage) {
+        // OpenPGP over the canonical binary message (PIT3): a few dozen bytes on the stack
+        ScanMessage message = ScanMessage::pit(key.fingerprint(), timestamp);
+        key.signOpenPgp(message.data(), message.size(), signatureBuffer);
+        
+        signatureHex = QByteArray::fromRawData(reinterpret_cast<const char*>(signatureBuffer.data()),
+                                               static_cast<int>(signatureBuffer.size())).toHex();
+    } else {
+        // Version 1: sign publicKey + timestamp (anonymous, no email)
+        QString dataToSign = publicKey + QString::number(timestamp);
+        
+        // Sign the data into the reused signature buffer
+        QByteArray dataBytes = dataToSign.toUtf8();
+        key.signOpenPgp(reinterpret_cast<const uint8_t*>(dataBytes.constData()),
+                        static_cast<size_t>(dataBytes.size()),
+                        signatureBuffer);
+        
+        signatureHex = QByteArray::fromRawData(reinterpret_cast<const char*>(signatureBuffer.data()),
+                                               static_cast<int>(signatureBuffer.size())).toHex();
+    }
+    
+    // Create anonymous token format: PIT:pubKeyHash:timestamp:signature
+    return QString("%1:%2:%3:%4")
+        .arg(TicketOwnership::pitTag(version))
+        .arg(QString::fromStdString(key.fingerprint().toHex()))
+        .arg(timestamp)
+        .arg(signatureHex);
+}
+
+}
 
 IdentificationToken::IdentificationToken(QWidget* parent)
     : QWidget(parent)
@@ -27,7 +81,7 @@ IdentificationToken::IdentificationToken(QWidget* parent)
 
     // Timer label
     timerLabel_ = new QLabel("Refreshes in: 20s", this);
-    timerLabel_->setStyleSheet("font-size: 14px; font-weight: 600; color: #eb0000;");
+    AppStyle::setRole(timerLabel_, "timer");
     timerLabel_->setAlignment(Qt::AlignCenter);
     timerLabel_->setVisible(false);
     mainLayout->addWidget(timerLabel_);
@@ -36,7 +90,7 @@ IdentificationToken::IdentificationToken(QWidget* parent)
 
     // QR Code container
     auto qrContainer = new QWidget(this);
-    qrContainer->setStyleSheet("background-color: white; border-radius: 12px;");
+    AppStyle::setRole(qrContainer, "card");
     qrContainer->setMaximumSize(360, 360);
     
     auto qrLayout = new QVBoxLayout(qrContainer);
@@ -46,7 +100,7 @@ IdentificationToken::IdentificationToken(QWidget* parent)
     // QR Code image
     qrImageLabel_ = new QLabel(qrContainer);
     qrImageLabel_->setAlignment(Qt::AlignCenter);
-    qrImageLabel_->setStyleSheet("background-color: white; padding: 10px;");
+    AppStyle::setRole(qrImageLabel_, "qrCode");
     qrImageLabel_->setFixedSize(320, 320);
     qrLayout->addWidget(qrImageLabel_, 0, Qt::AlignCenter);
 
@@ -65,7 +119,7 @@ IdentificationToken::IdentificationToken(QWidget* parent)
         "to verify your identity and ticket ownership.",
         this
     );
-    instructionLabel_->setStyleSheet("font-size: 13px; color: #666;");
+    AppStyle::setRole(instructionLabel_, "hint");
     instructionLabel_->setAlignment(Qt::AlignCenter);
     instructionLabel_->setWordWrap(true);
     mainLayout->addWidget(instructionLabel_);
@@ -75,19 +129,20 @@ IdentificationToken::IdentificationToken(QWidget* parent)
     // Download button
     downloadButton_ = new QPushButton("Download PIT QR Code", this);
     downloadButton_->setFixedSize(200, 40);
-    downloadButton_->setStyleSheet(
-        "QPushButton { "
-        "  background-color: #3498db; color: white; font-weight: bold; "
-        "  font-size: 14px; border: none; border-radius: 6px; "
-        "} "
-        "QPushButton:hover { background-color: #2980b9; } "
-        "QPushButton:pressed { background-color: #21618c; }"
-    );
+    AppStyle::setRole(downloadButton_, "accent");
     connect(downloadButton_, &QPushButton::clicked, this, &IdentificationToken::downloadPIT);
     
+    // Hand the code to a running inspector without saving it (--both / --handoff)
+    handoffButton_ = new QPushButton("Show to Inspector", this);
+    handoffButton_->setFixedSize(200, 40);
+    AppStyle::setRole(handoffButton_, "accent");
+    handoffButton_->setVisible(ScanHandoff::isEnabled());
+    connect(handoffButton_, &QPushButton::clicked, this, &IdentificationToken::showToInspector);
+    
     auto downloadLayout = new QHBoxLayout();
     downloadLayout->addStretch();
     downloadLayout->addWidget(downloadButton_);
+    downloadLayout->addWidget(handoffButton_);
     downloadLayout->addStretch();
     mainLayout->addLayout(downloadLayout);
 
@@ -102,22 +157,105 @@ IdentificationToken::IdentificationToken(QWidget* parent)
     refreshTimer_ = new QTimer(this);
     refreshTimer_->setSingleShot(true);
     connect(refreshTimer_, &QTimer::timeout, this, &IdentificationToken::refreshQRCode);
+    
+    // Pre-sign bursts run here, one after another
+    precomputeWorker_ = new QObject();
+    precomputeWorker_->moveToThread(&precomputeThread_);
+    connect(&precomputeThread_, &QThread::finished, precomputeWorker_, &QObject::deleteLater);
+    precomputeThread_.start();
+}
+
+IdentificationToken::~IdentificationToken()
+{
+    // A cancelled burst stops after the signature in progress
+    cancelPrecompute();
+    precomputeThread_.quit();
+    precomputeThread_.wait();
+}
+
+int IdentificationToken::pitWindowSeconds()
+{
+    const int64_t maxAge = TicketOwnership::pitValidityPolicy().maxAgeSeconds;
+    return static_cast<int>(std::clamp<int64_t>(maxAge / 2, 1, 3600));
 }
 
-void IdentificationToken::setIdentificationToken(const QString& publicKey, const QString& privateKey)
+void IdentificationToken::setPrecomputeHorizon(int seconds)
 {
+    g_precomputeHorizon = std::max(seconds, 0);
+}
+
+void IdentificationToken::setIdentificationToken(const QString& publicKey, std::shared_ptr<const SigningKey> signingKey)
+{
+    // A burst for the previous login must not keep signing with its key
+    cancelPrecompute();
     publicKey_ = publicKey;
-    privateKey_ = privateKey;
+    signingKey_ = std::move(signingKey);
+    signingMutex_ = std::make_shared<std::mutex>();
+    windowCache_.reset();
+    
+    // Pre-sign the upcoming time windows in one background burst
+    if (g_precomputeHorizon > 0) {
+        windowCache_ = std::make_shared<PitWindowCache>(pitWindowSeconds());
+        startPrecompute();
+    }
     
     // Generate initial QR code
     generateQRCodeWithTimestamp();
     
     // Show timer label and start countdown
     timerLabel_->setVisible(true);
-    countdown_ = 20;
+    int refreshMs = nextRefreshMs();
+    countdown_ = (refreshMs + 999) / 1000;
     timerLabel_->setText(QString("Refreshes in: %1s").arg(countdown_));
     countdownTimer_->start(1000); // Update every second
-    refreshTimer_->start(20000); // Refresh after 20 seconds
+    refreshTimer_->start(refreshMs);
+}
+
+void IdentificationToken::startPrecompute()
+{
+    // The burst owns everything it touches, so it can outlive a logout
+    std::shared_ptr<PitWindowCache> cache = windowCache_;
+    std::shared_ptr<const SigningKey> key = signingKey_;
+    std::shared_ptr<std::mutex> signingMutex = signingMutex_;
+    QString publicKey = publicKey_;
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    int horizon = g_precomputeHorizon;
+    
+    cancelPrecompute();
+    burst_ = std::make_shared<PrecomputeBurst>();
+    std::shared_ptr<PrecomputeBurst> burst = burst_;
+    
+    QMetaObject::invokeMethod(precomputeWorker_, [cache, key, signingMutex, publicKey, now, horizon, burst]() {
+        // Runs on the precompute thread
+        std::vector<uint8_t> buffer;
+        try {
+            cache->fill(now, horizon, [&](int64_t windowStart) {
+                std::lock_guard<std::mutex> lock(*signingMutex);
+                return signedPIT(*key, publicKey, windowStart, buffer).toStdString();
+            }, &burst->cancelled);
+        } catch (const std::exception& e) {
+            qWarning() << "Failed to pre-sign PIT windows:" << e.what();
+        }
+        burst->finished = true;
+    }, Qt::QueuedConnection);
+}
+
+void IdentificationToken::cancelPrecompute()
+{
+    if (burst_) {
+        burst_->cancelled = true;
+        burst_.reset();
+    }
+}
+
+int IdentificationToken::nextRefreshMs() const
+{
+    qint64 windowMs = qint64(pitWindowSeconds()) * 1000;
+    if (!windowCache_) {
+        return static_cast<int>(windowMs);
+    }
+    // Refresh exactly at the next window boundary
+    return static_cast<int>(windowMs - QDateTime::currentMSecsSinceEpoch() % windowMs);
 }
 
 void IdentificationToken::generateQRCodeWithTimestamp()
@@ -126,145 +264,32 @@ void IdentificationToken::generateQRCodeWithTimestamp()
         // Get current Unix timestamp
         qint64 timestamp = QDateTime::currentSecsSinceEpoch();
         
-        // Create data to sign: publicKey + timestamp (anonymous, no email)
-        QString dataToSign = publicKey_ + QString::number(timestamp);
-        
-        // Create temporary FFI context to import keys and sign
-        rnp_ffi_t ffi = nullptr;
-        if (rnp_ffi_create(&ffi, "GPG", "GPG") != RNP_SUCCESS || !ffi) {
-            throw std::runtime_error("Failed to create RNP FFI for signing");
-        }
-        
-        // Import the secret key
-        rnp_input_t key_input = nullptr;
-        QByteArray privateKeyBytes = privateKey_.toUtf8();
-        if (rnp_input_from_memory(&key_input, 
-                                  reinterpret_cast<const uint8_t*>(privateKeyBytes.constData()),
-                                  privateKeyBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to create input for private key");
-        }
-        
-        if (rnp_import_keys(ffi, key_input, RNP_LOAD_SAVE_SECRET_KEYS, nullptr) != RNP_SUCCESS) {
-            rnp_input_destroy(key_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to import private key");
-        }
-        rnp_input_destroy(key_input);
-        
-        // Sign the data
-        QByteArray dataBytes = dataToSign.toUtf8();
-        rnp_input_t data_input = nullptr;
-        if (rnp_input_from_memory(&data_input,
-                                  reinterpret_cast<const uint8_t*>(dataBytes.constData()),
-                                  dataBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to create input for data");
-        }
-        
-        rnp_output_t sig_output = nullptr;
-        if (rnp_output_to_memory(&sig_output, 0) != RNP_SUCCESS) {
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to create output for signature");
-        }
-        
-        // Create signing operation
-        rnp_op_sign_t sign_op = nullptr;
-        if (rnp_op_sign_detached_create(&sign_op, ffi, data_input, sig_output) != RNP_SUCCESS) {
-            rnp_output_destroy(sig_output);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to create signing operation");
-        }
-        
-        // Get the key handle for signing (first key in keyring)
-        rnp_identifier_iterator_t it = nullptr;
-        if (rnp_identifier_iterator_create(ffi, &it, "grip") != RNP_SUCCESS) {
-            rnp_op_sign_destroy(sign_op);
-            rnp_output_destroy(sig_output);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to create key iterator");
+        if (!signingKey_) {
+            throw std::runtime_error("No signing key unlocked");
         }
         
-        const char* grip = nullptr;
-        rnp_key_handle_t key = nullptr;
-        if (rnp_identifier_iterator_next(it, &grip) == RNP_SUCCESS && grip) {
-            if (rnp_locate_key(ffi, "grip", grip, &key) != RNP_SUCCESS || !key) {
-                rnp_identifier_iterator_destroy(it);
-                rnp_op_sign_destroy(sign_op);
-                rnp_output_destroy(sig_output);
-                rnp_input_destroy(data_input);
-                rnp_ffi_destroy(ffi);
-                throw std::runtime_error("Failed to locate key for signing");
+        QString tokenData;
+        if (windowCache_) {
+            // Showing a pre-signed PIT is a lookup
+            if (std::optional<std::string> cached = windowCache_->lookup(timestamp)) {
+                tokenData = QString::fromStdString(*cached);
             }
         }
-        rnp_identifier_iterator_destroy(it);
         
-        if (!key) {
-            rnp_op_sign_destroy(sign_op);
-            rnp_output_destroy(sig_output);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("No key found for signing");
+        if (tokenData.isEmpty()) {
+            // Sign live (no pre-signed window yet, or precompute disabled). A
+            // running burst holds the key for at most one signature at a time.
+            std::lock_guard<std::mutex> lock(*signingMutex_);
+            tokenData = signedPIT(*signingKey_, publicKey_, timestamp, signatureBuffer_);
         }
         
-        // Add signer
-        if (rnp_op_sign_add_signature(sign_op, key, nullptr) != RNP_SUCCESS) {
-            rnp_key_handle_destroy(key);
-            rnp_op_sign_destroy(sign_op);
-            rnp_output_destroy(sig_output);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to add signer");
-        }
-        
-        // Execute signing
-        if (rnp_op_sign_execute(sign_op) != RNP_SUCCESS) {
-            rnp_key_handle_destroy(key);
-            rnp_op_sign_destroy(sign_op);
-            rnp_output_destroy(sig_output);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Signing operation failed");
-        }
-        
-        // Get signature
-        uint8_t* sig_buf = nullptr;
-        size_t sig_len = 0;
-        if (rnp_output_memory_get_buf(sig_output, &sig_buf, &sig_len, false) != RNP_SUCCESS) {
-            rnp_key_handle_destroy(key);
-            rnp_op_sign_destroy(sign_op);
-            rnp_output_destroy(sig_output);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            throw std::runtime_error("Failed to get signature buffer");
+        // Top up in the background once half of the horizon has been used
+        if (windowCache_ && windowCache_->coveredUntil() - timestamp < g_precomputeHorizon / 2) {
+            if (!burst_ || burst_->finished) {
+                startPrecompute();
+            }
         }
         
-        QByteArray signature(reinterpret_cast<const char*>(sig_buf), sig_len);
-        QString signatureHex = signature.toHex();
-        
-        // Cleanup
-        rnp_key_handle_destroy(key);
-        rnp_op_sign_destroy(sign_op);
-        rnp_output_destroy(sig_output);
-        rnp_input_destroy(data_input);
-        rnp_ffi_destroy(ffi);
-        
-        // Create public key hash (first 16 chars of SHA-256 for brevity in QR)
-        QByteArray publicKeyBytes = publicKey_.toUtf8();
-        QByteArray hash = QCryptographicHash::hash(publicKeyBytes, QCryptographicHash::Sha256);
-        QString publicKeyHash = hash.toHex().left(16);
-        
-        // Create anonymous token format: PIT:pubKeyHash:timestamp:signature
-        QString tokenData = QString("PIT:%1:%2:%3")
-            .arg(publicKeyHash)
-            .arg(timestamp)
-            .arg(signatureHex);
-        
         // Generate QR code from the signed token
         QImage qrImage = QRCodeGenerator::generateQRCode(tokenData, 280);
         QPixmap qrPixmap = QPixmap::fromImage(qrImage);
@@ -289,7 +314,7 @@ void IdentificationToken::updateCountdown()
 {
     countdown_--;
     if (countdown_ <= 0) {
-        countdown_ = 20;
+        countdown_ = pitWindowSeconds();
     }
     timerLabel_->setText(QString("Refreshes in: %1s").arg(countdown_));
 }
@@ -300,20 +325,38 @@ void IdentificationToken::refreshQRCode()
     generateQRCodeWithTimestamp();
     
     // Reset countdown and restart timer
-    countdown_ = 20;
+    int refreshMs = nextRefreshMs();
+    countdown_ = (refreshMs + 999) / 1000;
     timerLabel_->setText(QString("Refreshes in: %1s").arg(countdown_));
-    refreshTimer_->start(20000); // Schedule next refresh
+    refreshTimer_->start(refreshMs); // Schedule next refresh
 }
 
 void IdentificationToken::clear()
 {
+    cancelPrecompute();
     publicKey_.clear();
-    privateKey_.clear();
+    signingKey_.reset();
+    windowCache_.reset();
+    signatureBuffer_.clear();
     qrImageLabel_->clear();
     timerLabel_->setVisible(false);
     countdownTimer_->stop();
     refreshTimer_->stop();
-    countdown_ = 20;
+    countdown_ = pitWindowSeconds();
+}
+
+void IdentificationToken::showToInspector()
+{
+    if (qrImageLabel_->pixmap().isNull()) {
+        QMessageBox::warning(this, "No QR Code", "Please generate your PIT first by logging in.");
+        return;
+    }
+    
+    ScanHandoff::sendFrame(qrImageLabel_->pixmap().toImage(), this, [this](bool sent) {
+        if (!sent) {
+            QMessageBox::warning(this, "Inspector", "Could not reach the inspector. Is it running?");
+        }
+    });
 }
 
 void IdentificationToken::downloadPIT()
@@ -0,0 +1,31 @@
+#include "keyDirectory.h"
+#include <QStandardPaths>
+#include <QDir>
+
+PublicKeyDirectory& sharedKeyDirectory()
+{
+    static PublicKeyDirectory directory(
+        QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+            .filePath("keys")
+            .toStdString());
+    return directory;
+}
+
+KeyStore& sharedKeyStore()
+{
+    static KeyStore store(
+        QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+            .filePath("keystore")
+            .toStdString());
+    return store;
+}
+
+IssuedTicketLog& sharedIssuedTicketLog()
+{
+    static IssuedTicketLog log([] {
+        QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+        dir.mkpath(".");
+        return dir.filePath("issued-tickets.csv").toStdString();
+    }());
+    return log;
+}
@@ -0,0 +1,225 @@
+#include "liveScanSource.h"
+#include "qrCodeDecoder.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDebug>
+
+LiveScanSource::LiveScanSource(QObject* parent)
+    : QObject(parent)
+{
+    // Decoding runs on its own thread so zbarimg never blocks the inspector UI
+    worker_ = new QObject();
+    worker_->moveToThread(&workerThread_);
+    connect(&workerThread_, &QThread::finished, worker_, &QObject::deleteLater);
+    workerThread_.start();
+}
+
+LiveScanSource::~LiveScanSource()
+{
+    stop();
+    workerThread_.quit();
+    workerThread_.wait();
+}
+
+QStringList LiveScanSource::frameFilters()
+{
+    return QStringList() << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp";
+}
+
+bool LiveScanSource::isDeviceSource(const QString& source)
+{
+    return source.startsWith("/dev/video");
+}
+
+bool LiveScanSource::start(const QString& source)
+{
+    stop();
+
+    source_ = source;
+    framesDecoded_ = 0;
+    framesDropped_ = 0;
+
+    running_ = isDeviceSource(source) ? startDevice(source) : startDirectory(source);
+    return running_;
+}
+
+void LiveScanSource::stop()
+{
+    running_ = false;
+    pendingFrame_.clear();
+
+    if (watcher_) {
+        watcher_->deleteLater();
+        watcher_ = nullptr;
+    }
+
+    if (scanner_) {
+        scanner_->disconnect(this);
+        scanner_->kill();
+        scanner_->waitForFinished(1000);
+        scanner_->deleteLater();
+        scanner_ = nullptr;
+    }
+}
+
+bool LiveScanSource::startDirectory(const QString& directory)
+{
+    QDir dir(directory);
+    if (!dir.exists()) {
+        emit sourceError(QString("Scan directory does not exist: %1").arg(directory));
+        return false;
+    }
+
+    // Frames already present when scanning starts are ignored
+    seenFrames_.clear();
+    for (const QString& name : dir.entryList(frameFilters(), QDir::Files)) {
+        seenFrames_.insert(name);
+    }
+
+    watcher_ = new QFileSystemWatcher(QStringList() << dir.absolutePath(), this);
+    connect(watcher_, &QFileSystemWatcher::directoryChanged, this, &LiveScanSource::onDirectoryChanged);
+
+    qDebug() << "Live scan watching directory" << dir.absolutePath();
+    return true;
+}
+
+bool LiveScanSource::startDevice(const QString& device)
+{
+    // zbarcam reads the V4L2 device itself and prints one payload per line
+    scanner_ = new QProcess(this);
+    connect(scanner_, &QProcess::readyReadStandardOutput, this, &LiveScanSource::onScannerOutput);
+    connect(scanner_, qOverload<int, QProcess::ExitStatus>(&QProcess::finished),
+            this, &LiveScanSource::onScannerFinished);
+
+    scanner_->start("zbarcam", QStringList() << "--quiet" << "--raw" << "--nodisplay"
+                                             << "-Sdisable" << "-Sqrcode.enable" << device);
+    if (!scanner_->waitForStarted(3000)) {
+        emit sourceError("Failed to start zbarcam - is zbar installed?");
+        scanner_->deleteLater();
+        scanner_ = nullptr;
+        return false;
+    }
+
+    qDebug() << "Live scan reading from device" << device;
+    return true;
+}
+
+void LiveScanSource::onDirectoryChanged(const QString& path)
+{
+    if (!running_) {
+        return;
+    }
+
+    const QFileInfoList frames = QDir(path).entryInfoList(frameFilters(), QDir::Files);
+
+    // New frames are the names not seen before; several can share one mtime
+    // tick, so the newest is the latest (mtime, name), and anything older is stale
+    QFileInfo newest;
+    int newFrames = 0;
+    QSet<QString> present;
+    for (const QFileInfo& frame : frames) {
+        present.insert(frame.fileName());
+        if (seenFrames_.contains(frame.fileName())) {
+            continue;
+        }
+        ++newFrames;
+        if (newFrames == 1 || frame.lastModified() > newest.lastModified()
+            || (frame.lastModified() == newest.lastModified() && frame.fileName() > newest.fileName())) {
+            newest = frame;
+        }
+    }
+    // Forget deleted frames so the set stays as small as the directory
+    seenFrames_ = present;
+
+    if (newFrames == 0) {
+        return;
+    }
+    framesDropped_ += newFrames - 1;
+
+    if (workerBusy_) {
+        if (!pendingFrame_.isEmpty()) {
+            ++framesDropped_;
+        }
+        pendingFrame_ = newest.absoluteFilePath();
+        return;
+    }
+
+    dispatchFrame(newest.absoluteFilePath());
+}
+
+void LiveScanSource::dispatchFrame(const QString& framePath)
+{
+    workerBusy_ = true;
+
+    QMetaObject::invokeMethod(worker_, [this, framePath]() {
+        // Runs on the worker thread
+        QElapsedTimer timer;
+        timer.start();
+        QStringList payloads = QRCodeDecoder::decodeAllFromFile(framePath, 2000);
+        const qint64 decodeMicros = timer.nsecsElapsed() / 1000;
+
+        QImage preview;
+        qint64 loadMicros = 0;
+        if (!payloads.isEmpty()) {
+            timer.restart();
+            QImage frame(framePath);
+            if (!frame.isNull()) {
+                preview = frame.scaled(PREVIEW_SIZE, PREVIEW_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
+            loadMicros = timer.nsecsElapsed() / 1000;
+        }
+
+        QMetaObject::invokeMethod(this, [this, payloads, preview, decodeMicros, loadMicros]() {
+            onFrameDecoded(payloads, preview, decodeMicros, loadMicros);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void LiveScanSource::onFrameDecoded(const QStringList& payloads, const QImage& preview, qint64 decodeMicros,
+                                    qint64 loadMicros)
+{
+    workerBusy_ = false;
+
+    if (!running_) {
+        return;
+    }
+
+    if (!payloads.isEmpty()) {
+        ++framesDecoded_;
+        // The frame was decoded once, so only its first code carries the cost
+        for (const QString& payload : payloads) {
+            emit codeDecoded(payload, preview, decodeMicros, loadMicros);
+            decodeMicros = 0;
+            loadMicros = 0;
+        }
+    }
+
+    // Pick up the newest frame that arrived while we were busy
+    if (!pendingFrame_.isEmpty()) {
+        QString next = pendingFrame_;
+        pendingFrame_.clear();
+        dispatchFrame(next);
+    }
+}
+
+void LiveScanSource::onScannerOutput()
+{
+    while (scanner_ && scanner_->canReadLine()) {
+        QString payload = QString::fromUtf8(scanner_->readLine()).trimmed();
+        if (!payload.isEmpty() && running_) {
+            ++framesDecoded_;
+            emit codeDecoded(payload, QImage(), 0, 0);
+        }
+    }
+}
+
+void LiveScanSource::onScannerFinished(int exitCode, QProcess::ExitStatus status)
+{
+    if (running_) {
+        running_ = false;
+        emit sourceError(QString("zbarcam stopped (exit code %1%2)")
+                             .arg(exitCode)
+                             .arg(status == QProcess::CrashExit ? ", crashed" : ""));
+    }
+}
@@ -1,14 +1,76 @@
 #include "logInPage.h"
-#include "PgpKeyManager.h"
+#include "appStyle.h"
+#include "iconCache.h"
+#include "keyDirectory.h"
+#include "SigningKey.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QCryptographicHash>
 #include <QMessageBox>
+#include <QHash>
+#include <QDebug>
+#include <QMetaObject>
+#include <algorithm>
+#include <memory>
+#include <optional>
+
+namespace {
+KeyDerivation::Params g_kdfParams;
+
+// Keys unlocked this session, so logging in again skips the KDF.
+// Keyed by a hash of the credentials; held in memory only.
+QHash<QByteArray, std::shared_ptr<const SigningKey>> g_unlockedKeys;
+
+// Unlock the stored key; on first login derive it and store it encrypted.
+// Same credentials always derive the same Ed25519 seed, and the key built
+// from it is byte-for-byte stable, so its hash is too. Runs on the login
+// worker thread; throws on failure.
+std::shared_ptr<const SigningKey> unlockSigningKey(const QString& email, const QString& userId, const QString& password,
+                                                   const KeyDerivation::Params& params)
+{
+    QByteArray emailBytes = email.toUtf8();
+    QByteArray passwordBytes = password.toUtf8();
+    std::string_view emailView(emailBytes.constData(), emailBytes.size());
+    std::string_view passwordView(passwordBytes.constData(), passwordBytes.size());
+
+    std::optional<SecureBuffer> seed = sharedKeyStore().unlock(emailView, passwordView);
+    if (!seed) {
+        KeyDerivation::Seed derived = KeyDerivation::deriveSeed(emailView, passwordView, params);
+        seed.emplace(derived.size());
+        std::copy(derived.begin(), derived.end(), seed->data());
+        derived.fill(0);
+
+        try {
+            sharedKeyStore().store(emailView, passwordView, *seed, params);
+        } catch (const std::exception& e) {
+            qWarning() << "Failed to store key in keystore:" << e.what();
+        }
+    }
+    passwordBytes.fill('\0');
+
+    // Import the key into rnp once (no key generation); the handle
+    // signs for the rest of the session
+    return std::make_shared<const SigningKey>(SigningKey::fromSeed(std::move(*seed), userId.toStdString()));
+}
+}
+
+void LoginPage::setKeyDerivationParams(const KeyDerivation::Params& params)
+{
+    g_kdfParams = params;
+    g_unlockedKeys.clear();
+}
 
 LoginPage::LoginPage(QWidget* parent)
     : QWidget(parent)
 {
-    setStyleSheet("background-color: #f5f5f5;");
+    // Keys are unlocked on their own thread so the KDF never blocks the UI
+    worker_ = new QObject();
+    worker_->moveToThread(&workerThread_);
+    connect(&workerThread_, &QThread::finished, worker_, &QObject::deleteLater);
+    workerThread_.start();
+
+    AppStyle::setRole(this, "page");
+    setAttribute(Qt::WA_StyledBackground);
 
     auto mainLayout = new QVBoxLayout(this);
     mainLayout->setContentsMargins(0, 0, 0, 0);
@@ -16,7 +78,7 @@ LoginPage::LoginPage(QWidget* parent)
 
     // Add SBB header with logo
     auto headerWidget = new QWidget(this);
-    headerWidget->setStyleSheet("background-color: #eb0000;");
+    AppStyle::setRole(headerWidget, "header");
     headerWidget->setFixedHeight(80);
     auto headerLayout = new QHBoxLayout(headerWidget);
     headerLayout->setContentsMargins(20, 15, 20, 15);
@@ -25,11 +87,8 @@ LoginPage::LoginPage(QWidget* parent)
     auto logoLabel = new QLabel(headerWidget);
     logoLabel->setAlignment(Qt::AlignCenter);
     logoLabel->setFixedSize(50, 50);
-    logoLabel->setStyleSheet("background: transparent; border: none; padding: 0;");
-    QPixmap logoPix("icons/SBB_logo.svg");
-    if (!logoPix.isNull()) {
-        logoLabel->setPixmap(logoPix.scaled(logoLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    }
+    AppStyle::setRole(logoLabel, "logo");
+    logoLabel->setPixmap(IconCache::pixmap("SBB_logo.svg", logoLabel->size()));
     headerLayout->addWidget(logoLabel);
     headerLayout->addStretch();
     
@@ -37,7 +96,7 @@ LoginPage::LoginPage(QWidget* parent)
 
     // Content area
     auto contentWidget = new QWidget(this);
-    contentWidget->setStyleSheet("background-color: #f5f5f5;");
+    AppStyle::setRole(contentWidget, "page");
     auto contentLayout = new QVBoxLayout(contentWidget);
     contentLayout->setContentsMargins(40, 40, 40, 40);
     contentLayout->setSpacing(20);
@@ -46,12 +105,12 @@ LoginPage::LoginPage(QWidget* parent)
 
     // Title
     auto titleLabel = new QLabel("Welcome Back", contentWidget);
-    titleLabel->setStyleSheet("font-size: 28px; font-weight: 600; color: #333;");
+    AppStyle::setRole(titleLabel, "title");
     titleLabel->setAlignment(Qt::AlignCenter);
     contentLayout->addWidget(titleLabel);
 
     auto subtitleLabel = new QLabel("Log in to access your tickets", contentWidget);
-    subtitleLabel->setStyleSheet("font-size: 14px; color: #666;");
+    AppStyle::setRole(subtitleLabel, "subtitle");
     subtitleLabel->setAlignment(Qt::AlignCenter);
     contentLayout->addWidget(subtitleLabel);
 
@@ -59,7 +118,7 @@ LoginPage::LoginPage(QWidget* parent)
 
     // Login container
     auto loginContainer = new QWidget(contentWidget);
-    loginContainer->setStyleSheet("background-color: white; border-radius: 12px; border: 1px solid #e0e0e0;");
+    AppStyle::setRole(loginContainer, "panel");
     loginContainer->setMaximumWidth(500);
     
     auto containerLayout = new QVBoxLayout(loginContainer);
@@ -68,61 +127,37 @@ LoginPage::LoginPage(QWidget* parent)
 
     // Email
     auto emailLabel = new QLabel("Email:", loginContainer);
-    emailLabel->setStyleSheet("font-weight: 600; font-size: 13px; color: #333; border: none; background: transparent;");
+    AppStyle::setRole(emailLabel, "fieldLabel");
     emailEdit_ = new QLineEdit(loginContainer);
     emailEdit_->setPlaceholderText("Enter your email");
     emailEdit_->setMinimumHeight(44);
-    emailEdit_->setStyleSheet(
-        "QLineEdit { "
-        "  padding: 12px 16px; border: 2px solid #e0e0e0; border-radius: 8px; "
-        "  font-size: 14px; color: #000; background-color: #fafafa; "
-        "} "
-        "QLineEdit:focus { "
-        "  border-color: #eb0000; background-color: white; "
-        "}"
-    );
+    AppStyle::setRole(emailEdit_, "field");
+    emailEdit_->setProperty("variant", "large");
 
     // Password
     auto passwordLabel = new QLabel("Password:", loginContainer);
-    passwordLabel->setStyleSheet("font-weight: 600; font-size: 13px; color: #333; border: none; background: transparent;");
+    AppStyle::setRole(passwordLabel, "fieldLabel");
     passwordEdit_ = new QLineEdit(loginContainer);
     passwordEdit_->setPlaceholderText("Enter your password");
     passwordEdit_->setEchoMode(QLineEdit::Password);
     passwordEdit_->setMinimumHeight(44);
     passwordEdit_->setMinimumWidth(280);
-    passwordEdit_->setStyleSheet(
-        "QLineEdit { "
-        "  padding: 12px 16px; border: 2px solid #e0e0e0; border-radius: 8px; "
-        "  font-size: 14px; color: #000; background-color: #fafafa; "
-        "} "
-        "QLineEdit:focus { "
-        "  border-color: #eb0000; background-color: white; "
-        "}"
-    );
+    AppStyle::setRole(passwordEdit_, "field");
+    passwordEdit_->setProperty("variant", "large");
 
     // Status label
     statusLabel_ = new QLabel("", loginContainer);
     statusLabel_->setAlignment(Qt::AlignCenter);
     statusLabel_->setWordWrap(true);
-    statusLabel_->setStyleSheet("font-size: 13px; min-height: 20px;");
+    statusLabel_->setMinimumHeight(20);
+    AppStyle::setRole(statusLabel_, "status");
     statusLabel_->hide();
 
     // Login button
     loginButton_ = new QPushButton("Login", loginContainer);
     loginButton_->setMinimumHeight(50);
     loginButton_->setCursor(Qt::PointingHandCursor);
-    loginButton_->setStyleSheet(
-        "QPushButton { "
-        "  background-color: #eb0000; color: white; font-weight: 600; "
-        "  font-size: 15px; border: none; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { "
-        "  background-color: #c00000; "
-        "} "
-        "QPushButton:pressed { "
-        "  background-color: #a00000; "
-        "}"
-    );
+    AppStyle::setRole(loginButton_, "primary");
 
     connect(loginButton_, &QPushButton::clicked, this, &LoginPage::handleLogin);
     connect(passwordEdit_, &QLineEdit::returnPressed, this, &LoginPage::handleLogin);
@@ -147,6 +182,13 @@ LoginPage::LoginPage(QWidget* parent)
     mainLayout->addWidget(contentWidget);
 }
 
+LoginPage::~LoginPage()
+{
+    // A running unlock is bounded by the KDF cost
+    workerThread_.quit();
+    workerThread_.wait();
+}
+
 void LoginPage::handleLogin()
 {
     QString email = emailEdit_->text().trimmed();
@@ -166,41 +208,67 @@ void LoginPage::handleLogin()
         return;
     }
 
+    // Guards against a second Enter while the keys are still being unlocked
+    if (loginPending_) {
+        return;
+    }
+
     // Show loading state
     loginButton_->setEnabled(false);
-    loginButton_->setText("Generating Keys...");
-    showStatus("Generating PGP keys, please wait...", false);
+    loginButton_->setText("Unlocking Keys...");
+    showStatus("Unlocking your keys, please wait...", false);
 
-    try {
-        // Create deterministic user ID from email + password hash
-        // This ensures same credentials always generate same keys
-        QByteArray combined = (email + password).toUtf8();
-        QByteArray hash = QCryptographicHash::hash(combined, QCryptographicHash::Sha256);
-        QString deterministicId = email + "_" + hash.toHex().left(16);
+    QString userId = email.toLower();
+    QByteArray cacheKey = QCryptographicHash::hash(
+        (userId + QChar(0) + password).toUtf8(), QCryptographicHash::Sha256);
 
-        // Generate PGP keys using PgpKeyManager
-        PgpKeyManager keyManager(deterministicId.toStdString());
-
-        // Export keys
-        QString publicKey = QString::fromStdString(keyManager.exportPublicKeyArmored());
-        QString privateKey = QString::fromStdString(keyManager.exportSecretKeyArmored());
-
-        // Create account info
-        AccountInfo account(email, publicKey, privateKey);
-
-        // Clear password field for security
-        passwordEdit_->clear();
+    if (std::shared_ptr<const SigningKey> signingKey = g_unlockedKeys.value(cacheKey)) {
+        finishLogin(email, cacheKey, signingKey, QString());
+        return;
+    }
 
-        showStatus("Login successful!", false);
+    // The keystore unlock and, on first login, the KDF take long enough
+    // (scrypt is tuned to ~100 ms, more with --kdf-cost) to freeze the window
+    loginPending_ = true;
+    const KeyDerivation::Params params = g_kdfParams;
+    QMetaObject::invokeMethod(worker_, [this, email, userId, password, cacheKey, params]() {
+        // Runs on the worker thread
+        std::shared_ptr<const SigningKey> signingKey;
+        QString error;
+        try {
+            signingKey = unlockSigningKey(email, userId, password, params);
+        } catch (const std::exception& e) {
+            error = QString::fromUtf8(e.what());
+        }
 
-        // Emit signal with account info
-        emit loginSuccessful(account);
+        QMetaObject::invokeMethod(this, [this, email, cacheKey, signingKey, error]() {
+            loginPending_ = false;
+            finishLogin(email, cacheKey, signingKey, error);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
 
-    } catch (const std::exception& e) {
-        showStatus(QString("Key generation failed: %1").arg(e.what()), true);
+void LoginPage::finishLogin(const QString& email, const QByteArray& cacheKey,
+                            const std::shared_ptr<const SigningKey>& signingKey, const QString& error)
+{
+    if (!signingKey) {
+        showStatus(QString("Login failed: %1").arg(error), true);
         loginButton_->setEnabled(true);
         loginButton_->setText("Login");
+        return;
     }
+    g_unlockedKeys.insert(cacheKey, signingKey);
+
+    // Create account info
+    AccountInfo account(email, QString::fromStdString(signingKey->publicKeyArmored()), signingKey);
+
+    // Clear password field for security
+    passwordEdit_->clear();
+
+    showStatus("Login successful!", false);
+
+    // Emit signal with account info
+    emit loginSuccessful(account);
 }
 
 void LoginPage::showStatus(const QString& message, bool isError)
@@ -209,10 +277,7 @@ void LoginPage::showStatus(const QString& message, bool isError)
         statusLabel_->hide();
     } else {
         statusLabel_->setText(message);
-        statusLabel_->setStyleSheet(
-            QString("font-size: 12px; min-height: 20px; color: %1;")
-                .arg(isError ? "#d32f2f" : "#388e3c")
-        );
+        AppStyle::setState(statusLabel_, "state", isError ? "error" : "ok");
         statusLabel_->show();
     }
 }
\ No newline at end of file
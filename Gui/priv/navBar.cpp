@@ -1,4 +1,6 @@
 #include "navBar.h"
+#include "appStyle.h"
+#include "iconCache.h"
 #include <QPushButton>
 #include <QHBoxLayout>
 
@@ -10,30 +12,16 @@ NavBar::NavBar(QWidget* parent)
     : QWidget(parent)
 {
     // White background with top border
-    setStyleSheet("background-color: white; border-top: 1px solid #e0e0e0;");
+    AppStyle::setRole(this, "navBar");
+    setAttribute(Qt::WA_StyledBackground);
 
-    homeButton_ = new QPushButton(QIcon(QString("Icons/magnifying-glass_24px.png")), QString{}, this);
-    ticketButton_ = new QPushButton(QIcon("Icons/ticket_24px.png"), QString{}, this);
-    idButton_ = new QPushButton(QIcon("Icons/user_24px.png"), QString{}, this);
+    homeButton_ = new QPushButton(QIcon(IconCache::pixmap("magnifying-glass_24px.png", QSize(24, 24))), QString{}, this);
+    ticketButton_ = new QPushButton(QIcon(IconCache::pixmap("ticket_24px.png", QSize(24, 24))), QString{}, this);
+    idButton_ = new QPushButton(QIcon(IconCache::pixmap("user_24px.png", QSize(24, 24))), QString{}, this);
 
-    // Modern button styling with better sizing
-    QString buttonStyle = 
-        "QPushButton { "
-        "  background-color: transparent; "
-        "  border: none; "
-        "  border-radius: 8px; "
-        "  padding: 8px; "
-        "} "
-        "QPushButton:hover { "
-        "  background-color: #f5f5f5; "
-        "} "
-        "QPushButton:pressed { "
-        "  background-color: #e0e0e0; "
-        "}";
-    
-    homeButton_->setStyleSheet(buttonStyle);
-    ticketButton_->setStyleSheet(buttonStyle);
-    idButton_->setStyleSheet(buttonStyle);
+    AppStyle::setRole(homeButton_, "nav");
+    AppStyle::setRole(ticketButton_, "nav");
+    AppStyle::setRole(idButton_, "nav");
     
     homeButton_->setFixedSize(60, 50);
     ticketButton_->setFixedSize(60, 50);
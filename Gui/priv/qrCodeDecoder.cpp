@@ -0,0 +1,94 @@
+#include "qrCodeDecoder.h"
+#include <QBuffer>
+#include <QImage>
+#include <QProcess>
+#include <QDebug>
+
+// Decoding is delegated to zbarimg, which must be installed:
+// brew install zbar (macOS) or apt install zbar-tools (Linux)
+
+namespace {
+
+// Run zbarimg on image (a path, or "-" to read stdinData)
+QStringList runZbarimg(const QString& image, const QByteArray& stdinData, int timeoutMs)
+{
+    QProcess process;
+    process.start("zbarimg", QStringList() << "--quiet" << "--raw" << image);
+
+    if (!stdinData.isEmpty()) {
+        process.write(stdinData);
+        process.closeWriteChannel();
+    }
+
+    if (!process.waitForFinished(timeoutMs)) {
+        qWarning() << "QR decode timeout or zbarimg not found";
+        process.kill();
+        process.waitForFinished(100);
+        return QStringList();
+    }
+
+    if (process.exitCode() != 0) {
+        qWarning() << "QR decode failed:" << process.readAllStandardError();
+        return QStringList();
+    }
+
+    // With --raw, zbarimg prints one decoded symbol per line
+    QStringList symbols;
+    const QString output = QString::fromUtf8(process.readAllStandardOutput());
+    for (const QString& line : output.split('\n', Qt::SkipEmptyParts)) {
+        QString symbol = line.trimmed();
+        if (!symbol.isEmpty()) {
+            symbols << symbol;
+        }
+    }
+
+    qDebug() << "Decoded QR:" << symbols;
+    return symbols;
+}
+
+}
+
+QStringList QRCodeDecoder::decodeAllFromFile(const QString& imagePath, int timeoutMs)
+{
+    return runZbarimg(imagePath, QByteArray(), timeoutMs);
+}
+
+QString QRCodeDecoder::decodeFromFile(const QString& imagePath, int timeoutMs)
+{
+    QStringList symbols = decodeAllFromFile(imagePath, timeoutMs);
+    return symbols.isEmpty() ? QString() : symbols.first();
+}
+
+QStringList QRCodeDecoder::decodeAllFromData(const QByteArray& imageData, int timeoutMs)
+{
+    if (imageData.isEmpty()) {
+        return QStringList();
+    }
+    // zbarimg reads the image from stdin when given "-"; the format is sniffed
+    return runZbarimg("-", imageData, timeoutMs);
+}
+
+QStringList QRCodeDecoder::decodeAllFromImage(const QImage& image, int timeoutMs)
+{
+    return decodeAllFromData(encodeForDecoding(image), timeoutMs);
+}
+
+QString QRCodeDecoder::decodeFromImage(const QImage& image, int timeoutMs)
+{
+    QStringList symbols = decodeAllFromImage(image, timeoutMs);
+    return symbols.isEmpty() ? QString() : symbols.first();
+}
+
+QByteArray QRCodeDecoder::encodeForDecoding(const QImage& image)
+{
+    // zbar only looks at luminance, and an uncompressed PGM is far cheaper
+    // to write and read than PNG
+    QByteArray data;
+    if (image.isNull()) {
+        return data;
+    }
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.convertToFormat(QImage::Format_Grayscale8).save(&buffer, "PGM");
+    return data;
+}
@@ -0,0 +1,164 @@
+#include "scanDiagnostics.h"
+#include "appStyle.h"
+#include "keyDirectory.h"
+#include "ticketOwnership.h"
+#include <QColor>
+#include <QHeaderView>
+#include <QLabel>
+#include <QStringList>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+
+enum Column {
+    ResultColumn,
+    LoadColumn,
+    DecodeColumn,
+    ParseColumn,
+    KeyColumn,
+    PitSignatureColumn,
+    TicketSignatureColumn,
+    VerifyColumn,
+    TotalColumn,
+    ColumnCount
+};
+
+QString formatMillis(qint64 micros)
+{
+    return micros > 0 ? QString::number(micros / 1000.0, 'f', 2) : QString::fromUtf8("–");
+}
+
+QTableWidgetItem* cell(const QString& text)
+{
+    auto item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+}
+
+ScanDiagnosticsPanel::ScanDiagnosticsPanel(QWidget* parent)
+    : QFrame(parent)
+{
+    setFrameShape(QFrame::NoFrame);
+    AppStyle::setRole(this, "panel");
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(10);
+
+    auto title = new QLabel("Diagnostics (times in ms)", this);
+    AppStyle::setRole(title, "panelTitle");
+    layout->addWidget(title);
+
+    table_ = new QTableWidget(0, ColumnCount, this);
+    AppStyle::setRole(table_, "diagnosticsTable");
+    table_->setHorizontalHeaderLabels({"Result", "Load", "Decode", "Parse", "Key", "PIT sig", "Ticket sig",
+                                       "Verify", "Total"});
+    table_->verticalHeader()->setVisible(false);
+    table_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_->setSelectionMode(QAbstractItemView::NoSelection);
+    table_->setFocusPolicy(Qt::NoFocus);
+    table_->setMinimumHeight(table_->horizontalHeader()->sizeHint().height()
+                             + HISTORY_SIZE * table_->verticalHeader()->defaultSectionSize() + 4);
+    layout->addWidget(table_);
+
+    countersLabel_ = new QLabel(this);
+    AppStyle::setRole(countersLabel_, "diagnosticsCounters");
+    countersLabel_->setWordWrap(true);
+    countersLabel_->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(countersLabel_);
+
+    refreshTimer_ = new QTimer(this);
+    connect(refreshTimer_, &QTimer::timeout, this, &ScanDiagnosticsPanel::refreshCounters);
+}
+
+void ScanDiagnosticsPanel::recordScan(const ScanTimings& timings)
+{
+    history_.push_front(timings);
+    if (history_.size() > size_t(HISTORY_SIZE)) {
+        history_.pop_back();
+    }
+
+    // Hidden panels catch up in showEvent
+    if (isVisible()) {
+        refreshTable();
+        refreshCounters();
+    }
+}
+
+void ScanDiagnosticsPanel::setQueueProbe(std::function<QueueDepths()> probe)
+{
+    queueProbe_ = std::move(probe);
+}
+
+void ScanDiagnosticsPanel::showEvent(QShowEvent* event)
+{
+    QFrame::showEvent(event);
+    refreshTable();
+    refreshCounters();
+    refreshTimer_->start(REFRESH_MS);
+}
+
+void ScanDiagnosticsPanel::hideEvent(QHideEvent* event)
+{
+    refreshTimer_->stop();
+    QFrame::hideEvent(event);
+}
+
+void ScanDiagnosticsPanel::refreshTable()
+{
+    table_->setRowCount(int(history_.size()));
+    int row = 0;
+    for (const ScanTimings& scan : history_) {
+        auto result = new QTableWidgetItem(scan.valid ? QString::fromUtf8("✓ ") + scan.bookingReference
+                                                      : QString::fromUtf8("✗ ") + scan.bookingReference);
+        result->setForeground(scan.valid ? QColor("#27ae60") : QColor("#eb0000"));
+        table_->setItem(row, ResultColumn, result);
+        table_->setItem(row, LoadColumn, cell(formatMillis(scan.loadMicros)));
+        table_->setItem(row, DecodeColumn, cell(formatMillis(scan.decodeMicros)));
+        table_->setItem(row, ParseColumn, cell(formatMillis(scan.parseMicros)));
+        table_->setItem(row, KeyColumn, cell(formatMillis(scan.keyResolveMicros)));
+        table_->setItem(row, PitSignatureColumn, cell(formatMillis(scan.pitSignatureMicros)));
+        table_->setItem(row, TicketSignatureColumn, cell(formatMillis(scan.ticketSignatureMicros)));
+        table_->setItem(row, VerifyColumn, cell(formatMillis(scan.verifyMicros)));
+        table_->setItem(row, TotalColumn, cell(formatMillis(scan.totalMicros)));
+        ++row;
+    }
+}
+
+void ScanDiagnosticsPanel::refreshCounters()
+{
+    const PublicKeyDirectory& keys = sharedKeyDirectory();
+    const size_t hits = keys.cacheHits();
+    const size_t lookups = hits + keys.cacheMisses();
+    const QString cacheLine = lookups == 0
+        ? QString("Key cache: no lookups yet")
+        : QString("Key cache: %1% hits (%2 of %3 lookups)")
+              .arg(100.0 * double(hits) / double(lookups), 0, 'f', 1)
+              .arg(hits)
+              .arg(lookups);
+
+    const PitValidityStats::Counts pit = TicketOwnership::pitValidityStats().snapshot();
+    const QString pitLine = QString("PIT checks: %1 valid, %2 in grace, %3 rejected "
+                                    "(%4 expired, %5 from the future, %6 malformed)")
+                                .arg(pit.valid)
+                                .arg(pit.validInGrace)
+                                .arg(pit.rejected())
+                                .arg(pit.expired)
+                                .arg(pit.fromFuture)
+                                .arg(pit.malformed);
+
+    QStringList lines{cacheLine, pitLine};
+    if (queueProbe_) {
+        const QueueDepths queues = queueProbe_();
+        lines << QString("Queues: %1 decode/verify jobs, %2 handed-over frames, %3 journal entries unwritten")
+                     .arg(queues.verifyJobs)
+                     .arg(queues.handoffJobs)
+                     .arg(queues.journalBacklog)
+              << QString("Live scan: %1 frames dropped").arg(queues.liveFramesDropped);
+    }
+    countersLabel_->setText(lines.join('\n'));
+}
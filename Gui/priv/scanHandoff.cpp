@@ -0,0 +1,162 @@
+#include "scanHandoff.h"
+#include "qrCodeDecoder.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QtEndian>
+#include <QVariant>
+#include <QDebug>
+#include <memory>
+
+namespace {
+
+QString g_serverName;
+
+constexpr int LENGTH_BYTES = 4;
+constexpr char BUFFER_PROPERTY[] = "handoffBuffer";
+
+}
+
+ScanHandoffServer::ScanHandoffServer(QObject* parent)
+    : QObject(parent)
+{
+    server_ = new QLocalServer(this);
+    connect(server_, &QLocalServer::newConnection, this, &ScanHandoffServer::onNewConnection);
+}
+
+bool ScanHandoffServer::listen(const QString& name)
+{
+    server_->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!server_->listen(name)) {
+        // A socket file left behind by a crashed inspector blocks listen(); only
+        // remove the name if nobody answers on it, never a running inspector's
+        if (server_->serverError() != QAbstractSocket::AddressInUseError || isServerRunning(name)) {
+            qWarning() << "Scan handoff: cannot listen on" << name << ":" << server_->errorString();
+            return false;
+        }
+        QLocalServer::removeServer(name);
+        if (!server_->listen(name)) {
+            qWarning() << "Scan handoff: cannot listen on" << name << ":" << server_->errorString();
+            return false;
+        }
+    }
+    qDebug() << "Scan handoff listening on" << server_->fullServerName();
+    return true;
+}
+
+bool ScanHandoffServer::isServerRunning(const QString& name)
+{
+    // Only called at startup, before this process listens itself
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    const bool running = probe.waitForConnected(PROBE_TIMEOUT_MS);
+    probe.abort();
+    return running;
+}
+
+void ScanHandoffServer::close()
+{
+    server_->close();
+}
+
+bool ScanHandoffServer::isListening() const
+{
+    return server_->isListening();
+}
+
+void ScanHandoffServer::onNewConnection()
+{
+    while (QLocalSocket* socket = server_->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readFrames(socket); });
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void ScanHandoffServer::readFrames(QLocalSocket* socket)
+{
+    // Partial frames wait on the socket itself until the rest arrives
+    QByteArray buffer = socket->property(BUFFER_PROPERTY).toByteArray() + socket->readAll();
+    
+    while (buffer.size() >= LENGTH_BYTES) {
+        const quint32 length = qFromBigEndian<quint32>(buffer.constData());
+        if (length == 0 || length > quint32(ScanHandoff::MAX_FRAME_BYTES)) {
+            qWarning() << "Scan handoff: dropping connection after invalid frame length" << length;
+            socket->setProperty(BUFFER_PROPERTY, QVariant());
+            socket->abort();
+            return;
+        }
+        if (buffer.size() < LENGTH_BYTES + int(length)) {
+            break;
+        }
+        emit frameReceived(buffer.mid(LENGTH_BYTES, int(length)));
+        buffer.remove(0, LENGTH_BYTES + int(length));
+    }
+    
+    socket->setProperty(BUFFER_PROPERTY, buffer);
+}
+
+QString ScanHandoff::defaultServerName()
+{
+    return "sbb-inspector-handoff";
+}
+
+void ScanHandoff::setServerName(const QString& name)
+{
+    g_serverName = name;
+}
+
+bool ScanHandoff::isEnabled()
+{
+    return !g_serverName.isEmpty();
+}
+
+void ScanHandoff::sendFrame(const QImage& frame, QObject* context, std::function<void(bool)> done)
+{
+    const QByteArray imageData = isEnabled() ? QRCodeDecoder::encodeForDecoding(frame) : QByteArray();
+    if (imageData.isEmpty() || imageData.size() > MAX_FRAME_BYTES) {
+        if (done) {
+            done(false);
+        }
+        return;
+    }
+    
+    QByteArray message(LENGTH_BYTES, '\0');
+    qToBigEndian<quint32>(quint32(imageData.size()), message.data());
+    message += imageData;
+    
+    // Driven by the event loop, so the sender never blocks, and an inspector in
+    // this process (--both) can accept the connection while the frame is sent.
+    // The socket belongs to context, so closing the window abandons the send.
+    auto socket = new QLocalSocket(context);
+    auto reported = std::make_shared<bool>(false);
+    auto report = [socket, reported, done](bool sent) {
+        if (*reported) {
+            return;
+        }
+        *reported = true;
+        socket->deleteLater();
+        if (done) {
+            done(sent);
+        }
+    };
+    
+    QObject::connect(socket, &QLocalSocket::connected, socket, [socket, message]() {
+        socket->write(message);
+    });
+    QObject::connect(socket, &QLocalSocket::bytesWritten, socket, [socket, report]() {
+        if (socket->bytesToWrite() == 0) {
+            socket->disconnectFromServer();
+            report(true);
+        }
+    });
+    QObject::connect(socket, &QLocalSocket::errorOccurred, socket, [socket, report](QLocalSocket::LocalSocketError) {
+        qWarning() << "Scan handoff: cannot send to" << g_serverName << ":" << socket->errorString();
+        report(false);
+    });
+    QTimer::singleShot(SEND_TIMEOUT_MS, socket, [report]() {
+        qWarning() << "Scan handoff: inspector did not take the frame in time";
+        report(false);
+    });
+    
+    socket->connectToServer(g_serverName);
+}
@@ -0,0 +1,196 @@
+#include "scanVerifier.h"
+#include "qrCodeDecoder.h"
+#include "keyDirectory.h"
+#include "companyKeys.h"
+#include "PayloadVerifier.h"
+#include "VerifyClient.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace {
+
+struct DaemonTarget
+{
+    std::string socketPath;
+    quint32 gateId = 0;
+};
+
+// Read by worker threads, so always accessed through the atomic free functions
+std::shared_ptr<const DaemonTarget> g_daemon;
+
+constexpr int DAEMON_TIMEOUT_MS = 2000;
+
+// The daemon stops at its first failed check, in PayloadVerifier's order, so
+// every stage before the failing one passed
+TicketOwnership::VerificationResult daemonResult(const VerifyProtocol::VerifyResponse& response)
+{
+    using Verdict = PayloadVerifier::Verdict;
+    const Verdict verdict = static_cast<Verdict>(response.verdict);
+    const bool pitMalformed = verdict == Verdict::Malformed && response.pitTimestamp == 0;
+
+    TicketOwnership::VerificationResult result;
+    result.pitParsed = !pitMalformed && verdict != Verdict::Expired && verdict != Verdict::FromFuture;
+    result.ticketParsed = result.pitParsed && verdict != Verdict::Malformed;
+    result.ticketRevoked = verdict == Verdict::Revoked;
+    result.keysMatch = result.ticketParsed && !result.ticketRevoked && verdict != Verdict::KeyMismatch;
+    result.pitSignatureValid = result.keysMatch && verdict != Verdict::UnknownKey
+                               && verdict != Verdict::BadPitSignature;
+    result.ticketSignatureValid = result.pitSignatureValid && verdict != Verdict::BadTicketSignature
+                                  && (response.flags & VerifyProtocol::TicketSignatureChecked);
+    result.isValid = verdict == Verdict::Valid;
+    result.pitTimestamp = response.pitTimestamp;
+    result.ticketTimestamp = response.ticketTimestamp;
+    result.bookingReference = QString::fromStdString(response.bookingRef);
+
+    switch (verdict) {
+    case Verdict::Valid:
+        result.errorMessage = "Verification successful - ticket belongs to user";
+        break;
+    case Verdict::Malformed:
+        result.errorMessage = pitMalformed ? "Failed to parse PIT QR code" : "Failed to parse ticket QR code";
+        break;
+    case Verdict::Expired:
+        result.errorMessage = "PIT has expired - ask the passenger to show the live code";
+        break;
+    case Verdict::FromFuture:
+        result.errorMessage = "PIT timestamp is in the future - check the device clock";
+        break;
+    case Verdict::Revoked:
+        result.errorMessage = "Ticket has been revoked (refunded, cancelled or flagged)";
+        break;
+    case Verdict::KeyMismatch:
+        result.errorMessage = "Public key hashes do not match - ticket does not belong to this user";
+        break;
+    case Verdict::UnknownKey:
+        result.errorMessage = "User public key is not registered in the key directory";
+        break;
+    case Verdict::BadPitSignature:
+        result.errorMessage = "PIT signature verification failed - invalid identity token";
+        break;
+    case Verdict::BadTicketSignature:
+        result.errorMessage = "Ticket signature verification failed - invalid or forged ticket";
+        break;
+    case Verdict::Replayed:
+        result.errorMessage = "PIT was already used at another gate";
+        break;
+    default:
+        result.errorMessage = "Verification failed";
+        break;
+    }
+
+    // Keep the diagnostics panel's PIT counters meaningful in daemon mode
+    PitValidityPolicy::Verdict pitVerdict = (response.flags & VerifyProtocol::InGrace)
+        ? PitValidityPolicy::Verdict::ValidInGrace
+        : PitValidityPolicy::Verdict::Valid;
+    if (pitMalformed) {
+        pitVerdict = PitValidityPolicy::Verdict::Malformed;
+    } else if (verdict == Verdict::Expired) {
+        pitVerdict = PitValidityPolicy::Verdict::Expired;
+    } else if (verdict == Verdict::FromFuture) {
+        pitVerdict = PitValidityPolicy::Verdict::FromFuture;
+    }
+    TicketOwnership::pitValidityStats().record(pitVerdict);
+    return result;
+}
+
+// One connection per verifying thread, reopened after an error or when the daemon changes
+TicketOwnership::VerificationResult verifyWithDaemon(const DaemonTarget& daemon, const QString& pitQRData,
+                                                     const QString& ticketQRData)
+{
+    thread_local std::unique_ptr<VerifyClient> client;
+    thread_local std::string clientPath;
+    if (!client || clientPath != daemon.socketPath) {
+        client.reset();
+        client = std::make_unique<VerifyClient>(daemon.socketPath, std::chrono::milliseconds(DAEMON_TIMEOUT_MS));
+        clientPath = daemon.socketPath;
+    }
+    try {
+        return daemonResult(client->verify(pitQRData.toStdString(), ticketQRData.toStdString(), daemon.gateId));
+    } catch (...) {
+        client.reset();
+        throw;
+    }
+}
+
+TicketOwnership::VerificationResult decodeFailure(const char* which)
+{
+    TicketOwnership::VerificationResult result;
+    result.errorMessage = QString("Failed to decode %1 QR code from image").arg(which);
+    return result;
+}
+
+TicketOwnership::VerificationResult verifyDecoded(const QStringList& pitSymbols, const QStringList& ticketSymbols)
+{
+    if (pitSymbols.isEmpty()) {
+        return decodeFailure("PIT");
+    }
+    if (ticketSymbols.isEmpty()) {
+        return decodeFailure("ticket");
+    }
+    return ScanVerifier::verifyPayloads(pitSymbols.first(), ticketSymbols.first());
+}
+
+}
+
+void ScanVerifier::setVerifyDaemon(const QString& socketPath, quint32 gateId)
+{
+    std::shared_ptr<const DaemonTarget> daemon;
+    if (!socketPath.isEmpty()) {
+        daemon = std::make_shared<const DaemonTarget>(DaemonTarget{socketPath.toStdString(), gateId});
+    }
+    std::atomic_store(&g_daemon, std::move(daemon));
+}
+
+TicketOwnership::VerificationResult ScanVerifier::verifyPayloads(const QString& pitQRData, const QString& ticketQRData)
+{
+    if (auto daemon = std::atomic_load(&g_daemon)) {
+        try {
+            return verifyWithDaemon(*daemon, pitQRData, ticketQRData);
+        } catch (const std::exception& e) {
+            qWarning() << "Verification daemon unavailable, verifying in-process:" << e.what();
+        }
+    }
+
+    // Resolve the user's full public key from the hash in the PIT, so the
+    // PIT signature is always checked rather than just comparing hashes
+    QString keyHash;
+    qint64 pitTimestamp = 0;
+    QString pitSignature;
+    std::shared_ptr<const PublicKeyDirectory::Entry> userKey;
+    qint64 keyResolveMicros = 0;
+    if (TicketOwnership::parsePIT(pitQRData, keyHash, pitTimestamp, pitSignature)) {
+        QElapsedTimer timer;
+        timer.start();
+        userKey = sharedKeyDirectory().resolve(keyHash.toStdString());
+        keyResolveMicros = timer.nsecsElapsed() / 1000;
+    }
+    
+    TicketOwnership::VerificationResult result;
+    if (!userKey) {
+        result = TicketOwnership::verifyOwnership(pitQRData, ticketQRData);
+        if (result.pitParsed && result.ticketParsed && result.keysMatch) {
+            result.isValid = false;
+            result.errorMessage = "User public key is not registered in the key directory";
+        }
+    } else {
+        // Empty if no company key was set up; the ticket signature is then reported unchecked
+        result = TicketOwnership::verifyOwnership(pitQRData, ticketQRData, *userKey, companyPublicKey());
+    }
+    result.keyResolveMicros = keyResolveMicros;
+    return result;
+}
+
+TicketOwnership::VerificationResult ScanVerifier::verifyImageData(const QByteArray& pitImage, const QByteArray& ticketImage)
+{
+    return verifyDecoded(QRCodeDecoder::decodeAllFromData(pitImage),
+                         QRCodeDecoder::decodeAllFromData(ticketImage));
+}
+
+TicketOwnership::VerificationResult ScanVerifier::verifyImages(const QImage& pitImage, const QImage& ticketImage)
+{
+    return verifyDecoded(QRCodeDecoder::decodeAllFromImage(pitImage),
+                         QRCodeDecoder::decodeAllFromImage(ticketImage));
+}
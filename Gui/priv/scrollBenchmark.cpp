@@ -0,0 +1,92 @@
+#include "scrollBenchmark.h"
+#include "bookingReference.h"
+#include "cardShadow.h"
+#include "definitions.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QGraphicsDropShadowEffect>
+#include <QScrollArea>
+#include <QScrollBar>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Sweep down and back up, repainting synchronously each frame
+void reportFrames(const char* label, QWidget& page, QScrollBar* bar, int frames)
+{
+    const int maximum = std::max(1, bar->maximum());
+    const int step = std::max(1, 2 * maximum / std::max(1, frames));
+    std::vector<double> samples;
+    samples.reserve(frames);
+
+    bar->setValue(0);
+    page.repaint(); // warm-up: shadow tiles, glyph caches
+
+    int value = 0;
+    int direction = 1;
+    for (int f = 0; f < frames; ++f) {
+        value += direction * step;
+        if (value >= maximum || value <= 0) {
+            value = std::clamp(value, 0, maximum);
+            direction = -direction;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        bar->setValue(value);
+        page.repaint();
+        samples.push_back(timer.nsecsElapsed() / 1e6);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    std::fprintf(stderr, "[scroll] %-36s p50 %6.2f ms  p99 %6.2f ms  max %6.2f ms\n",
+                 label,
+                 samples[samples.size() / 2],
+                 samples[std::min(samples.size() - 1, samples.size() * 99 / 100)],
+                 samples.back());
+}
+
+} // namespace
+
+int ScrollBenchmark::run(int cardCount, int frames)
+{
+    BookingReference page;
+    page.resize(SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (int i = 0; i < cardCount; ++i) {
+        page.addTicket(TicketInfo(QString("Station %1").arg(i), "Bern",
+                                  QDate::currentDate().addDays(i % 30), QTime(6, 0).addSecs(60 * i)));
+    }
+    page.show();
+    QCoreApplication::processEvents();
+
+    auto scrollArea = page.findChild<QScrollArea*>();
+    if (!scrollArea || frames <= 0) {
+        return 1;
+    }
+    QScrollBar* bar = scrollArea->verticalScrollBar();
+    const QList<TicketCard*> cards = page.findChildren<TicketCard*>();
+    std::fprintf(stderr, "[scroll] %d cards, %d frames, list height %d px\n",
+                 static_cast<int>(cards.size()), frames, bar->maximum() + bar->pageStep());
+
+    // Before: an offscreen render and blur per visible card on every frame
+    CardShadow::setEnabled(false);
+    for (TicketCard* card : cards) {
+        auto effect = new QGraphicsDropShadowEffect(card);
+        effect->setBlurRadius(2 * CardShadow::BLUR_RADIUS);
+        effect->setOffset(0, CardShadow::OFFSET_Y);
+        effect->setColor(QColor(0, 0, 0, 45));
+        card->setGraphicsEffect(effect);
+    }
+    reportFrames("QGraphicsDropShadowEffect per card", page, bar, frames);
+
+    // After: the shared nine-patch
+    for (TicketCard* card : cards) {
+        card->setGraphicsEffect(nullptr);
+    }
+    CardShadow::setEnabled(true);
+    reportFrames("cached nine-patch CardShadow", page, bar, frames);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "startupProfiler.h"
+#include <QEvent>
+#include <QWidget>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+std::atomic<bool> g_enabled{false};
+std::chrono::steady_clock::time_point g_start;
+}
+
+void StartupProfiler::enable()
+{
+    g_start = std::chrono::steady_clock::now();
+    g_enabled = true;
+}
+
+bool StartupProfiler::isEnabled()
+{
+    return g_enabled;
+}
+
+void StartupProfiler::mark(const QString& event)
+{
+    if (!g_enabled) {
+        return;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g_start).count();
+    // One fprintf per line, so marks from the key bootstrap thread don't interleave
+    std::fprintf(stderr, "[startup] +%.1f ms %s\n", ms, event.toUtf8().constData());
+}
+
+void StartupProfiler::watchFirstPaint(QWidget* window, const QString& label)
+{
+    if (!g_enabled || !window) {
+        return;
+    }
+    // Owned by the window; removes itself after the first paint
+    window->installEventFilter(new StartupProfiler(window, label));
+}
+
+void StartupProfiler::markBuilt(QWidget* widget, const QString& label, const QElapsedTimer& constructTimer)
+{
+    if (!g_enabled || !widget) {
+        return;
+    }
+
+    const double constructMs = constructTimer.nsecsElapsed() / 1e6;
+    QElapsedTimer polishTimer;
+    polishTimer.start();
+    widget->ensurePolished();
+    const double polishMs = polishTimer.nsecsElapsed() / 1e6;
+
+    mark(QString("%1 built: construct %2 ms, polish %3 ms")
+             .arg(label)
+             .arg(constructMs, 0, 'f', 2)
+             .arg(polishMs, 0, 'f', 2));
+}
+
+StartupProfiler::StartupProfiler(QWidget* window, const QString& label)
+    : QObject(window)
+    , label_(label)
+{
+}
+
+bool StartupProfiler::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::Paint) {
+        mark(label_ + " first paint");
+        watched->removeEventFilter(this);
+        deleteLater();
+    }
+    return QObject::eventFilter(watched, event);
+}
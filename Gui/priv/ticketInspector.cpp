@@ -1,11 +1,15 @@
 #include "ticketInspector.h"
+#include "appStyle.h"
+#include "iconCache.h"
+#include "companyKeys.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFrame>
-#include <QProcess>
-#include <QTemporaryFile>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
 #include <QDebug>
 
 TicketInspector::TicketInspector(QWidget* parent)
@@ -14,11 +18,30 @@ TicketInspector::TicketInspector(QWidget* parent)
     setWindowTitle("SBB Ticket Inspector");
     setMinimumSize(800, 700);
     setupUI();
+    
+    // Decoding and verification get a worker each, so a slow zbarimg decode
+    // never holds up the verification of a pair that is already loaded
+    decodeWorker_ = new VerificationWorker(this);
+    connect(decodeWorker_, &VerificationWorker::imageDecoded, this, &TicketInspector::handleImageDecoded);
+    verifyWorker_ = new VerificationWorker(this);
+    connect(verifyWorker_, &VerificationWorker::verificationFinished,
+            this, &TicketInspector::handleVerificationFinished);
+    
+    // Handed-over frames are decoded separately so starting a new pair does not cancel them
+    handoffWorker_ = new VerificationWorker(this);
+    connect(handoffWorker_, &VerificationWorker::imageDecoded, this, &TicketInspector::handleHandoffDecoded);
+    
+    liveScan_ = new LiveScanSource(this);
+    connect(liveScan_, &LiveScanSource::codeDecoded, this, &TicketInspector::handleLiveCode);
+    connect(liveScan_, &LiveScanSource::sourceError, this, &TicketInspector::handleLiveScanError);
+    
+    diagnosticsPanel_->setQueueProbe([this]() { return queueDepths(); });
 }
 
 void TicketInspector::setupUI()
 {
-    setStyleSheet("background-color: #f5f5f5;");
+    AppStyle::setRole(this, "page");
+    setAttribute(Qt::WA_StyledBackground);
     
     auto mainLayout = new QVBoxLayout(this);
     mainLayout->setContentsMargins(0, 0, 0, 0);
@@ -26,7 +49,7 @@ void TicketInspector::setupUI()
 
     // Add SBB header with logo
     auto headerWidget = new QWidget(this);
-    headerWidget->setStyleSheet("background-color: #eb0000;");
+    AppStyle::setRole(headerWidget, "header");
     headerWidget->setFixedHeight(80);
     auto headerLayout = new QHBoxLayout(headerWidget);
     headerLayout->setContentsMargins(20, 15, 20, 15);
@@ -34,15 +57,12 @@ void TicketInspector::setupUI()
     auto logoLabel = new QLabel(headerWidget);
     logoLabel->setAlignment(Qt::AlignCenter);
     logoLabel->setFixedSize(50, 50);
-    logoLabel->setStyleSheet("background: transparent; border: none; padding: 0;");
-    QPixmap logoPix("icons/SBB_logo.svg");
-    if (!logoPix.isNull()) {
-        logoLabel->setPixmap(logoPix.scaled(logoLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    }
+    AppStyle::setRole(logoLabel, "logo");
+    logoLabel->setPixmap(IconCache::pixmap("SBB_logo.svg", logoLabel->size()));
     headerLayout->addWidget(logoLabel);
     
     titleLabel_ = new QLabel("Ticket Inspector", headerWidget);
-    titleLabel_->setStyleSheet("font-size: 18px; font-weight: 600; color: white; background: transparent; border: none;");
+    AppStyle::setRole(titleLabel_, "headerTitle");
     titleLabel_->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
     headerLayout->addWidget(titleLabel_);
     headerLayout->addStretch();
@@ -52,10 +72,10 @@ void TicketInspector::setupUI()
     // Content wrapper with scroll area
     auto scrollArea = new QScrollArea(this);
     scrollArea->setWidgetResizable(true);
-    scrollArea->setStyleSheet("QScrollArea { border: none; background-color: #f5f5f5; }");
+    AppStyle::setRole(scrollArea, "page");
     
     auto contentWrapper = new QWidget();
-    contentWrapper->setStyleSheet("background-color: #f5f5f5;");
+    AppStyle::setRole(contentWrapper, "page");
     auto contentMainLayout = new QVBoxLayout(contentWrapper);
     contentMainLayout->setContentsMargins(30, 30, 30, 30);
     contentMainLayout->setSpacing(25);
@@ -67,13 +87,13 @@ void TicketInspector::setupUI()
     // Left Column - PIT
     auto pitPanel = new QFrame(contentWrapper);
     pitPanel->setFrameShape(QFrame::NoFrame);
-    pitPanel->setStyleSheet("QFrame { background-color: white; border: 1px solid #e0e0e0; border-radius: 12px; }");
+    AppStyle::setRole(pitPanel, "panel");
     auto pitLayout = new QVBoxLayout(pitPanel);
     pitLayout->setContentsMargins(20, 20, 20, 20);
     pitLayout->setSpacing(15);
     
     pitLabel_ = new QLabel("Personal Identity Token (PIT)", pitPanel);
-    pitLabel_->setStyleSheet("font-size: 16px; font-weight: 600; color: #333; background: transparent; border: none;");
+    AppStyle::setRole(pitLabel_, "panelTitle");
     pitLabel_->setAlignment(Qt::AlignCenter);
     pitLayout->addWidget(pitLabel_);
     
@@ -81,7 +101,7 @@ void TicketInspector::setupUI()
     pitImageLabel_ = new QLabel(pitPanel);
     pitImageLabel_->setFixedSize(IMAGE_SIZE, IMAGE_SIZE);
     pitImageLabel_->setAlignment(Qt::AlignCenter);
-    pitImageLabel_->setStyleSheet("QLabel { background-color: #fafafa; border: 2px dashed #e0e0e0; border-radius: 8px; color: #666; }");
+    AppStyle::setRole(pitImageLabel_, "qrPreview");
     pitImageLabel_->setText("No QR Code Loaded");
     pitImageLabel_->setWordWrap(true);
     pitImageLabel_->setScaledContents(false);
@@ -90,19 +110,12 @@ void TicketInspector::setupUI()
     loadPITButton_ = new QPushButton("Load PIT QR Code", pitPanel);
     loadPITButton_->setMinimumHeight(46);
     loadPITButton_->setCursor(Qt::PointingHandCursor);
-    loadPITButton_->setStyleSheet(
-        "QPushButton { "
-        "  background-color: #eb0000; color: white; font-weight: 600; "
-        "  font-size: 14px; border: none; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { background-color: #c00000; } "
-        "QPushButton:pressed { background-color: #a00000; }"
-    );
+    AppStyle::setRole(loadPITButton_, "primary");
     connect(loadPITButton_, &QPushButton::clicked, this, &TicketInspector::loadPITQRCode);
     pitLayout->addWidget(loadPITButton_);
     
     pitStatusLabel_ = new QLabel("Status: Waiting", pitPanel);
-    pitStatusLabel_->setStyleSheet("font-size: 13px; color: #666; background: transparent; border: none;");
+    AppStyle::setRole(pitStatusLabel_, "status");
     pitStatusLabel_->setAlignment(Qt::AlignCenter);
     pitLayout->addWidget(pitStatusLabel_);
     
@@ -111,13 +124,13 @@ void TicketInspector::setupUI()
     // Right Column - Ticket
     auto ticketPanel = new QFrame(contentWrapper);
     ticketPanel->setFrameShape(QFrame::NoFrame);
-    ticketPanel->setStyleSheet("QFrame { background-color: white; border: 1px solid #e0e0e0; border-radius: 12px; }");
+    AppStyle::setRole(ticketPanel, "panel");
     auto ticketLayout = new QVBoxLayout(ticketPanel);
     ticketLayout->setContentsMargins(20, 20, 20, 20);
     ticketLayout->setSpacing(15);
     
     ticketLabel_ = new QLabel("Booking Ticket", ticketPanel);
-    ticketLabel_->setStyleSheet("font-size: 16px; font-weight: 600; color: #333; background: transparent; border: none;");
+    AppStyle::setRole(ticketLabel_, "panelTitle");
     ticketLabel_->setAlignment(Qt::AlignCenter);
     ticketLayout->addWidget(ticketLabel_);
     
@@ -125,7 +138,7 @@ void TicketInspector::setupUI()
     ticketImageLabel_ = new QLabel(ticketPanel);
     ticketImageLabel_->setFixedSize(IMAGE_SIZE, IMAGE_SIZE);
     ticketImageLabel_->setAlignment(Qt::AlignCenter);
-    ticketImageLabel_->setStyleSheet("QLabel { background-color: #fafafa; border: 2px dashed #e0e0e0; border-radius: 8px; color: #666; }");
+    AppStyle::setRole(ticketImageLabel_, "qrPreview");
     ticketImageLabel_->setText("No QR Code Loaded");
     ticketImageLabel_->setWordWrap(true);
     ticketImageLabel_->setScaledContents(false);
@@ -134,19 +147,12 @@ void TicketInspector::setupUI()
     loadTicketButton_ = new QPushButton("Load Ticket QR Code", ticketPanel);
     loadTicketButton_->setMinimumHeight(46);
     loadTicketButton_->setCursor(Qt::PointingHandCursor);
-    loadTicketButton_->setStyleSheet(
-        "QPushButton { "
-        "  background-color: #eb0000; color: white; font-weight: 600; "
-        "  font-size: 14px; border: none; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { background-color: #c00000; } "
-        "QPushButton:pressed { background-color: #a00000; }"
-    );
+    AppStyle::setRole(loadTicketButton_, "primary");
     connect(loadTicketButton_, &QPushButton::clicked, this, &TicketInspector::loadTicketQRCode);
     ticketLayout->addWidget(loadTicketButton_);
     
     ticketStatusLabel_ = new QLabel("Status: Waiting", ticketPanel);
-    ticketStatusLabel_->setStyleSheet("font-size: 13px; color: #666; background: transparent; border: none;");
+    AppStyle::setRole(ticketStatusLabel_, "status");
     ticketStatusLabel_->setAlignment(Qt::AlignCenter);
     ticketLayout->addWidget(ticketStatusLabel_);
     
@@ -161,28 +167,29 @@ void TicketInspector::setupUI()
     clearButton_ = new QPushButton("Clear All", contentWrapper);
     clearButton_->setMinimumHeight(50);
     clearButton_->setCursor(Qt::PointingHandCursor);
-    clearButton_->setStyleSheet(
-        "QPushButton { "
-        "  background-color: white; color: #666; font-weight: 600; "
-        "  font-size: 14px; border: 2px solid #e0e0e0; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { background-color: #f5f5f5; border-color: #ccc; }"
-    );
+    AppStyle::setRole(clearButton_, "secondary");
     connect(clearButton_, &QPushButton::clicked, this, &TicketInspector::clearAll);
     buttonLayout->addWidget(clearButton_);
     
+    liveScanButton_ = new QPushButton("Start Live Scan", contentWrapper);
+    liveScanButton_->setMinimumHeight(50);
+    liveScanButton_->setCursor(Qt::PointingHandCursor);
+    AppStyle::setRole(liveScanButton_, "secondary");
+    connect(liveScanButton_, &QPushButton::clicked, this, &TicketInspector::toggleLiveScan);
+    buttonLayout->addWidget(liveScanButton_);
+    
+    diagnosticsButton_ = new QPushButton("Diagnostics", contentWrapper);
+    diagnosticsButton_->setMinimumHeight(50);
+    diagnosticsButton_->setCursor(Qt::PointingHandCursor);
+    diagnosticsButton_->setCheckable(true);
+    diagnosticsButton_->setToolTip("Show stage timings of the last scans, cache hit rates and queue depths");
+    AppStyle::setRole(diagnosticsButton_, "secondary");
+    buttonLayout->addWidget(diagnosticsButton_);
+    
     verifyButton_ = new QPushButton("Verify Ownership", contentWrapper);
     verifyButton_->setMinimumHeight(50);
     verifyButton_->setCursor(Qt::PointingHandCursor);
-    verifyButton_->setStyleSheet(
-        "QPushButton { "
-        "  background-color: #eb0000; color: white; font-weight: 600; "
-        "  font-size: 15px; border: none; border-radius: 8px; "
-        "} "
-        "QPushButton:hover { background-color: #c00000; } "
-        "QPushButton:pressed { background-color: #a00000; } "
-        "QPushButton:disabled { background-color: #e0e0e0; color: #999; }"
-    );
+    AppStyle::setRole(verifyButton_, "primary");
     verifyButton_->setEnabled(false);
     connect(verifyButton_, &QPushButton::clicked, this, &TicketInspector::verifyOwnership);
     buttonLayout->addWidget(verifyButton_, 1);
@@ -191,7 +198,7 @@ void TicketInspector::setupUI()
 
     // Result Panel
     resultPanel_ = new QWidget(contentWrapper);
-    resultPanel_->setStyleSheet("QWidget { background-color: white; border: 1px solid #e0e0e0; border-radius: 12px; }");
+    AppStyle::setRole(resultPanel_, "resultPanel");
     auto resultLayout = new QVBoxLayout(resultPanel_);
     resultLayout->setContentsMargins(24, 24, 24, 24);
     resultLayout->setSpacing(10);
@@ -200,24 +207,30 @@ void TicketInspector::setupUI()
     resultIconLabel_ = new QLabel(resultPanel_);
     resultIconLabel_->setFixedSize(48, 48);
     resultIconLabel_->setAlignment(Qt::AlignCenter);
-    resultIconLabel_->setStyleSheet("background: transparent; border: none;");
+    AppStyle::setRole(resultIconLabel_, "resultIcon");
     resultTopLayout->addWidget(resultIconLabel_);
     
     resultTextLabel_ = new QLabel("Awaiting verification...", resultPanel_);
-    resultTextLabel_->setStyleSheet("font-size: 18px; font-weight: 600; color: #666; background: transparent; border: none;");
+    AppStyle::setRole(resultTextLabel_, "resultText");
     resultTextLabel_->setWordWrap(true);
     resultTopLayout->addWidget(resultTextLabel_, 1);
     
     resultLayout->addLayout(resultTopLayout);
     
     detailsLabel_ = new QLabel("Load both QR codes and click 'Verify Ownership' to check if the ticket belongs to the user.", resultPanel_);
-    detailsLabel_->setStyleSheet("font-size: 13px; color: #666; background: transparent; border: none;");
+    AppStyle::setRole(detailsLabel_, "resultDetails");
     detailsLabel_->setWordWrap(true);
     resultLayout->addWidget(detailsLabel_);
     
     resultPanel_->setVisible(true);
     contentMainLayout->addWidget(resultPanel_);
     
+    // Hidden until toggled; it reads no counters while hidden
+    diagnosticsPanel_ = new ScanDiagnosticsPanel(contentWrapper);
+    diagnosticsPanel_->setVisible(false);
+    connect(diagnosticsButton_, &QPushButton::toggled, diagnosticsPanel_, &QWidget::setVisible);
+    contentMainLayout->addWidget(diagnosticsPanel_);
+    
     scrollArea->setWidget(contentWrapper);
     mainLayout->addWidget(scrollArea);
 }
@@ -233,29 +246,13 @@ void TicketInspector::loadPITQRCode()
         return;
     }
     
-    // Load and display image
-    pitImage_.load(fileName);
-    if (pitImage_.isNull()) {
-        QMessageBox::warning(this, "Error", "Failed to load image file.");
-        return;
-    }
-    
-    pitImageLabel_->setPixmap(pitImage_.scaled(IMAGE_SIZE, IMAGE_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    
-    // Decode QR code
-    pitQRData_ = decodeQRFromImage(fileName);
-    
-    if (pitQRData_.isEmpty()) {
-        pitStatusLabel_->setText("Status: Failed to decode QR");
-        pitStatusLabel_->setStyleSheet("font-size: 13px; color: #eb0000; font-weight: 600;");
-        QMessageBox::warning(this, "Error", "Failed to decode QR code from image.\n\nMake sure the image contains a valid QR code.");
-    } else {
-        pitStatusLabel_->setText("Status: QR Code Loaded ✓");
-        pitStatusLabel_->setStyleSheet("font-size: 13px; color: #27ae60; font-weight: 600;");
-    }
-    
-    // Enable verify button if both QR codes are loaded
-    verifyButton_->setEnabled(!pitQRData_.isEmpty() && !ticketQRData_.isEmpty());
+    // Loading and decoding run on the worker; a newer file supersedes this one
+    clearVerdict();
+    pitQRData_.clear();
+    pitDecodeJob_ = decodeWorker_->decodeImage(fileName, IMAGE_SIZE);
+    pitStatusLabel_->setText("Status: Decoding...");
+    AppStyle::setState(pitStatusLabel_, "state", QVariant());
+    verifyButton_->setEnabled(false);
 }
 
 void TicketInspector::loadTicketQRCode()
@@ -269,29 +266,50 @@ void TicketInspector::loadTicketQRCode()
         return;
     }
     
-    // Load and display image
-    ticketImage_.load(fileName);
-    if (ticketImage_.isNull()) {
+    // Loading and decoding run on the worker; a newer file supersedes this one
+    clearVerdict();
+    ticketQRData_.clear();
+    ticketDecodeJob_ = decodeWorker_->decodeImage(fileName, IMAGE_SIZE);
+    ticketStatusLabel_->setText("Status: Decoding...");
+    AppStyle::setState(ticketStatusLabel_, "state", QVariant());
+    verifyButton_->setEnabled(false);
+}
+
+void TicketInspector::handleImageDecoded(quint64 jobId, const QString& payload, const QImage& preview,
+                                         qint64 elapsedMicros, qint64 loadMicros)
+{
+    const bool isPIT = jobId == pitDecodeJob_;
+    if (!isPIT && jobId != ticketDecodeJob_) {
+        return; // superseded by a newer file for the same slot
+    }
+    (isPIT ? pitDecodeJob_ : ticketDecodeJob_) = 0;
+    
+    QLabel* imageLabel = isPIT ? pitImageLabel_ : ticketImageLabel_;
+    QLabel* statusLabel = isPIT ? pitStatusLabel_ : ticketStatusLabel_;
+    
+    if (preview.isNull()) {
+        statusLabel->setText("Status: Waiting");
+        AppStyle::setState(statusLabel, "state", QVariant());
         QMessageBox::warning(this, "Error", "Failed to load image file.");
         return;
     }
     
-    ticketImageLabel_->setPixmap(ticketImage_.scaled(IMAGE_SIZE, IMAGE_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    
-    // Decode QR code
-    ticketQRData_ = decodeQRFromImage(fileName);
+    imageLabel->setPixmap(QPixmap::fromImage(preview));
+    (isPIT ? pitQRData_ : ticketQRData_) = payload;
+    (isPIT ? pitDecodeMicros_ : ticketDecodeMicros_) = elapsedMicros;
+    (isPIT ? pitLoadMicros_ : ticketLoadMicros_) = loadMicros;
     
-    if (ticketQRData_.isEmpty()) {
-        ticketStatusLabel_->setText("Status: Failed to decode QR");
-        ticketStatusLabel_->setStyleSheet("font-size: 13px; color: #eb0000; font-weight: 600;");
+    if (payload.isEmpty()) {
+        statusLabel->setText("Status: Failed to decode QR");
+        AppStyle::setState(statusLabel, "state", "error");
         QMessageBox::warning(this, "Error", "Failed to decode QR code from image.\n\nMake sure the image contains a valid QR code.");
     } else {
-        ticketStatusLabel_->setText("Status: QR Code Loaded ✓");
-        ticketStatusLabel_->setStyleSheet("font-size: 13px; color: #27ae60; font-weight: 600;");
+        statusLabel->setText("Status: QR Code Loaded ✓");
+        AppStyle::setState(statusLabel, "state", "ok");
     }
     
     // Enable verify button if both QR codes are loaded
-    verifyButton_->setEnabled(!pitQRData_.isEmpty() && !ticketQRData_.isEmpty());
+    verifyButton_->setEnabled(!pitQRData_.isEmpty() && !ticketQRData_.isEmpty() && verifyJob_ == 0);
 }
 
 void TicketInspector::verifyOwnership()
@@ -301,8 +319,27 @@ void TicketInspector::verifyOwnership()
         return;
     }
     
-    // Perform verification
-    auto result = TicketOwnership::verifyOwnership(pitQRData_, ticketQRData_);
+    // Key lookup and signature checks run on the worker
+    verifyJob_ = verifyWorker_->verify(pitQRData_, ticketQRData_);
+    verifyTimer_.start();
+    verifyButton_->setEnabled(false);
+    resultTextLabel_->setText("Verifying...");
+    AppStyle::setState(resultTextLabel_, "verdict", QVariant());
+}
+
+void TicketInspector::handleVerificationFinished(quint64 jobId, const TicketOwnership::VerificationResult& result,
+                                                 qint64 elapsedMicros)
+{
+    if (jobId != verifyJob_) {
+        return;
+    }
+    verifyJob_ = 0;
+    verifyButton_->setEnabled(!pitQRData_.isEmpty() && !ticketQRData_.isEmpty());
+    
+    // One timing record feeds both the export and the diagnostics panel
+    const ScanTimings timings = scanTimings(result, elapsedMicros);
+    journalResult(result, timings);
+    diagnosticsPanel_->recordScan(timings);
     
     // Update UI with result
     updateVerificationStatus(result);
@@ -310,10 +347,24 @@ void TicketInspector::verifyOwnership()
 
 void TicketInspector::clearAll()
 {
+    // Frames handed over before the clear belong to the previous passenger
+    handoffWorker_->cancelAll();
+    resetPair();
+}
+
+void TicketInspector::resetPair()
+{
+    // Drop anything still decoding or verifying for the previous pair
+    decodeWorker_->cancelAll();
+    pitDecodeJob_ = 0;
+    ticketDecodeJob_ = 0;
+    pitDecodeMicros_ = 0;
+    ticketDecodeMicros_ = 0;
+    pitLoadMicros_ = 0;
+    ticketLoadMicros_ = 0;
+    
     pitQRData_.clear();
     ticketQRData_.clear();
-    pitImage_ = QPixmap();
-    ticketImage_ = QPixmap();
     
     pitImageLabel_->clear();
     pitImageLabel_->setText("No QR Code Loaded");
@@ -321,83 +372,297 @@ void TicketInspector::clearAll()
     ticketImageLabel_->setText("No QR Code Loaded");
     
     pitStatusLabel_->setText("Status: Waiting");
-    pitStatusLabel_->setStyleSheet("font-size: 13px; color: #666;");
+    AppStyle::setState(pitStatusLabel_, "state", QVariant());
     ticketStatusLabel_->setText("Status: Waiting");
-    ticketStatusLabel_->setStyleSheet("font-size: 13px; color: #666;");
+    AppStyle::setState(ticketStatusLabel_, "state", QVariant());
     
     verifyButton_->setEnabled(false);
+    liveAwaitingNewPair_ = false;
+    clearVerdict();
+}
+
+void TicketInspector::clearVerdict()
+{
+    // A verification still running belongs to the pair being replaced
+    if (verifyJob_ != 0) {
+        verifyWorker_->cancelAll();
+        verifyJob_ = 0;
+    }
     
     resultIconLabel_->clear();
     resultTextLabel_->setText("Awaiting verification...");
-    resultTextLabel_->setStyleSheet("font-size: 18px; font-weight: 600; color: #666;");
     detailsLabel_->setText("Load both QR codes and click 'Verify Ownership' to check if the ticket belongs to the user.");
-    detailsLabel_->setStyleSheet("font-size: 13px; color: #666; margin-top: 10px;");
-    resultPanel_->setStyleSheet("QWidget { background-color: white; border: 1px solid #e0e0e0; border-radius: 12px; padding: 24px; }");
+    setVerdictStyle(QString());
 }
 
 void TicketInspector::updateVerificationStatus(const TicketOwnership::VerificationResult& result)
 {
-    if (result.keysMatch && result.pitParsed && result.ticketParsed) {
+    if (result.isValid) {
         // Success - Keys Match
-        resultPanel_->setStyleSheet("QWidget { background-color: #d5f4e6; border: 2px solid #27ae60; border-radius: 12px; padding: 24px; }");
+        setVerdictStyle("valid");
         resultIconLabel_->setText("✓");
-        resultIconLabel_->setStyleSheet("font-size: 36px; color: #27ae60; font-weight: 600;");
         resultTextLabel_->setText("VALID: Ticket Belongs to User");
-        resultTextLabel_->setStyleSheet("font-size: 18px; font-weight: 600; color: #27ae60;");
         
         QString details = QString("• Booking Reference: %1\n"
                                   "• PIT Parsed: ✓\n"
                                   "• Ticket Parsed: ✓\n"
                                   "• Public Key Hashes Match: ✓\n"
+                                  "• PIT Signature: ✓\n"
                                   "• Verification: PASSED");
         details = details.arg(result.bookingReference);
         
         detailsLabel_->setText(details);
-        detailsLabel_->setStyleSheet("font-size: 13px; color: #27ae60; margin-top: 10px; font-weight: 600;");
         
     } else {
         // Failure - Keys Don't Match or Parse Error
-        resultPanel_->setStyleSheet("QWidget { background-color: #ffe6e6; border: 2px solid #eb0000; border-radius: 12px; padding: 24px; }");
+        setVerdictStyle("invalid");
         resultIconLabel_->setText("✗");
-        resultIconLabel_->setStyleSheet("font-size: 36px; color: #eb0000; font-weight: 600;");
         resultTextLabel_->setText("INVALID: Ticket Does NOT Belong to User");
-        resultTextLabel_->setStyleSheet("font-size: 18px; font-weight: 600; color: #eb0000;");
         
         QString details = QString("• Error: %1\n"
                                   "• PIT Parsed: %2\n"
                                   "• Ticket Parsed: %3\n"
                                   "• Public Key Hashes Match: %4\n"
+                                  "• PIT Signature: %5\n"
                                   "• Verification: FAILED");
         details = details.arg(result.errorMessage)
                         .arg(result.pitParsed ? "✓" : "✗")
                         .arg(result.ticketParsed ? "✓" : "✗")
-                        .arg(result.keysMatch ? "✓" : "✗");
+                        .arg(result.keysMatch ? "✓" : "✗")
+                        .arg(result.pitSignatureValid ? "✓" : "✗");
         
         detailsLabel_->setText(details);
-        detailsLabel_->setStyleSheet("font-size: 13px; color: #eb0000; margin-top: 10px; font-weight: 600;");
     }
 }
 
-QString TicketInspector::decodeQRFromImage(const QString& imagePath)
+void TicketInspector::setVerdictStyle(const QString& verdict)
+{
+    // Empty for the neutral look; each widget re-polishes only if its state changed
+    const QVariant value = verdict.isEmpty() ? QVariant() : QVariant(verdict);
+    for (QWidget* widget : std::initializer_list<QWidget*>{resultPanel_, resultIconLabel_, resultTextLabel_, detailsLabel_}) {
+        AppStyle::setState(widget, "verdict", value);
+    }
+}
+
+QString TicketInspector::defaultJournalPath()
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+    dir.mkpath(".");
+    return dir.filePath("scan-journal.sbbj");
+}
+
+bool TicketInspector::openJournal(const QString& path)
+{
+    try {
+        journal_ = std::make_unique<ScanJournal>(path.toStdString());
+    } catch (const std::exception& e) {
+        qWarning() << "Failed to open scan journal" << path << ":" << e.what();
+        journal_.reset();
+        return false;
+    }
+    qDebug() << "Recording scans to" << path;
+    return true;
+}
+
+ScanTimings TicketInspector::scanTimings(const TicketOwnership::VerificationResult& result, qint64 verifyMicros) const
+{
+    ScanTimings timings;
+    timings.loadMicros = pitLoadMicros_ + ticketLoadMicros_;
+    timings.decodeMicros = pitDecodeMicros_ + ticketDecodeMicros_ - timings.loadMicros;
+    timings.parseMicros = result.parseMicros;
+    timings.keyResolveMicros = result.keyResolveMicros;
+    timings.pitSignatureMicros = result.pitSignatureMicros;
+    timings.ticketSignatureMicros = result.ticketSignatureMicros;
+    timings.verifyMicros = verifyMicros;
+    timings.totalMicros = verifyTimer_.nsecsElapsed() / 1000;
+    timings.valid = result.isValid;
+    timings.bookingReference = result.bookingReference;
+    return timings;
+}
+
+ScanDiagnosticsPanel::QueueDepths TicketInspector::queueDepths() const
 {
-    // Use zbarimg command-line tool to decode QR code
-    // This requires zbar to be installed: brew install zbar (macOS) or apt install zbar-tools (Linux)
+    ScanDiagnosticsPanel::QueueDepths depths;
+    depths.verifyJobs = decodeWorker_->pendingJobs() + verifyWorker_->pendingJobs();
+    depths.handoffJobs = handoffWorker_->pendingJobs();
+    if (journal_) {
+        const ScanJournal::Stats stats = journal_->stats();
+        depths.journalBacklog = stats.appended - stats.committed;
+    }
+    depths.liveFramesDropped = liveScan_->framesDropped();
+    return depths;
+}
+
+void TicketInspector::journalResult(const TicketOwnership::VerificationResult& result, const ScanTimings& timings)
+{
+    if (!journal_) {
+        return;
+    }
+    
+    auto micros = [](qint64 value) { return static_cast<uint32_t>(qBound<qint64>(0, value, UINT32_MAX)); };
+    
+    ScanJournal::Entry entry;
+    entry.scanTime = QDateTime::currentMSecsSinceEpoch();
+    entry.pitTimestamp = result.pitTimestamp;
+    entry.ticketTimestamp = result.ticketTimestamp;
+    entry.flags = (result.isValid ? ScanJournal::Valid : 0)
+                | (result.pitParsed ? ScanJournal::PitParsed : 0)
+                | (result.ticketParsed ? ScanJournal::TicketParsed : 0)
+                | (result.keysMatch ? ScanJournal::KeysMatch : 0)
+                | (result.pitSignatureValid ? ScanJournal::PitSignatureValid : 0)
+                | (result.ticketSignatureValid ? ScanJournal::TicketSignatureValid : 0)
+                | (result.ticketRevoked ? ScanJournal::TicketRevoked : 0);
+    entry.decodeMicros = micros(timings.loadMicros + timings.decodeMicros);
+    entry.verifyMicros = micros(timings.verifyMicros);
+    entry.totalMicros = micros(timings.totalMicros);
+    
+    // "PIT:pubKeyHash:timestamp:signature"
+    entry.keyHash = pitQRData_.section(':', 1, 1).left(ScanJournal::kMaxKeyHash).toStdString();
+    entry.bookingRef = result.bookingReference.toStdString();
+    
+    // Only queues the entry; the journal commits on its own thread
+    journal_->append(entry);
+}
+
+bool TicketInspector::loadRevocationFile(const QString& path)
+{
+    if (!revocationList_) {
+        revocationList_ = std::make_shared<RevocationList>();
+    }
+    
+    const QString companyKey = companyPublicKey();
+    if (companyKey.isEmpty()) {
+        qWarning() << "Cannot check the signature of revocation list" << path << ": no company key (--company-key)";
+        return false;
+    }
+    
+    try {
+        revocationList_->loadFile(path.toStdString(), companyKey.toStdString());
+    } catch (const std::exception& e) {
+        qWarning() << "Failed to load revocation list" << path << ":" << e.what();
+        return false;
+    }
+    
+    TicketOwnership::setRevocationList(revocationList_);
+    qDebug() << "Revocation list version" << revocationList_->version() << "loaded with"
+             << revocationList_->size() << "revoked references";
+    return true;
+}
+
+void TicketInspector::startLiveScan(const QString& source)
+{
+    if (!liveScan_->start(source)) {
+        return;
+    }
+    
+    clearAll();
+    liveScanButton_->setText("Stop Live Scan");
+    loadPITButton_->setEnabled(false);
+    loadTicketButton_->setEnabled(false);
+    detailsLabel_->setText(QString("Live scan running on %1.\n"
+                                   "Show the PIT and the ticket to the camera; verification runs automatically.")
+                               .arg(source));
+}
+
+void TicketInspector::stopLiveScan()
+{
+    liveScan_->stop();
+    liveScanButton_->setText("Start Live Scan");
+    loadPITButton_->setEnabled(true);
+    loadTicketButton_->setEnabled(true);
+}
+
+void TicketInspector::toggleLiveScan()
+{
+    if (liveScan_->isRunning()) {
+        qDebug() << "Live scan stopped:" << liveScan_->framesDecoded() << "frames decoded,"
+                 << liveScan_->framesDropped() << "dropped";
+        stopLiveScan();
+        return;
+    }
     
-    QProcess process;
-    process.start("zbarimg", QStringList() << "--quiet" << "--raw" << imagePath);
+    QString directory = QFileDialog::getExistingDirectory(this, "Select Camera Frame Directory");
+    if (directory.isEmpty()) {
+        return;
+    }
     
-    if (!process.waitForFinished(5000)) {
-        qWarning() << "QR decode timeout or zbarimg not found";
-        return QString();
+    startLiveScan(directory);
+}
+
+void TicketInspector::handleLiveCode(const QString& payload, const QImage& frame, qint64 decodeMicros,
+                                     qint64 loadMicros)
+{
+    // acceptLiveCode takes the whole job, image loading included, like the decode workers report it
+    acceptLiveCode(payload, frame, decodeMicros + loadMicros, loadMicros);
+}
+
+void TicketInspector::acceptLiveCode(const QString& payload, const QImage& frame, qint64 decodeMicros,
+                                     qint64 loadMicros)
+{
+    const int version = TicketOwnership::payloadVersion(payload);
+    const bool isPIT = version != 0 && payload.startsWith("PIT");
+    const bool isTicket = version != 0 && payload.startsWith("TICKET");
+    if (!isPIT && !isTicket) {
+        qDebug() << "Live scan ignored unrelated QR code:" << payload;
+        return;
+    }
+    
+    // The camera keeps seeing the same code for many frames; only react to new ones
+    if ((isPIT && payload == pitQRData_) || (isTicket && payload == ticketQRData_)) {
+        return;
     }
     
-    if (process.exitCode() != 0) {
-        qWarning() << "QR decode failed:" << process.readAllStandardError();
-        return QString();
+    // After a verdict the next new code starts the next passenger's pair
+    if (liveAwaitingNewPair_) {
+        resetPair();
+    }
+    
+    QLabel* imageLabel = isPIT ? pitImageLabel_ : ticketImageLabel_;
+    QLabel* statusLabel = isPIT ? pitStatusLabel_ : ticketStatusLabel_;
+    clearVerdict();
+    (isPIT ? pitQRData_ : ticketQRData_) = payload;
+    (isPIT ? pitDecodeMicros_ : ticketDecodeMicros_) = decodeMicros;
+    (isPIT ? pitLoadMicros_ : ticketLoadMicros_) = loadMicros;
+    
+    if (!frame.isNull()) {
+        imageLabel->setPixmap(QPixmap::fromImage(frame));
+    } else {
+        imageLabel->setText("Scanned from camera");
     }
+    statusLabel->setText("Status: QR Code Scanned ✓");
+    AppStyle::setState(statusLabel, "state", "ok");
     
-    QString qrData = QString::fromUtf8(process.readAllStandardOutput()).trimmed();
-    qDebug() << "Decoded QR:" << qrData;
+    verifyButton_->setEnabled(!pitQRData_.isEmpty() && !ticketQRData_.isEmpty());
     
-    return qrData;
-}
\ No newline at end of file
+    // Auto-verify as soon as both halves of the pair are present
+    if (!pitQRData_.isEmpty() && !ticketQRData_.isEmpty()) {
+        verifyOwnership();
+        liveAwaitingNewPair_ = true;
+    }
+}
+
+bool TicketInspector::startHandoffServer(const QString& name)
+{
+    if (!handoffServer_) {
+        handoffServer_ = new ScanHandoffServer(this);
+        connect(handoffServer_, &ScanHandoffServer::frameReceived, this, [this](const QByteArray& imageData) {
+            handoffWorker_->decodeImageData(imageData, IMAGE_SIZE);
+        });
+    }
+    return handoffServer_->listen(name);
+}
+
+void TicketInspector::handleHandoffDecoded(quint64 /*jobId*/, const QString& payload, const QImage& preview,
+                                           qint64 elapsedMicros, qint64 loadMicros)
+{
+    // Handed-over frames are treated exactly like live-scan frames
+    if (!payload.isEmpty()) {
+        acceptLiveCode(payload, preview, elapsedMicros, loadMicros);
+    }
+}
+
+void TicketInspector::handleLiveScanError(const QString& message)
+{
+    stopLiveScan();
+    QMessageBox::warning(this, "Live Scan", message);
+}
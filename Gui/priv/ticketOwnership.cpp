@@ -1,11 +1,160 @@
 #include "ticketOwnership.h"
-#include "PgpKeyManager.h"
+#include "PayloadSignature.h"
+#include "RevocationList.h"
+#include "Ed25519Signer.h"
+#include "Clock.h"
 #include <QStringList>
-#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDebug>
-#include <rnp/rnp.h>
-#include <rnp/rnp_err.h>
+#include <QElapsedTimer>
+#include <atomic>
+#include <mutex>
+#include <optional>
+
+namespace {
+// Shared with worker threads, so always accessed through the atomic free functions
+std::shared_ptr<const RevocationList> g_revocationList;
+
+std::atomic<int> g_issuePayloadVersion{TicketOwnership::PayloadOpenPgpMessage};
+
+// Same access rule as g_revocationList
+std::shared_ptr<const PitValidityPolicy> g_pitPolicy = std::make_shared<PitValidityPolicy>();
+std::shared_ptr<const Clock> g_clock = std::make_shared<SystemWallClock>();
+
+PitValidityStats g_pitStats;
+
+// The company key rarely changes, so its parsed entry and imported OpenPGP
+// key are kept across scans and only rebuilt when a different key is passed
+std::shared_ptr<const PublicKeyDirectory::Entry> companyEntry(const QString& companyPublicKey)
+{
+    static std::mutex mutex;
+    static std::shared_ptr<const PublicKeyDirectory::Entry> cached;
+
+    std::string armored = companyPublicKey.toStdString();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!cached || cached->armored != armored) {
+        cached = std::make_shared<const PublicKeyDirectory::Entry>(PublicKeyDirectory::makeEntry(std::move(armored)));
+    }
+    return cached;
+}
+
+qint64 elapsedMicros(const QElapsedTimer& timer)
+{
+    return timer.nsecsElapsed() / 1000;
+}
+
+// QR fields as a ScanPayload, for the signature checks shared with PayloadVerifier
+ScanPayload signedPayload(ScanPayload::Kind kind, int payloadVersion, const KeyFingerprint& fingerprint,
+                          qint64 timestamp, const QString& signature)
+{
+    ScanPayload payload;
+    payload.kind = kind;
+    payload.version = payloadVersion;
+    payload.fingerprint = fingerprint;
+    payload.timestamp = timestamp;
+    const QByteArray signatureBytes = QByteArray::fromHex(signature.toLatin1());
+    payload.signature.assign(signatureBytes.begin(), signatureBytes.end());
+    return payload;
+}
+
+std::optional<KeyFingerprint> fingerprintField(const QString& field)
+{
+    QByteArray hex = field.toLatin1();
+    return KeyFingerprint::fromHex(std::string_view(hex.constData(), hex.size()));
+}
+
+// Scanned strings are untrusted: check size and separator count before
+// split() allocates a list entry per ':', and never log more than a prefix
+constexpr int kLoggedPrefix = 64;
+
+bool splitFields(const QString& qrData, int fieldCount, QStringList& out)
+{
+    if (qrData.size() > TicketOwnership::kMaxPayloadSize || qrData.count(QLatin1Char(':')) != fieldCount - 1) {
+        return false;
+    }
+    out = qrData.split(':');
+    return true;
+}
+}
+
+int TicketOwnership::payloadVersion(const QString& qrData)
+{
+    QString tag = qrData.section(':', 0, 0);
+    if (tag == "PIT" || tag == "TICKET") {
+        return PayloadOpenPgp;
+    }
+    if (tag == "PIT2" || tag == "TICKET2") {
+        return PayloadEd25519;
+    }
+    if (tag == "PIT3" || tag == "TICKET3") {
+        return PayloadOpenPgpMessage;
+    }
+    return 0;
+}
+
+QString TicketOwnership::pitTag(int payloadVersion)
+{
+    switch (payloadVersion) {
+    case PayloadEd25519:        return "PIT2";
+    case PayloadOpenPgpMessage: return "PIT3";
+    default:                    return "PIT";
+    }
+}
+
+QString TicketOwnership::ticketTag(int payloadVersion)
+{
+    switch (payloadVersion) {
+    case PayloadEd25519:        return "TICKET2";
+    case PayloadOpenPgpMessage: return "TICKET3";
+    default:                    return "TICKET";
+    }
+}
+
+void TicketOwnership::setIssuePayloadVersion(int payloadVersion)
+{
+    if (payloadVersion != PayloadEd25519 && payloadVersion != PayloadOpenPgpMessage) {
+        payloadVersion = PayloadOpenPgp;
+    }
+    g_issuePayloadVersion = payloadVersion;
+}
+
+int TicketOwnership::issuePayloadVersion()
+{
+    return g_issuePayloadVersion;
+}
+
+void TicketOwnership::setRevocationList(std::shared_ptr<const RevocationList> revocationList)
+{
+    std::atomic_store(&g_revocationList, std::move(revocationList));
+}
+
+std::shared_ptr<const RevocationList> TicketOwnership::revocationList()
+{
+    return std::atomic_load(&g_revocationList);
+}
+
+void TicketOwnership::setPitValidityPolicy(const PitValidityPolicy& policy)
+{
+    std::atomic_store(&g_pitPolicy, std::make_shared<const PitValidityPolicy>(policy));
+}
+
+PitValidityPolicy TicketOwnership::pitValidityPolicy()
+{
+    return *std::atomic_load(&g_pitPolicy);
+}
+
+void TicketOwnership::setClock(std::shared_ptr<const Clock> clock)
+{
+    if (!clock) {
+        clock = std::make_shared<SystemWallClock>();
+    }
+    std::atomic_store(&g_clock, std::move(clock));
+}
+
+PitValidityStats& TicketOwnership::pitValidityStats()
+{
+    return g_pitStats;
+}
 
 TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QString& pitQRData, const QString& ticketQRData)
 {
@@ -22,17 +171,40 @@ TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QStri
 
 TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QString& pitQRData, const QString& ticketQRData,
                                                                      const QString& userPublicKey, const QString& companyPublicKey)
+{
+    PublicKeyDirectory::Entry userKey;
+    if (!userPublicKey.isEmpty()) {
+        userKey = PublicKeyDirectory::makeEntry(userPublicKey.toStdString());
+    }
+    return verifyOwnership(pitQRData, ticketQRData, userKey, companyPublicKey);
+}
+
+TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QString& pitQRData, const QString& ticketQRData,
+                                                                     const PublicKeyDirectory::Entry& userKey,
+                                                                     const QString& companyPublicKey)
 {
     VerificationResult result;
+    const QString userPublicKey = QString::fromStdString(userKey.armored);
 
     // Parse PIT: "PIT:pubKeyHash:timestamp:signature"
     QString pitPubKeyHash;
     qint64 pitTimestamp = 0;
     QString pitSignature;
     
-    result.pitParsed = parsePIT(pitQRData, pitPubKeyHash, pitTimestamp, pitSignature);
+    PitValidityPolicy::Verdict pitVerdict = PitValidityPolicy::Verdict::Malformed;
+    QElapsedTimer stageTimer;
+    stageTimer.start();
+    result.pitParsed = parsePIT(pitQRData, pitPubKeyHash, pitTimestamp, pitSignature, &pitVerdict);
+    result.parseMicros = elapsedMicros(stageTimer);
+    g_pitStats.record(pitVerdict);
     if (!result.pitParsed) {
-        result.errorMessage = "Failed to parse PIT QR code";
+        if (pitVerdict == PitValidityPolicy::Verdict::Malformed) {
+            result.errorMessage = "Failed to parse PIT QR code";
+        } else if (pitVerdict == PitValidityPolicy::Verdict::FromFuture) {
+            result.errorMessage = "PIT timestamp is in the future - check the device clock";
+        } else {
+            result.errorMessage = "PIT has expired - ask the passenger to show the live code";
+        }
         return result;
     }
     
@@ -43,7 +215,9 @@ TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QStri
     qint64 ticketTimestamp = 0;
     QString ticketSignature;
     
+    stageTimer.restart();
     result.ticketParsed = parseTicket(ticketQRData, bookingRefAndHash, ticketTimestamp, ticketSignature);
+    result.parseMicros += elapsedMicros(stageTimer);
     if (!result.ticketParsed) {
         result.errorMessage = "Failed to parse ticket QR code";
         return result;
@@ -62,22 +236,29 @@ TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QStri
     result.bookingReference = bookingRef;
     result.ticketTimestamp = ticketTimestamp;
 
-    // Compare public key hashes from PIT and ticket
-    result.keysMatch = (pitPubKeyHash.toLower() == ticketPubKeyHash.toLower());
+    // Reject refunded, cancelled or fraud-flagged tickets even if their signature is valid
+    if (auto revoked = revocationList()) {
+        QByteArray refBytes = bookingRef.toUtf8();
+        result.ticketRevoked = revoked->isRevoked(std::string_view(refBytes.constData(), refBytes.size()));
+        if (result.ticketRevoked) {
+            result.errorMessage = "Ticket has been revoked (refunded, cancelled or flagged)";
+            return result;
+        }
+    }
+
+    // Compare key fingerprints from PIT and ticket
+    const std::optional<KeyFingerprint> pitFingerprint = fingerprintField(pitPubKeyHash);
+    const std::optional<KeyFingerprint> ticketFingerprint = fingerprintField(ticketPubKeyHash);
+    result.keysMatch = pitFingerprint && ticketFingerprint && *pitFingerprint == *ticketFingerprint;
     if (!result.keysMatch) {
         result.errorMessage = "Public key hashes do not match - ticket does not belong to this user";
         qDebug() << "PIT hash:" << pitPubKeyHash << "Ticket hash:" << ticketPubKeyHash;
         return result;
     }
     
-    // If userPublicKey is provided, verify it matches the hash and use for signature verification
+    // If userPublicKey is provided, verify it matches the fingerprint and use for signature verification
     if (!userPublicKey.isEmpty()) {
-        // Compute hash of provided public key
-        QByteArray publicKeyBytes = userPublicKey.toUtf8();
-        QByteArray computedHash = QCryptographicHash::hash(publicKeyBytes, QCryptographicHash::Sha256);
-        QString computedHashStr = computedHash.toHex().left(16);
-        
-        if (computedHashStr.toLower() != pitPubKeyHash.toLower()) {
+        if (userKey.fingerprint != *pitFingerprint) {
             result.errorMessage = "Provided public key does not match hash in PIT";
             result.isValid = false;
             return result;
@@ -92,7 +273,10 @@ TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QStri
 
     // Verify PIT signature (user signed their own public key + timestamp)
     if (!userPublicKey.isEmpty()) {
-        result.pitSignatureValid = verifyPITSignature(userPublicKey, pitTimestamp, pitSignature);
+        stageTimer.restart();
+        result.pitSignatureValid = verifyPITSignature(userKey, pitTimestamp, pitSignature,
+                                                      payloadVersion(pitQRData));
+        result.pitSignatureMicros = elapsedMicros(stageTimer);
         if (!result.pitSignatureValid) {
             result.errorMessage = "PIT signature verification failed - invalid identity token";
             return result;
@@ -101,9 +285,11 @@ TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QStri
 
     // Verify ticket signature if company public key is provided
     if (!companyPublicKey.isEmpty()) {
-        result.ticketSignatureValid = verifyTicketSignature(userPublicKey, bookingRef, 
+        stageTimer.restart();
+        result.ticketSignatureValid = verifyTicketSignature(userPublicKey, *pitFingerprint, bookingRef, 
                                                            ticketTimestamp, ticketSignature, 
-                                                           companyPublicKey);
+                                                           companyPublicKey, payloadVersion(ticketQRData));
+        result.ticketSignatureMicros = elapsedMicros(stageTimer);
         if (!result.ticketSignatureValid) {
             result.errorMessage = "Ticket signature verification failed - invalid or forged ticket";
             return result;
@@ -133,37 +319,47 @@ TicketOwnership::VerificationResult TicketOwnership::verifyOwnership(const QStri
 }
 
 bool TicketOwnership::parsePIT(const QString& pitQRData, QString& outPublicKey, 
-                               qint64& outTimestamp, QString& outSignature)
+                               qint64& outTimestamp, QString& outSignature,
+                               PitValidityPolicy::Verdict* outVerdict)
 {
-    // Expected format: "PIT:pubKeyHash:timestamp:signature"
-    QStringList parts = pitQRData.split(':');
-    
-    if (parts.size() != 4 || parts[0] != "PIT") {
-        qWarning() << "Invalid PIT format. Expected 'PIT:pubKeyHash:timestamp:signature', got:" << pitQRData;
+    // Expected format: "PIT:pubKeyHash:timestamp:signature" (or "PIT2:...", "PIT3:...")
+    if (outVerdict) {
+        *outVerdict = PitValidityPolicy::Verdict::Malformed;
+    }
+    QStringList parts;
+    if (!splitFields(pitQRData, 4, parts) || parts[0] != pitTag(payloadVersion(pitQRData))) {
+        qWarning() << "Invalid PIT format. Expected 'PIT:pubKeyHash:timestamp:signature', got:"
+                   << pitQRData.left(kLoggedPrefix) << "(" << pitQRData.size() << "chars)";
         return false;
     }
 
-    // Extract public key hash (16 hex chars = 8 bytes of SHA-256)
+    // Extract key fingerprint (16 hex chars, see KeyFingerprint)
     outPublicKey = parts[1]; // Store hash temporarily in outPublicKey
     
     bool ok = false;
     outTimestamp = parts[2].toLongLong(&ok);
-    if (!ok) {
+    if (!ok || outTimestamp < 0) {
         qWarning() << "Invalid timestamp in PIT:" << parts[2];
         return false;
     }
 
-    // Check if PIT is older than 20 seconds
-    qint64 currentTime = QDateTime::currentSecsSinceEpoch();
-    qint64 age = currentTime - outTimestamp;
+    // Check the timestamp against the validity policy
+    const std::shared_ptr<const PitValidityPolicy> policy = std::atomic_load(&g_pitPolicy);
+    const qint64 currentTime = std::atomic_load(&g_clock)->nowSeconds();
+    const PitValidityPolicy::Verdict verdict = policy->check(outTimestamp, currentTime);
+    if (outVerdict) {
+        *outVerdict = verdict;
+    }
     
-    if (age > 20) {
-        qWarning() << "PIT expired: Age is" << age << "seconds (max 20 seconds allowed)";
+    if (verdict == PitValidityPolicy::Verdict::Expired) {
+        qWarning() << "PIT expired: Age is" << currentTime - outTimestamp << "seconds (max"
+                   << policy->maxAgeSeconds + policy->graceSeconds << "seconds allowed)";
         return false;
     }
     
-    if (age < 0) {
-        qWarning() << "PIT timestamp is in the future (clock skew)";
+    if (verdict == PitValidityPolicy::Verdict::FromFuture) {
+        qWarning() << "PIT timestamp is" << outTimestamp - currentTime << "seconds in the future (clock skew, max"
+                   << policy->futureSkewSeconds << "seconds allowed)";
         return false;
     }
 
@@ -175,11 +371,11 @@ bool TicketOwnership::parsePIT(const QString& pitQRData, QString& outPublicKey,
 bool TicketOwnership::parseTicket(const QString& ticketQRData, QString& outBookingRef, 
                                   qint64& outTimestamp, QString& outSignature)
 {
-    // Expected format: "TICKET:bookingRef:timestamp:userPubKeyHash:companySignature"
-    QStringList parts = ticketQRData.split(':');
-    
-    if (parts.size() != 5 || parts[0] != "TICKET") {
-        qWarning() << "Invalid ticket format. Expected 'TICKET:bookingRef:timestamp:userPubKeyHash:signature', got:" << ticketQRData;
+    // Expected format: "TICKET:bookingRef:timestamp:userPubKeyHash:companySignature" (or "TICKET2:...", "TICKET3:...")
+    QStringList parts;
+    if (!splitFields(ticketQRData, 5, parts) || parts[0] != ticketTag(payloadVersion(ticketQRData))) {
+        qWarning() << "Invalid ticket format. Expected 'TICKET:bookingRef:timestamp:userPubKeyHash:signature', got:"
+                   << ticketQRData.left(kLoggedPrefix) << "(" << ticketQRData.size() << "chars)";
         return false;
     }
 
@@ -187,7 +383,7 @@ bool TicketOwnership::parseTicket(const QString& ticketQRData, QString& outBooki
     
     bool ok = false;
     outTimestamp = parts[2].toLongLong(&ok);
-    if (!ok) {
+    if (!ok || outTimestamp < 0) {
         qWarning() << "Invalid timestamp in ticket:" << parts[2];
         return false;
     }
@@ -202,201 +398,85 @@ bool TicketOwnership::parseTicket(const QString& ticketQRData, QString& outBooki
 }
 
 bool TicketOwnership::verifyPITSignature(const QString& publicKey, qint64 timestamp, 
-                                         const QString& signature)
+                                         const QString& signature, int payloadVersion)
+{
+    // Versions 2 and 3 sign the key's fingerprint: one key parse gives it and the verification key
+    PublicKeyDirectory::Entry key;
+    key.armored = publicKey.toStdString();
+    if (!publicKey.isEmpty() && payloadVersion != PayloadOpenPgp) {
+        key = PublicKeyDirectory::makeEntry(std::move(key.armored));
+    }
+    return verifyPITSignature(key, timestamp, signature, payloadVersion);
+}
+
+bool TicketOwnership::verifyPITSignature(const PublicKeyDirectory::Entry& userKey, qint64 timestamp,
+                                         const QString& signature, int payloadVersion)
 {
-    if (publicKey.isEmpty() || signature.isEmpty()) {
+    if (userKey.armored.empty() || signature.isEmpty()) {
         qWarning() << "Cannot verify PIT signature: missing public key or signature";
         return false;
     }
-
-    try {
-        // Create RNP FFI for verification
-        rnp_ffi_t ffi = nullptr;
-        if (rnp_ffi_create(&ffi, "GPG", "GPG") != RNP_SUCCESS || !ffi) {
-            qWarning() << "Failed to create RNP FFI for verification";
-            return false;
-        }
-
-        // Import public key
-        QByteArray publicKeyBytes = publicKey.toUtf8();
-        rnp_input_t key_input = nullptr;
-        if (rnp_input_from_memory(&key_input,
-                                  reinterpret_cast<const uint8_t*>(publicKeyBytes.constData()),
-                                  publicKeyBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create input for public key";
-            return false;
-        }
-
-        if (rnp_import_keys(ffi, key_input, RNP_LOAD_SAVE_PUBLIC_KEYS, nullptr) != RNP_SUCCESS) {
-            rnp_input_destroy(key_input);
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to import public key";
-            return false;
-        }
-        rnp_input_destroy(key_input);
-
-        // Reconstruct the signed data: publicKey + timestamp
-        QString dataToVerify = publicKey + QString::number(timestamp);
-        QByteArray dataBytes = dataToVerify.toUtf8();
-
-        // Convert hex signature back to binary
-        QByteArray signatureBytes = QByteArray::fromHex(signature.toUtf8());
-
-        // Create inputs for verification
-        rnp_input_t data_input = nullptr;
-        if (rnp_input_from_memory(&data_input,
-                                  reinterpret_cast<const uint8_t*>(dataBytes.constData()),
-                                  dataBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create data input";
-            return false;
-        }
-
-        rnp_input_t sig_input = nullptr;
-        if (rnp_input_from_memory(&sig_input,
-                                  reinterpret_cast<const uint8_t*>(signatureBytes.constData()),
-                                  signatureBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create signature input";
-            return false;
-        }
-
-        // Verify the signature
-        rnp_op_verify_t verify_op = nullptr;
-        if (rnp_op_verify_detached_create(&verify_op, ffi, data_input, sig_input) != RNP_SUCCESS) {
-            rnp_input_destroy(sig_input);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create verify operation";
-            return false;
-        }
-
-        rnp_result_t result = rnp_op_verify_execute(verify_op);
-        bool isValid = (result == RNP_SUCCESS);
-
-        // Cleanup
-        rnp_op_verify_destroy(verify_op);
-        rnp_input_destroy(sig_input);
-        rnp_input_destroy(data_input);
-        rnp_ffi_destroy(ffi);
-
-        return isValid;
-
-    } catch (const std::exception& e) {
-        qWarning() << "Exception during PIT signature verification:" << e.what();
+    if (payloadVersion == PayloadEd25519 && userKey.fingerprint.isNull()) {
+        qWarning() << "Public key is not an Ed25519 key";
         return false;
     }
+    return PayloadSignature::verifyPit(
+        signedPayload(ScanPayload::Kind::Pit, payloadVersion, userKey.fingerprint, timestamp, signature), userKey);
 }
 
 bool TicketOwnership::verifyTicketSignature(const QString& userPublicKey, const QString& bookingRef,
                                             qint64 timestamp, const QString& signature,
-                                            const QString& companyPublicKey)
+                                            const QString& companyPublicKey, int payloadVersion)
+{
+    KeyFingerprint userFingerprint;
+    if (payloadVersion == PayloadEd25519 || payloadVersion == PayloadOpenPgpMessage) {
+        userFingerprint = keyFingerprint(userPublicKey);
+    }
+    return verifyTicketSignature(userPublicKey, userFingerprint, bookingRef, timestamp, signature,
+                                 companyPublicKey, payloadVersion);
+}
+
+bool TicketOwnership::verifyTicketSignature(const QString& userPublicKey, const KeyFingerprint& userFingerprint,
+                                            const QString& bookingRef, qint64 timestamp, const QString& signature,
+                                            const QString& companyPublicKey, int payloadVersion)
 {
     if (companyPublicKey.isEmpty() || signature.isEmpty()) {
         qWarning() << "Cannot verify ticket signature: missing company public key or signature";
         return false;
     }
 
-    try {
-        // Create RNP FFI for verification
-        rnp_ffi_t ffi = nullptr;
-        if (rnp_ffi_create(&ffi, "GPG", "GPG") != RNP_SUCCESS || !ffi) {
-            qWarning() << "Failed to create RNP FFI for ticket verification";
-            return false;
-        }
-
-        // Import company's public key
-        QByteArray publicKeyBytes = companyPublicKey.toUtf8();
-        rnp_input_t key_input = nullptr;
-        if (rnp_input_from_memory(&key_input,
-                                  reinterpret_cast<const uint8_t*>(publicKeyBytes.constData()),
-                                  publicKeyBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create input for company public key";
-            return false;
-        }
-
-        if (rnp_import_keys(ffi, key_input, RNP_LOAD_SAVE_PUBLIC_KEYS, nullptr) != RNP_SUCCESS) {
-            rnp_input_destroy(key_input);
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to import company public key";
-            return false;
-        }
-        rnp_input_destroy(key_input);
-
-        // Reconstruct the signed data: userPublicKey + bookingRef + timestamp
-        QString dataToVerify = userPublicKey + bookingRef + QString::number(timestamp);
-        QByteArray dataBytes = dataToVerify.toUtf8();
-
-        // Convert hex signature back to binary
-        QByteArray signatureBytes = QByteArray::fromHex(signature.toUtf8());
-
-        // Create inputs for verification
-        rnp_input_t data_input = nullptr;
-        if (rnp_input_from_memory(&data_input,
-                                  reinterpret_cast<const uint8_t*>(dataBytes.constData()),
-                                  dataBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create data input for ticket verification";
-            return false;
-        }
-
-        rnp_input_t sig_input = nullptr;
-        if (rnp_input_from_memory(&sig_input,
-                                  reinterpret_cast<const uint8_t*>(signatureBytes.constData()),
-                                  signatureBytes.size(),
-                                  false) != RNP_SUCCESS) {
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create signature input for ticket verification";
-            return false;
-        }
-
-        // Verify the company's signature
-        rnp_op_verify_t verify_op = nullptr;
-        if (rnp_op_verify_detached_create(&verify_op, ffi, data_input, sig_input) != RNP_SUCCESS) {
-            rnp_input_destroy(sig_input);
-            rnp_input_destroy(data_input);
-            rnp_ffi_destroy(ffi);
-            qWarning() << "Failed to create verify operation for ticket";
-            return false;
-        }
-
-        rnp_result_t result = rnp_op_verify_execute(verify_op);
-        bool isValid = (result == RNP_SUCCESS);
+    // Parsed and imported once; version 2 also needs its Ed25519 point
+    const std::shared_ptr<const PublicKeyDirectory::Entry> companyKey = companyEntry(companyPublicKey);
+    if (payloadVersion == PayloadEd25519 && companyKey->fingerprint.isNull()) {
+        qWarning() << "Company public key is not an Ed25519 key";
+        return false;
+    }
 
-        // Cleanup
-        rnp_op_verify_destroy(verify_op);
-        rnp_input_destroy(sig_input);
-        rnp_input_destroy(data_input);
-        rnp_ffi_destroy(ffi);
+    PublicKeyDirectory::Entry userKey;
+    userKey.armored = userPublicKey.toStdString();
+    userKey.fingerprint = userFingerprint;
 
-        return isValid;
+    ScanPayload ticket = signedPayload(ScanPayload::Kind::Ticket, payloadVersion, userFingerprint, timestamp, signature);
+    ticket.bookingRef = bookingRef.toStdString();
+    return PayloadSignature::verifyTicket(ticket, userKey, *companyKey);
+}
 
-    } catch (const std::exception& e) {
-        qWarning() << "Exception during ticket signature verification:" << e.what();
-        return false;
-    }
+KeyFingerprint TicketOwnership::keyFingerprint(const QString& publicKey)
+{
+    auto key = Ed25519Signer::publicKeyFromOpenPgp(publicKey.toStdString());
+    return key ? KeyFingerprint::fromEd25519(*key) : KeyFingerprint();
 }
 
 QString TicketOwnership::extractUserPublicKeyFromTicket(const QString& ticketQRData)
 {
     // New format: "TICKET:bookingRef:timestamp:userPubKeyHash:companySignature"
-    QStringList parts = ticketQRData.split(':');
-    
-    if (parts.size() != 5 || parts[0] != "TICKET") {
+    QStringList parts;
+    if (!splitFields(ticketQRData, 5, parts) || parts[0] != ticketTag(payloadVersion(ticketQRData))) {
         qWarning() << "Invalid ticket format for key extraction";
         return QString();
     }
     
-    // Return the user's public key hash (16 hex chars)
+    // Return the user's key fingerprint (16 hex chars)
     // Note: This returns the HASH, not the full public key
     // The full key would need to be provided separately for signature verification
     return parts[3];
@@ -1,10 +1,13 @@
 #include "topBar.h"
+#include "appStyle.h"
+#include "iconCache.h"
 
 TopBar::TopBar(QWidget* parent)
     : QWidget(parent)
 {
     // Red SSB background
-    setStyleSheet("background-color: #ec0001");
+    AppStyle::setRole(this, "header");
+    setAttribute(Qt::WA_StyledBackground);
 
     auto layout = new QHBoxLayout(this);
     layout->setContentsMargins(16, 12, 16, 12); // left, top, right, bottom padding
@@ -13,12 +16,9 @@ TopBar::TopBar(QWidget* parent)
     auto ssbBanner = new QLabel(this);
     ssbBanner->setAlignment(Qt::AlignCenter);
     ssbBanner->setFixedSize(48, 48);
-    ssbBanner->setStyleSheet("background: transparent; border: none; padding: 0;");
+    AppStyle::setRole(ssbBanner, "logo");
 
-    QPixmap pix("icons/SBB_logo.svg");  
-    if (!pix.isNull()) {
-        ssbBanner->setPixmap(pix.scaled(ssbBanner->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    }
+    ssbBanner->setPixmap(IconCache::pixmap("SBB_logo.svg", ssbBanner->size()));
 
     layout->addWidget(ssbBanner, 0, Qt::AlignCenter);
 
@@ -0,0 +1,119 @@
+#include "verificationWorker.h"
+#include "qrCodeDecoder.h"
+#include "scanVerifier.h"
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+namespace {
+
+struct DecodedImage
+{
+    QString payload;
+    QImage preview;
+    qint64 loadMicros = 0;  // reading the image and scaling the preview
+};
+
+DecodedImage decodeImageFile(const QString& imagePath, int previewSize)
+{
+    DecodedImage decoded;
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    QImage image(imagePath);
+    if (image.isNull()) {
+        return decoded;
+    }
+    decoded.preview = image.scaled(previewSize, previewSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    decoded.loadMicros = loadTimer.nsecsElapsed() / 1000;
+    decoded.payload = QRCodeDecoder::decodeFromFile(imagePath);
+    return decoded;
+}
+
+DecodedImage decodeImageBytes(const QByteArray& imageData, int previewSize)
+{
+    DecodedImage decoded;
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    QImage image = QImage::fromData(imageData);
+    if (image.isNull()) {
+        return decoded;
+    }
+    decoded.preview = image.scaled(previewSize, previewSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    decoded.loadMicros = loadTimer.nsecsElapsed() / 1000;
+    const QStringList symbols = QRCodeDecoder::decodeAllFromData(imageData);
+    decoded.payload = symbols.isEmpty() ? QString() : symbols.first();
+    return decoded;
+}
+
+}
+
+VerificationWorker::VerificationWorker(QObject* parent)
+    : QObject(parent)
+{
+    worker_ = new QObject();
+    worker_->moveToThread(&workerThread_);
+    connect(&workerThread_, &QThread::finished, worker_, &QObject::deleteLater);
+    workerThread_.start();
+}
+
+VerificationWorker::~VerificationWorker()
+{
+    // A running decode is bounded by the zbarimg timeout
+    cancelAll();
+    workerThread_.quit();
+    workerThread_.wait();
+}
+
+template <typename Job, typename Deliver>
+quint64 VerificationWorker::submit(Job job, Deliver deliver)
+{
+    const quint64 jobId = nextJobId_++;
+    ++pendingJobs_;
+    
+    QMetaObject::invokeMethod(worker_, [this, jobId, job, deliver]() {
+        // Runs on the worker thread; cancelled jobs still report back so
+        // pendingJobs_ stays balanced, but skip the work itself
+        const bool stale = isStale(jobId);
+        QElapsedTimer timer;
+        timer.start();
+        auto output = stale ? decltype(job())() : job();
+        const qint64 elapsedMicros = timer.nsecsElapsed() / 1000;
+        
+        QMetaObject::invokeMethod(this, [this, jobId, stale, output, elapsedMicros, deliver]() {
+            --pendingJobs_;
+            if (!stale && !isStale(jobId)) {
+                deliver(jobId, output, elapsedMicros);
+            }
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+    
+    return jobId;
+}
+
+quint64 VerificationWorker::decodeImage(const QString& imagePath, int previewSize)
+{
+    return submit([imagePath, previewSize]() { return decodeImageFile(imagePath, previewSize); },
+                  [this](quint64 jobId, const DecodedImage& decoded, qint64 elapsedMicros) {
+                      emit imageDecoded(jobId, decoded.payload, decoded.preview, elapsedMicros, decoded.loadMicros);
+                  });
+}
+
+quint64 VerificationWorker::decodeImageData(const QByteArray& imageData, int previewSize)
+{
+    return submit([imageData, previewSize]() { return decodeImageBytes(imageData, previewSize); },
+                  [this](quint64 jobId, const DecodedImage& decoded, qint64 elapsedMicros) {
+                      emit imageDecoded(jobId, decoded.payload, decoded.preview, elapsedMicros, decoded.loadMicros);
+                  });
+}
+
+quint64 VerificationWorker::verify(const QString& pitQRData, const QString& ticketQRData)
+{
+    return submit([pitQRData, ticketQRData]() { return ScanVerifier::verifyPayloads(pitQRData, ticketQRData); },
+                  [this](quint64 jobId, const TicketOwnership::VerificationResult& result, qint64 elapsedMicros) {
+                      emit verificationFinished(jobId, result, elapsedMicros);
+                  });
+}
+
+void VerificationWorker::cancelAll()
+{
+    firstLiveJob_ = nextJobId_;
+}
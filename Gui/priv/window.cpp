@@ -1,4 +1,8 @@
 #include "window.h"
+#include "appStyle.h"
+#include "iconCache.h"
+#include "keyDirectory.h"
+#include <QDateTime>
 #include <QPalette>
 #include <QVBoxLayout>
 
@@ -47,7 +51,7 @@ void Window::setupMainUI()
 
     // Create three persistent pages with modern SBB styling
     homePage_ = new QWidget(this);
-    homePage_->setStyleSheet("background-color: #f5f5f5;"); // Light gray background like SBB app
+    AppStyle::setRole(homePage_, "page"); // Light gray background like SBB app
 
     // Add LocationSelection to home page with better styling
     auto homeLayout = new QVBoxLayout(homePage_);
@@ -56,7 +60,7 @@ void Window::setupMainUI()
     
     // Add header section
     auto headerWidget = new QWidget(homePage_);
-    headerWidget->setStyleSheet("background-color: #eb0000;"); // SBB red
+    AppStyle::setRole(headerWidget, "header"); // SBB red
     auto headerLayout = new QHBoxLayout(headerWidget);
     headerLayout->setContentsMargins(16, 10, 16, 10);
     headerLayout->setSpacing(12);
@@ -65,16 +69,13 @@ void Window::setupMainUI()
     auto logoLabel = new QLabel(headerWidget);
     logoLabel->setAlignment(Qt::AlignCenter);
     logoLabel->setFixedSize(40, 40);
-    logoLabel->setStyleSheet("background: transparent; border: none; padding: 0;");
-    QPixmap logoPix("icons/SBB_logo.svg");
-    if (!logoPix.isNull()) {
-        logoLabel->setPixmap(logoPix.scaled(logoLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    }
+    AppStyle::setRole(logoLabel, "logo");
+    logoLabel->setPixmap(IconCache::pixmap("SBB_logo.svg", logoLabel->size()));
     headerLayout->addWidget(logoLabel);
     
     // Add title text next to logo
     auto titleLabel = new QLabel("Book Your Journey", headerWidget);
-    titleLabel->setStyleSheet("color: white; font-size: 18px; font-weight: 600;");
+    AppStyle::setRole(titleLabel, "headerTitle");
     headerLayout->addWidget(titleLabel);
     headerLayout->addStretch();
     
@@ -82,15 +83,11 @@ void Window::setupMainUI()
     
     // Add location selection in a card
     auto contentWidget = new QWidget(homePage_);
-    contentWidget->setStyleSheet("background-color: transparent;");
     auto contentLayout = new QVBoxLayout(contentWidget);
     contentLayout->setContentsMargins(20, 20, 20, 20);
     
     locationSelection_ = new LocationSelection(contentWidget);
     locationSelection_->setMaximumWidth(500);
-    locationSelection_->setStyleSheet(
-        "QWidget { background-color: white; border-radius: 12px; padding: 20px; }"
-    );
     contentLayout->addWidget(locationSelection_, 0, Qt::AlignCenter | Qt::AlignTop);
     contentLayout->addStretch();
     
@@ -105,7 +102,7 @@ void Window::setupMainUI()
             
             // Set user's public key for ticket signing
             if (isLoggedIn_ && !accountInfo_.publicKey().isEmpty()) {
-                ticketInfo_.setUserPublicKey(accountInfo_.publicKey());
+                ticketInfo_.setUserPublicKey(accountInfo_.publicKey(), accountInfo_.keyFingerprint());
             }
             
             qDebug() << "Booking created:" << ticketInfo_.bookingReference() 
@@ -113,7 +110,18 @@ void Window::setupMainUI()
             
             // Add ticket to the list
             bookingReference_->addTicket(ticketInfo_);
-            
+
+            // Record the issue for the end-of-day scan audit
+            try {
+                sharedIssuedTicketLog().append({
+                    ticketInfo_.bookingReference().toStdString(),
+                    ticketInfo_.userKeyFingerprint().toHex(),
+                    QDateTime::currentSecsSinceEpoch(),
+                    date.toString(Qt::ISODate).toStdString()});
+            } catch (const std::exception& e) {
+                qWarning() << "Failed to record issued ticket:" << e.what();
+            }
+
             // Clear the form
             locationSelection_->clear();
             
@@ -122,7 +130,7 @@ void Window::setupMainUI()
         });
 
     ticketPage_ = new QWidget(this);
-    ticketPage_->setStyleSheet("background-color: #f5f5f5;"); // Light gray background like SBB app
+    AppStyle::setRole(ticketPage_, "page"); // Light gray background like SBB app
 
     // Add BookingReference to ticket page with modern styling
     auto ticketLayout = new QVBoxLayout(ticketPage_);
@@ -131,7 +139,7 @@ void Window::setupMainUI()
     
     // Add header section for ticket page
     auto ticketHeaderWidget = new QWidget(ticketPage_);
-    ticketHeaderWidget->setStyleSheet("background-color: #eb0000;"); // SBB red
+    AppStyle::setRole(ticketHeaderWidget, "header"); // SBB red
     auto ticketHeaderLayout = new QHBoxLayout(ticketHeaderWidget);
     ticketHeaderLayout->setContentsMargins(16, 10, 16, 10);
     ticketHeaderLayout->setSpacing(12);
@@ -140,16 +148,13 @@ void Window::setupMainUI()
     auto ticketLogoLabel = new QLabel(ticketHeaderWidget);
     ticketLogoLabel->setAlignment(Qt::AlignCenter);
     ticketLogoLabel->setFixedSize(40, 40);
-    ticketLogoLabel->setStyleSheet("background: transparent; border: none; padding: 0;");
-    QPixmap ticketLogoPix("icons/SBB_logo.svg");
-    if (!ticketLogoPix.isNull()) {
-        ticketLogoLabel->setPixmap(ticketLogoPix.scaled(ticketLogoLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    }
+    AppStyle::setRole(ticketLogoLabel, "logo");
+    ticketLogoLabel->setPixmap(IconCache::pixmap("SBB_logo.svg", ticketLogoLabel->size()));
     ticketHeaderLayout->addWidget(ticketLogoLabel);
     
     // Add title text next to logo
     auto ticketTitleLabel = new QLabel("My Tickets", ticketHeaderWidget);
-    ticketTitleLabel->setStyleSheet("color: white; font-size: 18px; font-weight: 600;");
+    AppStyle::setRole(ticketTitleLabel, "headerTitle");
     ticketHeaderLayout->addWidget(ticketTitleLabel);
     ticketHeaderLayout->addStretch();
     
@@ -157,13 +162,11 @@ void Window::setupMainUI()
     
     // Add booking reference with card styling
     bookingReference_ = new BookingReference(ticketPage_);
-    bookingReference_->setCompanyInfo(&companyInfo_); // Set company info for signing tickets
-    bookingReference_->setStyleSheet("background-color: transparent;");
     ticketLayout->addWidget(bookingReference_, 1); // stretch to fill
     ticketPage_->setLayout(ticketLayout);
 
     idPage_ = new QWidget(this);
-    idPage_->setStyleSheet("background-color: #f5f5f5;"); // Light gray background like SBB app
+    AppStyle::setRole(idPage_, "page"); // Light gray background like SBB app
 
     // Add IdentificationToken to ID page with modern styling
     auto idLayout = new QVBoxLayout(idPage_);
@@ -172,7 +175,7 @@ void Window::setupMainUI()
     
     // Add header section for ID page
     auto idHeaderWidget = new QWidget(idPage_);
-    idHeaderWidget->setStyleSheet("background-color: #eb0000;"); // SBB red
+    AppStyle::setRole(idHeaderWidget, "header"); // SBB red
     auto idHeaderLayout = new QHBoxLayout(idHeaderWidget);
     idHeaderLayout->setContentsMargins(16, 10, 16, 10);
     idHeaderLayout->setSpacing(12);
@@ -181,16 +184,13 @@ void Window::setupMainUI()
     auto idLogoLabel = new QLabel(idHeaderWidget);
     idLogoLabel->setAlignment(Qt::AlignCenter);
     idLogoLabel->setFixedSize(40, 40);
-    idLogoLabel->setStyleSheet("background: transparent; border: none; padding: 0;");
-    QPixmap idLogoPix("icons/SBB_logo.svg");
-    if (!idLogoPix.isNull()) {
-        idLogoLabel->setPixmap(idLogoPix.scaled(idLogoLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    }
+    AppStyle::setRole(idLogoLabel, "logo");
+    idLogoLabel->setPixmap(IconCache::pixmap("SBB_logo.svg", idLogoLabel->size()));
     idHeaderLayout->addWidget(idLogoLabel);
     
     // Add title text next to logo
     auto idTitleLabel = new QLabel("My Personal Identity Token", idHeaderWidget);
-    idTitleLabel->setStyleSheet("color: white; font-size: 18px; font-weight: 600;");
+    AppStyle::setRole(idTitleLabel, "headerTitle");
     idHeaderLayout->addWidget(idTitleLabel);
     idHeaderLayout->addStretch();
     
@@ -235,13 +235,20 @@ void Window::handleLoginSuccess(const AccountInfo& account)
     accountInfo_ = account;
     isLoggedIn_ = true;
 
-    // Set the public and private keys in the identification token to create signed anonymous token
-    identificationToken_->setIdentificationToken(account.publicKey(), account.privateKey());
+    // Register the public key so inspectors can resolve it from the fingerprint in the PIT
+    try {
+        sharedKeyDirectory().registerKey(account.keyFingerprint().toHex(), account.publicKey().toStdString());
+    } catch (const std::exception& e) {
+        qWarning() << "Failed to register public key:" << e.what();
+    }
+
+    // Hand the unlocked signing key to the identification token to create signed anonymous tokens
+    identificationToken_->setIdentificationToken(account.publicKey(), account.signingKey());
 
     // Switch to main app view
     mainStacked_->setCurrentIndex(1);
 
     qDebug() << "User logged in:" << account.email();
     qDebug() << "Public key length:" << account.publicKey().length();
-    qDebug() << "Private key length:" << account.privateKey().length();
+    qDebug() << "Signing key locked in memory:" << (account.signingKey() && account.signingKey()->isMemoryLocked());
 }
\ No newline at end of file
@@ -1,22 +1,29 @@
 #pragma once
 #include <QString>
+#include <memory>
+#include "KeyFingerprint.h"
+#include "SigningKey.h"
 
 class AccountInfo
 {
 public:
     AccountInfo() = default;
-    AccountInfo(const QString& email, const QString& publicKey, const QString& privateKey);
+    AccountInfo(const QString& email, const QString& publicKey, std::shared_ptr<const SigningKey> signingKey);
 
     QString email() const { return email_; }
     QString publicKey() const { return publicKey_; }
-    QString privateKey() const { return privateKey_; }
+    // Taken from the signing key at login; null without one
+    const KeyFingerprint& keyFingerprint() const { return keyFingerprint_; }
+    // Unlocked signing key; copies of AccountInfo share it, never the secret itself
+    const std::shared_ptr<const SigningKey>& signingKey() const { return signingKey_; }
     bool isValid() const { return !email_.isEmpty() && !publicKey_.isEmpty(); }
 
-    void setKeys(const QString& email, const QString& publicKey, const QString& privateKey);
+    void setKeys(const QString& email, const QString& publicKey, std::shared_ptr<const SigningKey> signingKey);
     void clear();
 
 private:
     QString email_;
     QString publicKey_;
-    QString privateKey_;
+    KeyFingerprint keyFingerprint_;
+    std::shared_ptr<const SigningKey> signingKey_;
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include <QVariant>
+
+class QApplication;
+class QWidget;
+
+// Application-wide stylesheet. Qt parses it once at startup; widgets pick a
+// look with the "role" property and switch states (validation errors,
+// verdicts) through further dynamic properties, instead of calling
+// setStyleSheet, which re-parses and re-polishes the widget and all its
+// children on every call.
+class AppStyle
+{
+public:
+    // Install the stylesheet; call once, before any window is constructed
+    static void install(QApplication& app);
+
+    // Select the widget's rules; set before the widget is first shown
+    static void setRole(QWidget* widget, const char* role);
+
+    // Change a state property and re-polish only this widget (no-op if unchanged)
+    static void setState(QWidget* widget, const char* name, const QVariant& value);
+
+private:
+    AppStyle() = delete; // Static class only
+};
@@ -6,7 +6,10 @@
 #include <QScrollArea>
 #include <QVBoxLayout>
 #include "ticketInfo.h"
-#include "companyInfo.h"
+#include "PgpKeyManager.h"
+#include "Ed25519Signer.h"
+#include <memory>
+#include <vector>
 
 // Individual ticket card widget
 class TicketCard : public QWidget
@@ -15,9 +18,15 @@ class TicketCard : public QWidget
 public:
     explicit TicketCard(const TicketInfo& ticket, QWidget* parent = nullptr);
 
+    // Matches border-radius of the "ticketCard" role in the application stylesheet
+    static constexpr int CORNER_RADIUS = 12;
+
 signals:
     void qrCodeRequested(const TicketInfo& ticket);
 
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
 private:
     TicketInfo ticket_;
 };
@@ -30,12 +39,12 @@ public:
     explicit BookingReference(QWidget* parent = nullptr);
     void addTicket(const TicketInfo& ticket);
     void clearTickets();
-    void setCompanyInfo(const CompanyInfo* companyInfo) { companyInfo_ = companyInfo; }
 
 private slots:
     void showQRCode(const TicketInfo& ticket);
     void hideQRCode();
     void downloadCurrentQRCode();
+    void showCurrentQRCodeToInspector();
 
 private:
     void setupQROverlay();
@@ -50,9 +59,12 @@ private:
     QLabel* qrImageLabel_ = nullptr;
     QLabel* qrTitleLabel_ = nullptr;
     QPushButton* downloadQRButton_ = nullptr;
+    QPushButton* handoffButton_ = nullptr;
     
-    // Company info for signing tickets
-    const CompanyInfo* companyInfo_ = nullptr;
+    // Company signers (keys come from the shared company key service)
+    std::unique_ptr<PgpKeyManager> companySigner_;   // imported on first use
+    std::unique_ptr<Ed25519Signer> companyFastSigner_;  // raw Ed25519 path for TICKET2 payloads
+    std::vector<uint8_t> signatureBuffer_;           // reused across tickets
     
     // Current ticket being displayed
     TicketInfo currentTicket_;
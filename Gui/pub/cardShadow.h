@@ -0,0 +1,32 @@
+#pragma once
+#include <QMargins>
+#include <QRect>
+
+class QPainter;
+
+// Soft drop shadow for rounded cards, drawn as a nine-patch.
+//
+// The blurred shadow of a rounded rectangle is rendered once per corner
+// radius (and pixel ratio) into a small tile kept in QPixmapCache. Cards of
+// any size then paint it in a few pixmap blits, instead of each card carrying
+// a QGraphicsDropShadowEffect, which renders the widget offscreen and blurs
+// it on every repaint.
+class CardShadow
+{
+public:
+    static constexpr int BLUR_RADIUS = 12;
+    static constexpr int OFFSET_Y = 3;
+
+    // Space a card must leave around its visual rectangle for the shadow
+    static QMargins margins();
+
+    // Paint the shadow of a rounded rectangle (card in painter coordinates)
+    static void paint(QPainter& painter, const QRect& card, int cornerRadius);
+
+    // Disable to compare against other shadow implementations (default on)
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+private:
+    CardShadow() = delete; // Static class only
+};
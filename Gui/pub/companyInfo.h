@@ -11,6 +11,9 @@ public:
     // Constructor generates the company's PGP keys
     CompanyInfo();
     
+    // Use an existing company key (unprotected armored secret key) instead
+    explicit CompanyInfo(const QString& secretKeyArmored);
+    
     // Getters for the keys
     QString publicKey() const { return publicKey_; }
     QString privateKey() const { return privateKey_; }
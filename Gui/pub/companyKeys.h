@@ -0,0 +1,36 @@
+#pragma once
+#include "companyInfo.h"
+#include <QString>
+
+// Company key pair shared by every window in the process. Generating it takes
+// long enough to delay the first window, so it is bootstrapped on a background
+// thread and callers block on it only when they first sign or verify.
+
+// Load the key pair from this armored secret key file (--company-secret-key)
+// instead of generating a new one. Must be called before the keys are first
+// used, i.e. before prefetchCompanyKeys().
+void setCompanySecretKeyFile(const QString& path);
+
+// Start generating the company keys in the background (no-op once started)
+void prefetchCompanyKeys();
+
+// Company keys; blocks until generation has finished (starting it if needed)
+const CompanyInfo& sharedCompanyInfo();
+
+// True once sharedCompanyInfo() will return without blocking
+bool companyKeysReady();
+
+// Public key the inspector checks company signatures (tickets, revocation
+// lists) against. A generated key pair is new in every process, so it only
+// verifies what this process issued: pin the key to a --company-key file with
+// loadCompanyPublicKey(), or call trustOwnCompanyKey() when the same process
+// issues the tickets or loads the issuer's secret key. Set once at startup,
+// before any verification runs.
+
+// False if the file cannot be read or holds no Ed25519 public key
+bool loadCompanyPublicKey(const QString& path);
+
+void trustOwnCompanyKey();
+
+// Empty if neither was set up; blocks like sharedCompanyInfo() for the own key
+QString companyPublicKey();
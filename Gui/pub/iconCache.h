@@ -0,0 +1,23 @@
+#pragma once
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+// Icons and logos from Icons/, compiled into the executable (Icons/icons.qrc),
+// so they load without touching the filesystem and from any working
+// directory. Rendered pixmaps are kept in the process-wide QPixmapCache, so
+// each SVG is rasterised once per size no matter how many widgets show it.
+// GUI thread only, like QPixmapCache.
+class IconCache
+{
+public:
+    // Resource path of a file in Icons/, e.g. path("SBB_logo.svg")
+    static QString path(const QString& name);
+
+    // name fitted into size (aspect ratio kept) at the screen's pixel ratio;
+    // null pixmap if the asset cannot be read
+    static QPixmap pixmap(const QString& name, const QSize& size);
+
+private:
+    IconCache() = delete; // Static class only
+};
@@ -3,33 +3,67 @@
 #include <QLabel>
 #include <QString>
 #include <QPushButton>
+#include <QThread>
 #include <QTimer>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "PitWindowCache.h"
+#include "SigningKey.h"
 
 class IdentificationToken : public QWidget
 {
     Q_OBJECT
 public:
     explicit IdentificationToken(QWidget* parent = nullptr);
+    ~IdentificationToken() override;
     
-    // Set the public and private keys and generate signed token QR code
-    void setIdentificationToken(const QString& publicKey, const QString& privateKey);
+    // Seconds a PIT is shown before it is replaced: half the max age of the
+    // active PitValidityPolicy, so a PIT still has half its lifetime left
+    // when it is scanned at the end of its window
+    static int pitWindowSeconds();
+    
+    // Pre-sign this many seconds of PIT windows after login (0 = sign on every refresh)
+    static void setPrecomputeHorizon(int seconds);
+    
+    // Set the public key and unlocked signing key and generate signed token QR code
+    void setIdentificationToken(const QString& publicKey, std::shared_ptr<const SigningKey> signingKey);
     void clear();
 
 private slots:
     void downloadPIT();
+    void showToInspector();
     void updateCountdown();
     void refreshQRCode();
 
 private:
     void generateQRCodeWithTimestamp();
+    void startPrecompute();
+    void cancelPrecompute();
+    int nextRefreshMs() const;
+    
+    // State shared with one pre-sign burst on the precompute thread
+    struct PrecomputeBurst
+    {
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};
+    };
     
     QLabel* titleLabel_ = nullptr;
     QLabel* timerLabel_ = nullptr;
     QLabel* qrImageLabel_ = nullptr;
     QLabel* instructionLabel_ = nullptr;
     QPushButton* downloadButton_ = nullptr;
+    QPushButton* handoffButton_ = nullptr;
     QString publicKey_;
-    QString privateKey_;
+    std::shared_ptr<const SigningKey> signingKey_;  // unlocked once per login
+    std::vector<uint8_t> signatureBuffer_;    // reused across refreshes
+    std::shared_ptr<PitWindowCache> windowCache_;  // set when PITs are pre-signed
+    std::shared_ptr<std::mutex> signingMutex_;     // rnp key handles are not shared across threads
+    std::shared_ptr<PrecomputeBurst> burst_;       // latest pre-sign burst, if any
+    QThread precomputeThread_;
+    QObject* precomputeWorker_ = nullptr;
     QTimer* countdownTimer_ = nullptr;
     QTimer* refreshTimer_ = nullptr;
     int countdown_ = 10;
@@ -0,0 +1,16 @@
+#pragma once
+#include "PublicKeyDirectory.h"
+#include "IssuedTicketLog.h"
+#include "KeyStore.h"
+
+// Process-wide directory of registered user public keys, stored under the
+// application's local data location so the user app and the inspector
+// (also when run as separate processes) resolve keys from the same place.
+PublicKeyDirectory& sharedKeyDirectory();
+
+// Encrypted store of users' signing keys, next to the key directory
+KeyStore& sharedKeyStore();
+
+// Log of every ticket issued by this installation, audited by Tools/scanAudit.
+// Throws std::runtime_error if the log cannot be opened.
+IssuedTicketLog& sharedIssuedTicketLog();
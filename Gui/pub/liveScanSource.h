@@ -0,0 +1,80 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QImage>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QProcess>
+#include <QFileSystemWatcher>
+
+// Continuous QR code source for the inspector's live-scan mode.
+//
+// Two kinds of sources are supported:
+//   - a directory being watched: every new image written into it is treated
+//     as a camera frame and decoded with zbarimg on a worker thread
+//   - a V4L2 device (e.g. a v4l2loopback /dev/videoN): frames are read and
+//     decoded by a long-running zbarcam process
+//
+// At most one frame is decoded at a time. While the worker is busy only the
+// newest pending frame is kept; older ones are dropped so the inspector
+// always works on what the camera sees right now.
+class LiveScanSource : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LiveScanSource(QObject* parent = nullptr);
+    ~LiveScanSource() override;
+
+    // Start scanning from a directory or a /dev/video* device
+    bool start(const QString& source);
+    void stop();
+    bool isRunning() const { return running_; }
+
+    QString source() const { return source_; }
+    int framesDecoded() const { return framesDecoded_; }
+    int framesDropped() const { return framesDropped_; }
+
+    static bool isDeviceSource(const QString& source);
+
+signals:
+    // A QR payload was decoded; frame is a preview of the image it came from
+    // (null for device sources, where zbarcam owns the frames). decodeMicros
+    // is the zbarimg run and loadMicros the preview, both 0 for device sources
+    // and for all but the first code of a frame.
+    void codeDecoded(const QString& payload, const QImage& frame, qint64 decodeMicros, qint64 loadMicros);
+    void sourceError(const QString& message);
+
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void onScannerOutput();
+    void onScannerFinished(int exitCode, QProcess::ExitStatus status);
+
+private:
+    bool startDirectory(const QString& directory);
+    bool startDevice(const QString& device);
+    void dispatchFrame(const QString& framePath);
+    void onFrameDecoded(const QStringList& payloads, const QImage& preview, qint64 decodeMicros, qint64 loadMicros);
+    static QStringList frameFilters();
+
+    QString source_;
+    bool running_ = false;
+
+    // Directory source
+    QFileSystemWatcher* watcher_ = nullptr;
+    QSet<QString> seenFrames_;  // frame names already dispatched or skipped
+
+    // Decoder worker (directory source)
+    QThread workerThread_;
+    QObject* worker_ = nullptr;
+    bool workerBusy_ = false;
+    QString pendingFrame_;
+
+    // Device source
+    QProcess* scanner_ = nullptr;
+
+    int framesDecoded_ = 0;
+    int framesDropped_ = 0;
+
+    static constexpr int PREVIEW_SIZE = 200;
+};
@@ -3,13 +3,20 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QLabel>
+#include <QThread>
+#include <memory>
 #include "accountInfo.h"
+#include "KeyDerivation.h"
 
 class LoginPage : public QWidget
 {
     Q_OBJECT
 public:
     explicit LoginPage(QWidget* parent = nullptr);
+    ~LoginPage() override;
+
+    // scrypt cost used to derive login keys (changing it changes every user's key)
+    static void setKeyDerivationParams(const KeyDerivation::Params& params);
 
 signals:
     void loginSuccessful(const AccountInfo& account);
@@ -24,4 +31,11 @@ private:
     QLabel* statusLabel_ = nullptr;
     
     void showStatus(const QString& message, bool isError);
+    void finishLogin(const QString& email, const QByteArray& cacheKey,
+                     const std::shared_ptr<const SigningKey>& signingKey, const QString& error);
+
+    // Keystore unlock and key derivation (login worker)
+    QThread workerThread_;
+    QObject* worker_ = nullptr;
+    bool loginPending_ = false;
 };
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+class QImage;
+
+// QR code decoder using the zbarimg command-line tool
+class QRCodeDecoder
+{
+public:
+    // Decode every QR code found in an image file (one entry per symbol).
+    // Returns an empty list if nothing was decoded or zbarimg is unavailable.
+    static QStringList decodeAllFromFile(const QString& imagePath, int timeoutMs = 5000);
+
+    // Decode a single QR code from an image file (first symbol found)
+    static QString decodeFromFile(const QString& imagePath, int timeoutMs = 5000);
+
+    // Same, for an encoded image (PNG, JPEG, PGM, ...) held in memory.
+    // The bytes are piped to zbarimg; nothing is written to disk.
+    static QStringList decodeAllFromData(const QByteArray& imageData, int timeoutMs = 5000);
+
+    // Same, for a decoded image
+    static QStringList decodeAllFromImage(const QImage& image, int timeoutMs = 5000);
+    static QString decodeFromImage(const QImage& image, int timeoutMs = 5000);
+
+    // The in-memory encoding used for QImage input (greyscale PGM)
+    static QByteArray encodeForDecoding(const QImage& image);
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <QFrame>
+#include <QString>
+#include <deque>
+#include <functional>
+
+class QLabel;
+class QTableWidget;
+class QTimer;
+
+// Time spent in each stage of one inspector scan, in microseconds (0 if the
+// stage was not reached or not measured, e.g. image loading for live-scan
+// codes). The inspector builds one per verification and hands the same
+// record to the scan journal and the diagnostics panel.
+struct ScanTimings
+{
+    qint64 loadMicros = 0;             // both images, reading and scaling
+    qint64 decodeMicros = 0;           // both images, QR decoding only
+    qint64 parseMicros = 0;
+    qint64 keyResolveMicros = 0;
+    qint64 pitSignatureMicros = 0;
+    qint64 ticketSignatureMicros = 0;
+    qint64 verifyMicros = 0;           // the whole verification job
+    qint64 totalMicros = 0;            // verify request to result, including queueing
+    bool valid = false;
+    QString bookingReference;
+};
+
+// Toggleable inspector panel that shows why a gate is slow: the stage
+// timings of the last HISTORY_SIZE scans, the key cache hit rate, PIT
+// freshness outcomes and the depth of the inspector's queues. The counters
+// are the ones the inspector already keeps for export (key directory cache,
+// TicketOwnership::pitValidityStats, scan journal); the panel only reads
+// them, and only while it is visible.
+class ScanDiagnosticsPanel : public QFrame
+{
+    Q_OBJECT
+public:
+    static constexpr int HISTORY_SIZE = 10;
+
+    struct QueueDepths
+    {
+        int verifyJobs = 0;          // decode and verify jobs of the current pair
+        int handoffJobs = 0;         // frames from the user window still decoding
+        quint64 journalBacklog = 0;  // scans not yet committed to the journal
+        int liveFramesDropped = 0;
+    };
+
+    explicit ScanDiagnosticsPanel(QWidget* parent = nullptr);
+
+    void recordScan(const ScanTimings& timings);
+
+    // Polled once a second while the panel is visible
+    void setQueueProbe(std::function<QueueDepths()> probe);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void refreshTable();
+    void refreshCounters();
+
+    QTableWidget* table_ = nullptr;
+    QLabel* countersLabel_ = nullptr;
+    QTimer* refreshTimer_ = nullptr;
+    std::deque<ScanTimings> history_;  // newest first
+    std::function<QueueDepths()> queueProbe_;
+
+    static constexpr int REFRESH_MS = 1000;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <QObject>
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <functional>
+
+class QLocalServer;
+class QLocalSocket;
+
+// Hands QR frames from the user window to the inspector over a local socket
+// (a Unix domain socket or Windows named pipe), so --both mode and test
+// harnesses need no file round-trip.
+//
+// Each frame on the wire is a 4-byte big-endian length followed by an encoded
+// image (QRCodeDecoder::encodeForDecoding). Connections may carry any number
+// of frames.
+
+// Inspector side: accepts connections and reports every complete frame
+class ScanHandoffServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ScanHandoffServer(QObject* parent = nullptr);
+
+    bool listen(const QString& name);
+    void close();
+    bool isListening() const;
+
+signals:
+    void frameReceived(const QByteArray& imageData);
+
+private slots:
+    void onNewConnection();
+
+private:
+    void readFrames(QLocalSocket* socket);
+    static bool isServerRunning(const QString& name);
+
+    QLocalServer* server_ = nullptr;
+
+    static constexpr int PROBE_TIMEOUT_MS = 200;
+};
+
+// User side: sends frames to a listening inspector
+class ScanHandoff
+{
+public:
+    static constexpr int MAX_FRAME_BYTES = 16 * 1024 * 1024;
+
+    static QString defaultServerName();
+
+    // Enabled in --both mode or with --handoff; send buttons are hidden otherwise
+    static void setServerName(const QString& name);
+    static bool isEnabled();
+
+    static constexpr int SEND_TIMEOUT_MS = 2000;
+
+    // Sends in the background and returns at once; done(sent) runs on the
+    // calling thread once the frame is written, or with false if no inspector
+    // took it within SEND_TIMEOUT_MS. Nothing runs if context is destroyed first.
+    static void sendFrame(const QImage& frame, QObject* context, std::function<void(bool)> done);
+
+private:
+    ScanHandoff() = delete; // Static class only
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include "ticketOwnership.h"
+
+// Decode-and-verify for a PIT/ticket pair straight from memory, for callers
+// that hold the codes as images rather than files (the inspector's handoff
+// socket, test harnesses).
+//
+// The user's full public key is resolved from the key directory by the hash
+// in the PIT, and the ticket signature is checked against companyPublicKey(),
+// as in the inspector. These calls block (zbarimg, signature
+// checks, the daemon round trip), so run them off the GUI thread.
+class ScanVerifier
+{
+public:
+    // Verify every pair through a running Tools/verifyDaemon instead of
+    // in-process, sharing its key cache, revocation list and replay cache with
+    // the other gates; gateId names this terminal for the replay check. An
+    // empty path verifies in-process again (the default). Pairs the daemon
+    // cannot take (unreachable, overloaded) are verified in-process.
+    static void setVerifyDaemon(const QString& socketPath, quint32 gateId);
+
+    // Both payloads already decoded
+    static TicketOwnership::VerificationResult verifyPayloads(const QString& pitQRData, const QString& ticketQRData);
+
+    // Encoded images (PNG, JPEG, PGM, ...) held in memory
+    static TicketOwnership::VerificationResult verifyImageData(const QByteArray& pitImage, const QByteArray& ticketImage);
+
+    // Decoded images
+    static TicketOwnership::VerificationResult verifyImages(const QImage& pitImage, const QImage& ticketImage);
+
+private:
+    ScanVerifier() = delete; // Static class only
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+// Frame-time benchmark for the ticket list, run with --bench-scroll <cards>.
+// Fills a BookingReference with cards and sweeps its scroll area, repainting
+// every frame: once with a QGraphicsDropShadowEffect on each card, once with
+// the cached CardShadow. Prints "[scroll] ..." frame times to stderr.
+class ScrollBenchmark
+{
+public:
+    // Returns the process exit code
+    static int run(int cardCount, int frames = 300);
+
+private:
+    ScrollBenchmark() = delete; // Static class only
+};
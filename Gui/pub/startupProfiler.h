@@ -0,0 +1,34 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+class QWidget;
+
+// Startup-time probe enabled with --profile-startup. Prints milestones as
+// "[startup] +<ms> ms <event>" relative to enable(), which main() calls
+// before constructing QApplication. Does nothing unless enabled.
+class StartupProfiler : public QObject
+{
+public:
+    static void enable();
+    static bool isEnabled();
+
+    // Print a milestone (thread-safe)
+    static void mark(const QString& event);
+
+    // Print a milestone when the window receives its first paint event
+    static void watchFirstPaint(QWidget* window, const QString& label);
+
+    // Print how long widget took to construct (constructTimer was started just
+    // before) and to polish; forces the style polish that show() would do
+    static void markBuilt(QWidget* widget, const QString& label, const QElapsedTimer& constructTimer);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    StartupProfiler(QWidget* window, const QString& label);
+
+    QString label_;
+};
@@ -3,6 +3,7 @@
 #include <QDate>
 #include <QTime>
 #include <QDateTime>
+#include "KeyFingerprint.h"
 
 class TicketInfo
 {
@@ -16,11 +17,16 @@ public:
     QTime time() const { return time_; }
     QString bookingReference() const { return bookingReference_; }
     QString userPublicKey() const { return userPublicKey_; }
+    const KeyFingerprint& userKeyFingerprint() const { return userKeyFingerprint_; }
     QString signedData() const { return signedData_; }
     qint64 timestamp() const { return timestamp_; }
     bool isValid() const { return !bookingReference_.isEmpty(); }
     
-    void setUserPublicKey(const QString& publicKey) { userPublicKey_ = publicKey; }
+    void setUserPublicKey(const QString& publicKey, const KeyFingerprint& fingerprint)
+    {
+        userPublicKey_ = publicKey;
+        userKeyFingerprint_ = fingerprint;
+    }
     void setSignedData(const QString& signature, qint64 ts) { signedData_ = signature; timestamp_ = ts; }
 
 private:
@@ -30,6 +36,7 @@ private:
     QTime time_;
     QString bookingReference_;
     QString userPublicKey_;
+    KeyFingerprint userKeyFingerprint_;
     QString signedData_;
     qint64 timestamp_ = 0;
     
@@ -8,7 +8,14 @@
 #include <QPixmap>
 #include <QScrollArea>
 #include "ticketOwnership.h"
-#include "companyInfo.h"
+#include "liveScanSource.h"
+#include "verificationWorker.h"
+#include "scanHandoff.h"
+#include "RevocationList.h"
+#include "ScanJournal.h"
+#include "scanDiagnostics.h"
+#include <QElapsedTimer>
+#include <memory>
 
 class TicketInspector : public QWidget
 {
@@ -16,17 +23,46 @@ class TicketInspector : public QWidget
 
 public:
     explicit TicketInspector(QWidget* parent = nullptr);
+
+    // Continuously scan from a frame directory or /dev/video* device
+    void startLiveScan(const QString& source);
+
+    // Accept PIT/ticket frames from the user window over a local socket
+    bool startHandoffServer(const QString& name);
+
+    // Record every verification in an append-only scan journal
+    bool openJournal(const QString& path);
+    static QString defaultJournalPath();
+
+    // Load a signed full or delta revocation list (files are applied in order)
+    bool loadRevocationFile(const QString& path);
     
 private slots:
     void loadPITQRCode();
     void loadTicketQRCode();
     void verifyOwnership();
     void clearAll();
+    void handleImageDecoded(quint64 jobId, const QString& payload, const QImage& preview, qint64 elapsedMicros,
+                            qint64 loadMicros);
+    void handleVerificationFinished(quint64 jobId, const TicketOwnership::VerificationResult& result,
+                                    qint64 elapsedMicros);
+    void handleHandoffDecoded(quint64 jobId, const QString& payload, const QImage& preview, qint64 elapsedMicros,
+                              qint64 loadMicros);
+    void toggleLiveScan();
+    void handleLiveCode(const QString& payload, const QImage& frame, qint64 decodeMicros, qint64 loadMicros);
+    void handleLiveScanError(const QString& message);
     
 private:
     void setupUI();
     void updateVerificationStatus(const TicketOwnership::VerificationResult& result);
-    QString decodeQRFromImage(const QString& imagePath);
+    void setVerdictStyle(const QString& verdict); // "valid", "invalid" or empty
+    void stopLiveScan();
+    void resetPair();
+    void clearVerdict();
+    void acceptLiveCode(const QString& payload, const QImage& frame, qint64 decodeMicros, qint64 loadMicros);
+    ScanTimings scanTimings(const TicketOwnership::VerificationResult& result, qint64 verifyMicros) const;
+    void journalResult(const TicketOwnership::VerificationResult& result, const ScanTimings& timings);
+    ScanDiagnosticsPanel::QueueDepths queueDepths() const;
     
     // UI Components
     QLabel* titleLabel_ = nullptr;
@@ -46,17 +82,39 @@ private:
     // Verification Section
     QPushButton* verifyButton_ = nullptr;
     QPushButton* clearButton_ = nullptr;
+    QPushButton* liveScanButton_ = nullptr;
+    QPushButton* diagnosticsButton_ = nullptr;
     QWidget* resultPanel_ = nullptr;
     QLabel* resultIconLabel_ = nullptr;
     QLabel* resultTextLabel_ = nullptr;
     QLabel* detailsLabel_ = nullptr;
+    ScanDiagnosticsPanel* diagnosticsPanel_ = nullptr;
     
     // Data
     QString pitQRData_;
     QString ticketQRData_;
-    QPixmap pitImage_;
-    QPixmap ticketImage_;
-    CompanyInfo companyInfo_;
+    std::shared_ptr<RevocationList> revocationList_;
+    
+    // Decode/verify pipeline; job ids of the results still wanted (0 = none)
+    VerificationWorker* decodeWorker_ = nullptr;
+    VerificationWorker* verifyWorker_ = nullptr;
+    quint64 pitDecodeJob_ = 0;
+    quint64 ticketDecodeJob_ = 0;
+    quint64 verifyJob_ = 0;
+    qint64 pitDecodeMicros_ = 0;     // whole decode job, image loading included
+    qint64 ticketDecodeMicros_ = 0;
+    qint64 pitLoadMicros_ = 0;
+    qint64 ticketLoadMicros_ = 0;
+    QElapsedTimer verifyTimer_;   // submit to result, including queueing
+    std::unique_ptr<ScanJournal> journal_;
+    
+    // Frames from the user window (--both / --handoff)
+    ScanHandoffServer* handoffServer_ = nullptr;
+    VerificationWorker* handoffWorker_ = nullptr;
+    
+    // Live scan
+    LiveScanSource* liveScan_ = nullptr;
+    bool liveAwaitingNewPair_ = false;
     
     // Constants
     static constexpr int IMAGE_SIZE = 200;
@@ -1,10 +1,31 @@
 #pragma once
 #include <QString>
 #include <QDateTime>
+#include <memory>
+#include "KeyFingerprint.h"
+#include "PitValidityPolicy.h"
+#include "PublicKeyDirectory.h"
+
+class Clock;
+class RevocationList;
 
 class TicketOwnership
 {
 public:
+    // Payload versions, selected by the QR tag:
+    //   1 = "PIT" / "TICKET"   : OpenPGP detached signature over the armored key and decimal text
+    //   2 = "PIT2" / "TICKET2" : raw Ed25519 signature over the canonical ScanMessage
+    //   3 = "PIT3" / "TICKET3" : OpenPGP detached signature over the canonical ScanMessage
+    // Verification accepts all versions; version 1 is only issued for older inspectors.
+    enum PayloadVersion {
+        PayloadOpenPgp = 1,
+        PayloadEd25519 = 2,
+        PayloadOpenPgpMessage = 3
+    };
+
+    // Longer scanned strings are rejected before they are split (a QR code holds at most 2953 bytes)
+    static constexpr int kMaxPayloadSize = 4096;
+
     struct VerificationResult {
         bool isValid = false;
         bool pitParsed = false;
@@ -12,11 +33,18 @@ public:
         bool keysMatch = false;
         bool pitSignatureValid = false;
         bool ticketSignatureValid = false;
+        bool ticketRevoked = false;
         QString userPublicKey;
         QString errorMessage;
         qint64 pitTimestamp = 0;
         qint64 ticketTimestamp = 0;
         QString bookingReference;
+
+        // Time spent in each stage in microseconds (0 if the stage was not reached)
+        qint64 parseMicros = 0;
+        qint64 keyResolveMicros = 0;       // set by ScanVerifier, which looks the key up
+        qint64 pitSignatureMicros = 0;
+        qint64 ticketSignatureMicros = 0;
     };
 
     // Main verification method
@@ -30,19 +58,64 @@ public:
     static VerificationResult verifyOwnership(const QString& pitQRData, const QString& ticketQRData,
                                              const QString& userPublicKey, const QString& companyPublicKey);
 
-    // Parse QR code strings
-    static bool parsePIT(const QString& pitQRData, QString& outPublicKey, qint64& outTimestamp, QString& outSignature);
+    // Same, with the user's key already parsed (PublicKeyDirectory::resolve), so its
+    // fingerprint and Ed25519 point are not recomputed from the armored text
+    static VerificationResult verifyOwnership(const QString& pitQRData, const QString& ticketQRData,
+                                             const PublicKeyDirectory::Entry& userKey,
+                                             const QString& companyPublicKey);
+
+    // Parse QR code strings. parsePIT also applies the PIT validity policy;
+    // outVerdict (if given) receives the policy verdict once the format is valid.
+    static bool parsePIT(const QString& pitQRData, QString& outPublicKey, qint64& outTimestamp, QString& outSignature,
+                         PitValidityPolicy::Verdict* outVerdict = nullptr);
     static bool parseTicket(const QString& ticketQRData, QString& outBookingRef, qint64& outTimestamp, QString& outSignature);
 
     // Verify signatures (requires company public key for ticket verification)
-    static bool verifyPITSignature(const QString& publicKey, qint64 timestamp, const QString& signature);
+    static bool verifyPITSignature(const QString& publicKey, qint64 timestamp, const QString& signature,
+                                   int payloadVersion = PayloadOpenPgp);
+    // Same, with the key already parsed (versions 2 and 3 use its fingerprint and Ed25519 point)
+    static bool verifyPITSignature(const PublicKeyDirectory::Entry& userKey, qint64 timestamp,
+                                   const QString& signature, int payloadVersion = PayloadOpenPgp);
     static bool verifyTicketSignature(const QString& userPublicKey, const QString& bookingRef, 
                                       qint64 timestamp, const QString& signature, 
-                                      const QString& companyPublicKey);
+                                      const QString& companyPublicKey,
+                                      int payloadVersion = PayloadOpenPgp);
+    // Same, with the user's key fingerprint already known (version 2 signs the fingerprint)
+    static bool verifyTicketSignature(const QString& userPublicKey, const KeyFingerprint& userFingerprint,
+                                      const QString& bookingRef, qint64 timestamp, const QString& signature,
+                                      const QString& companyPublicKey,
+                                      int payloadVersion = PayloadOpenPgp);
+
+    // Payload version from the QR tag (0 if the tag is not recognised)
+    static int payloadVersion(const QString& qrData);
+    static QString pitTag(int payloadVersion);
+    static QString ticketTag(int payloadVersion);
+
+    // Payload version used when issuing new PITs and tickets (default: PayloadOpenPgpMessage)
+    static void setIssuePayloadVersion(int payloadVersion);
+    static int issuePayloadVersion();
+
+    // Key fingerprint carried in PIT and ticket QR codes (null if not an Ed25519 key).
+    // Parses the key; callers holding an AccountInfo or TicketInfo use its fingerprint.
+    static KeyFingerprint keyFingerprint(const QString& publicKey);
 
     // Extract user public key from ticket (needs to be embedded or retrieved)
     static QString extractUserPublicKeyFromTicket(const QString& ticketQRData);
 
+    // Revocation list consulted by verifyOwnership (nullptr disables the check)
+    static void setRevocationList(std::shared_ptr<const RevocationList> revocationList);
+    static std::shared_ptr<const RevocationList> revocationList();
+
+    // Freshness rule for PIT timestamps (default: at most 20 s old, none in the future)
+    static void setPitValidityPolicy(const PitValidityPolicy& policy);
+    static PitValidityPolicy pitValidityPolicy();
+
+    // Time source for the PIT check (default: SystemWallClock)
+    static void setClock(std::shared_ptr<const Clock> clock);
+
+    // PIT outcomes counted by verifyOwnership, by reason
+    static PitValidityStats& pitValidityStats();
+
 private:
     TicketOwnership() = delete; // Static class only
 };
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <QObject>
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include "ticketOwnership.h"
+
+// Runs the inspector's slow stages off the GUI thread:
+//   - loading an image and decoding its QR code with zbarimg (which can take
+//     up to the decoder timeout)
+//   - verifying a PIT/ticket pair (key directory lookup, signature checks)
+//
+// Jobs run one at a time, in submission order, on a single worker thread, and
+// their results come back as signals on the thread that owns the worker. Use
+// separate workers for stages that must not wait for each other.
+// cancelAll() makes every job submitted so far stale: queued jobs are skipped
+// and the result of a job that is already running is discarded.
+class VerificationWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit VerificationWorker(QObject* parent = nullptr);
+    ~VerificationWorker() override;
+
+    // Each returns a job id that is echoed in the matching result signal
+    quint64 decodeImage(const QString& imagePath, int previewSize);
+    quint64 decodeImageData(const QByteArray& imageData, int previewSize);  // encoded image in memory
+    quint64 verify(const QString& pitQRData, const QString& ticketQRData);
+
+    void cancelAll();
+    bool isBusy() const { return pendingJobs_ > 0; }
+    int pendingJobs() const { return pendingJobs_; }  // queued or running, cancelled ones included
+
+signals:
+    // preview is null if the image could not be loaded; payload is empty if
+    // no QR code was decoded. elapsedMicros is the time spent in the job itself,
+    // loadMicros the part of it spent loading the image rather than decoding.
+    void imageDecoded(quint64 jobId, const QString& payload, const QImage& preview, qint64 elapsedMicros,
+                      qint64 loadMicros);
+    void verificationFinished(quint64 jobId, const TicketOwnership::VerificationResult& result, qint64 elapsedMicros);
+
+private:
+    template <typename Job, typename Deliver>
+    quint64 submit(Job job, Deliver deliver);
+
+    bool isStale(quint64 jobId) const { return jobId < firstLiveJob_.load(); }
+
+    QThread workerThread_;
+    QObject* worker_ = nullptr;
+    quint64 nextJobId_ = 1;
+    std::atomic<quint64> firstLiveJob_{1};  // jobs with a lower id are cancelled
+    int pendingJobs_ = 0;
+};
@@ -10,7 +10,6 @@
 #include "logInPage.h"
 #include "accountInfo.h"
 #include "identificationToken.h"
-#include "companyInfo.h"
 
 class Window : public QWidget
 {
@@ -36,6 +35,5 @@ private:
     IdentificationToken* identificationToken_ = nullptr;
     TicketInfo ticketInfo_;
     AccountInfo accountInfo_;
-    CompanyInfo companyInfo_;
     bool isLoggedIn_ = false;
 };
\ No newline at end of file
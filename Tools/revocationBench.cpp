@@ -0,0 +1,148 @@
+// revocationBench - memory footprint and lookup latency of RevocationList
+//
+// Usage: revocationBench [revokedCount] [lookups]
+//        defaults: 10000000 revoked references, 10000000 lookups
+
+#include "RevocationList.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Resident set size in bytes, from /proc (Linux only; 0 elsewhere)
+size_t residentBytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+std::string randomReference(std::mt19937_64& rng)
+{
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::string ref(6, ' ');
+    for (char& c : ref) {
+        c = chars[rng() % 36];
+    }
+    return ref;
+}
+
+// Average ns per lookup over batches; reports median and p99 batch
+void benchLookups(const char* label, const RevocationList& list, const std::vector<uint64_t>& keys)
+{
+    constexpr size_t kBatch = 1000;
+    std::vector<double> batchNs;
+    batchNs.reserve(keys.size() / kBatch + 1);
+
+    size_t hits = 0;
+    for (size_t i = 0; i < keys.size(); i += kBatch) {
+        size_t end = std::min(keys.size(), i + kBatch);
+        auto start = Clock::now();
+        for (size_t j = i; j < end; ++j) {
+            hits += list.isRevokedKey(keys[j]) ? 1 : 0;
+        }
+        batchNs.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (end - i));
+    }
+
+    std::sort(batchNs.begin(), batchNs.end());
+    std::printf("  %-22s p50 %7.1f ns  p99 %7.1f ns  (%zu/%zu revoked)\n",
+                label,
+                batchNs[batchNs.size() / 2],
+                batchNs[std::min(batchNs.size() - 1, batchNs.size() * 99 / 100)],
+                hits, keys.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t revokedCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t lookupCount  = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+
+    std::mt19937_64 rng(2025);
+
+    std::printf("Generating %zu revoked references...\n", revokedCount);
+    std::vector<uint64_t> revoked;
+    revoked.reserve(revokedCount);
+    for (size_t i = 0; i < revokedCount; ++i) {
+        revoked.push_back(RevocationList::keyFor(randomReference(rng)));
+    }
+
+    std::string file = RevocationList::serialize(RevocationList::FileKind::Full, 1, 0, revoked, {});
+
+    size_t rssBefore = residentBytes();
+    RevocationList list;
+    auto loadStart = Clock::now();
+    list.load(file);
+    double loadMs = elapsedMs(loadStart);
+    size_t rssAfter = residentBytes();
+    file.clear();
+    file.shrink_to_fit();
+
+    std::printf("\nFull list\n");
+    std::printf("  entries                %zu (version %llu)\n", list.size(),
+                static_cast<unsigned long long>(list.version()));
+    std::printf("  load time              %.1f ms\n", loadMs);
+    std::printf("  footprint              %.1f MiB (%.2f bytes/entry)\n",
+                list.memoryFootprint() / (1024.0 * 1024.0),
+                static_cast<double>(list.memoryFootprint()) / std::max<size_t>(1, list.size()));
+    if (rssAfter > rssBefore) {
+        std::printf("  RSS growth during load %.1f MiB\n", (rssAfter - rssBefore) / (1024.0 * 1024.0));
+    }
+
+    // Lookups: fresh references (almost all misses) and known-revoked ones
+    std::vector<uint64_t> misses;
+    misses.reserve(lookupCount);
+    for (size_t i = 0; i < lookupCount; ++i) {
+        misses.push_back(RevocationList::keyFor(randomReference(rng)));
+    }
+    std::vector<uint64_t> hits;
+    hits.reserve(lookupCount);
+    for (size_t i = 0; i < lookupCount; ++i) {
+        hits.push_back(revoked[rng() % revoked.size()]);
+    }
+
+    std::printf("\nLookups\n");
+    benchLookups("random (mostly valid)", list, misses);
+    benchLookups("revoked", list, hits);
+
+    // Delta: 10k new revocations and 10k reinstatements on top of version 1
+    std::vector<uint64_t> deltaAdds;
+    std::vector<uint64_t> deltaRemoves;
+    for (size_t i = 0; i < 10000; ++i) {
+        deltaAdds.push_back(RevocationList::keyFor(randomReference(rng)));
+        deltaRemoves.push_back(revoked[rng() % revoked.size()]);
+    }
+    std::string delta = RevocationList::serialize(RevocationList::FileKind::Delta, 2, 1,
+                                                  deltaAdds, deltaRemoves);
+
+    auto deltaStart = Clock::now();
+    list.load(delta);
+    double deltaMs = elapsedMs(deltaStart);
+
+    std::printf("\nDelta (10000 adds, 10000 removes)\n");
+    std::printf("  apply time             %.2f ms\n", deltaMs);
+    std::printf("  entries                %zu (version %llu)\n", list.size(),
+                static_cast<unsigned long long>(list.version()));
+    benchLookups("random after delta", list, misses);
+
+    return 0;
+}
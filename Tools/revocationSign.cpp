@@ -0,0 +1,171 @@
+// revocationSign - issue company-signed revocation lists for inspectors
+//
+// Generates the persistent company key pair, and builds full or delta
+// revocation lists from plain-text booking reference files (one reference per
+// line, '#' starts a comment) and signs them with it. The list is written to
+// <out> and its detached signature to <out>.sig, the layout that
+// RevocationList::loadFile, `main --revocation-list` and verifyDaemon expect.
+//
+// Usage: revocationSign --generate-key <company.asc>
+//            writes <company.asc> (public key, for --company-key) and
+//            <company.asc>.secret (keep offline; --company-secret-key)
+//        revocationSign --key <secret.asc> --version N [--base M] [--remove <refs>] <refs> <out>
+//            full list of <refs> at version N, or with --base a delta from
+//            version M adding <refs> and removing the --remove references
+
+#include "PgpKeyManager.h"
+#include "RevocationList.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+namespace {
+
+const char* const kCompanyUserId = "sbbsupersecretadmin@gmail.com";
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+void writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.write(data.data(), static_cast<std::streamsize>(data.size())) || !out.flush()) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+// Packed keys of every reference in a refs file; unpackable references are fatal
+std::vector<uint64_t> readReferences(const std::string& path)
+{
+    std::istringstream lines(readFile(path));
+    std::vector<uint64_t> keys;
+    std::string line;
+    for (size_t number = 1; std::getline(lines, line); ++number) {
+        line = line.substr(0, line.find('#'));
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        const std::string ref = line.substr(begin, line.find_last_not_of(" \t\r") + 1 - begin);
+        const uint64_t key = RevocationList::keyFor(ref);
+        if (key == 0) {
+            throw std::runtime_error(path + ":" + std::to_string(number) + ": not a booking reference: " + ref);
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+int generateKey(const std::string& publicPath)
+{
+    PgpKeyManager company(kCompanyUserId);
+    const std::string secretPath = publicPath + ".secret";
+
+    // Created private so the secret key is never readable by others, even briefly
+    writeFile(secretPath, std::string());
+    ::chmod(secretPath.c_str(), 0600);
+    writeFile(secretPath, company.exportSecretKeyArmored());
+    writeFile(publicPath, company.exportPublicKeyArmored());
+
+    std::printf("Company public key written to %s, secret key to %s\n", publicPath.c_str(), secretPath.c_str());
+    return 0;
+}
+
+void usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s --generate-key <company.asc>\n"
+                 "       %s --key <secret.asc> --version N [--base M] [--remove <refs>] <refs> <out>\n",
+                 program, program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string generatePath;
+    std::string keyPath;
+    std::string removePath;
+    uint64_t version = 0;
+    uint64_t baseVersion = 0;
+    bool delta = false;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--generate-key" && i + 1 < argc) {
+            generatePath = argv[++i];
+        } else if (arg == "--key" && i + 1 < argc) {
+            keyPath = argv[++i];
+        } else if (arg == "--version" && i + 1 < argc) {
+            version = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--base" && i + 1 < argc) {
+            baseVersion = std::strtoull(argv[++i], nullptr, 10);
+            delta = true;
+        } else if (arg == "--remove" && i + 1 < argc) {
+            removePath = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    try {
+        if (!generatePath.empty()) {
+            return generateKey(generatePath);
+        }
+
+        if (keyPath.empty() || version == 0 || positional.size() != 2 || (!removePath.empty() && !delta)) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (delta && baseVersion >= version) {
+            std::fprintf(stderr, "revocationSign: --base must be below --version\n");
+            return 2;
+        }
+
+        std::vector<uint64_t> adds = readReferences(positional[0]);
+        std::vector<uint64_t> removes = removePath.empty() ? std::vector<uint64_t>() : readReferences(removePath);
+        const size_t addCount = adds.size();
+        const size_t removeCount = removes.size();
+
+        const std::string body = RevocationList::serialize(delta ? RevocationList::FileKind::Delta
+                                                                 : RevocationList::FileKind::Full,
+                                                           version, delta ? baseVersion : 0,
+                                                           std::move(adds), std::move(removes));
+
+        auto company = PgpKeyManager::fromSecretKey(readFile(keyPath));
+        const std::string& out = positional[1];
+        writeFile(out, body);
+        writeFile(out + ".sig", company->signData(body));
+
+        if (delta) {
+            std::printf("Delta %llu -> %llu: %zu added, %zu removed, written to %s\n",
+                        static_cast<unsigned long long>(baseVersion), static_cast<unsigned long long>(version),
+                        addCount, removeCount, out.c_str());
+        } else {
+            std::printf("Full list version %llu: %zu references, written to %s\n",
+                        static_cast<unsigned long long>(version), addCount, out.c_str());
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "revocationSign: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,403 @@
+// scanAudit - end-of-day audit of inspector scan journals against issued tickets
+//
+// Joins every scan in the given journals with the issued-ticket log by booking
+// reference, and flags:
+//   unissued           scanned reference that was never issued
+//   key_mismatch       presented with a different user key than it was issued to
+//   duplicate_use      presented by more than one distinct user key during the day
+//                      (the owner's key included)
+//   signature_failure  PIT signature did not verify
+//   duplicate_issue    reference issued more than once
+//
+// The join is a partitioned parallel hash join: both inputs are read in
+// parallel slices (the log through mmap, journals through ScanJournal::Reader)
+// and scattered into partitions by reference; each partition is then built
+// and probed by one thread, with no shared state.
+//
+// Usage: scanAudit --issued <log> [--threads N] [--report <csv>] <journal>...
+
+#include "IssuedTicketLog.h"
+#include "RevocationList.h"
+#include "ScanJournal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// References that RevocationList can pack are below 2^63; others are hashed
+// into the upper half so the two never collide
+uint64_t referenceKey(std::string_view ref)
+{
+    if (uint64_t key = RevocationList::keyFor(ref)) {
+        return key;
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : ref) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+    return hash | (1ULL << 63);
+}
+
+// 16 hex chars to 64 bits (0 if malformed)
+uint64_t keyHashBits(std::string_view hex)
+{
+    if (hex.size() != 16) {
+        return 0;
+    }
+    uint64_t value = 0;
+    for (char c : hex) {
+        int digit = (c >= '0' && c <= '9') ? c - '0'
+                  : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                  : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (digit < 0) {
+            return 0;
+        }
+        value = (value << 4) | static_cast<uint64_t>(digit);
+    }
+    return value;
+}
+
+size_t partitionOf(uint64_t key, size_t partitions)
+{
+    // Fibonacci hashing; packed references are dense, so spread them
+    return static_cast<size_t>((key * 0x9e3779b97f4a7c15ULL) >> 32) % partitions;
+}
+
+struct IssuedRow
+{
+    uint64_t refKey;
+    uint64_t keyHash;
+    uint64_t lineOffset;   // for reporting duplicate issues
+};
+
+struct ScanRow
+{
+    uint64_t refKey;
+    uint64_t keyHash;
+    uint32_t flags;
+    uint32_t journal;
+    uint64_t index;
+};
+
+struct Finding
+{
+    const char* issue;
+    uint32_t    journal;   // UINT32_MAX for findings from the issued log
+    uint64_t    index;     // record index, or line offset in the issued log
+};
+
+struct Counters
+{
+    std::atomic<uint64_t> issued{0};
+    std::atomic<uint64_t> malformedIssued{0};
+    std::atomic<uint64_t> scans{0};
+    std::atomic<uint64_t> unreadable{0};
+    std::atomic<uint64_t> unissued{0};
+    std::atomic<uint64_t> keyMismatch{0};
+    std::atomic<uint64_t> duplicateUse{0};
+    std::atomic<uint64_t> signatureFailure{0};
+    std::atomic<uint64_t> duplicateIssue{0};
+};
+
+// Read-only mapping of a whole file
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        if (fd < 0 || ::fstat(fd, &st) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::runtime_error("Cannot open " + path);
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size > 0) {
+            void* mapped = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            ::madvise(mapped, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (m_data) {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    std::string_view view() const { return std::string_view(m_data ? m_data : "", m_size); }
+
+private:
+    const char* m_data = nullptr;
+    size_t      m_size = 0;
+};
+
+void runParallel(size_t threads, const std::function<void(size_t)>& body)
+{
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back(body, t);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+double elapsedSeconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::string_view lineAt(std::string_view text, size_t offset)
+{
+    size_t end = text.find('\n', offset);
+    return text.substr(offset, end == std::string_view::npos ? std::string_view::npos : end - offset);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string issuedPath;
+    std::string reportPath;
+    std::vector<std::string> journalPaths;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--issued" && i + 1 < argc) {
+            issuedPath = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--report" && i + 1 < argc) {
+            reportPath = argv[++i];
+        } else {
+            journalPaths.push_back(arg);
+        }
+    }
+
+    if (issuedPath.empty() || journalPaths.empty()) {
+        std::fprintf(stderr, "Usage: %s --issued <log> [--threads N] [--report <csv>] <journal>...\n", argv[0]);
+        return 2;
+    }
+
+    try {
+        const auto start = Clock::now();
+        const size_t partitions = threads * 4;
+        Counters counters;
+
+        // ---- Scatter issued tickets into partitions ------------------------
+        MappedFile issuedFile(issuedPath);
+        const std::string_view issuedText = issuedFile.view();
+
+        std::vector<std::vector<std::vector<IssuedRow>>> issuedParts(
+            threads, std::vector<std::vector<IssuedRow>>(partitions));
+
+        runParallel(threads, [&](size_t t) {
+            // Slice by bytes; a slice owns every line that starts inside it
+            size_t begin = issuedText.size() * t / threads;
+            size_t end = issuedText.size() * (t + 1) / threads;
+            if (begin > 0) {
+                size_t newline = issuedText.find('\n', begin - 1);
+                begin = newline == std::string_view::npos ? issuedText.size() : newline + 1;
+            }
+
+            std::string_view ref, keyHash, travelDate;
+            int64_t issuedAt = 0;
+            while (begin < end) {
+                size_t newline = issuedText.find('\n', begin);
+                size_t lineEnd = newline == std::string_view::npos ? issuedText.size() : newline;
+                std::string_view line = issuedText.substr(begin, lineEnd - begin);
+
+                if (IssuedTicketLog::parseLine(line, ref, keyHash, issuedAt, travelDate)) {
+                    uint64_t key = referenceKey(ref);
+                    issuedParts[t][partitionOf(key, partitions)].push_back({key, keyHashBits(keyHash), begin});
+                    counters.issued.fetch_add(1, std::memory_order_relaxed);
+                } else if (!line.empty() && line.front() != '#') {
+                    counters.malformedIssued.fetch_add(1, std::memory_order_relaxed);
+                }
+                begin = lineEnd + 1;
+            }
+        });
+        const double issuedSeconds = elapsedSeconds(start);
+
+        // ---- Scatter scans into partitions ---------------------------------
+        std::vector<std::unique_ptr<ScanJournal::Reader>> journals;
+        for (const std::string& path : journalPaths) {
+            journals.push_back(std::make_unique<ScanJournal::Reader>(path));
+        }
+
+        std::vector<std::vector<std::vector<ScanRow>>> scanParts(
+            threads, std::vector<std::vector<ScanRow>>(partitions));
+
+        runParallel(threads, [&](size_t t) {
+            ScanJournal::Entry entry;
+            for (uint32_t j = 0; j < journals.size(); ++j) {
+                const size_t slots = journals[j]->slots();
+                const size_t begin = slots * t / threads;
+                const size_t end = slots * (t + 1) / threads;
+                for (size_t i = begin; i < end; ++i) {
+                    if (!journals[j]->read(i, entry)) {
+                        continue;   // unused space at the end, or a torn record
+                    }
+                    counters.scans.fetch_add(1, std::memory_order_relaxed);
+                    if (!(entry.flags & ScanJournal::TicketParsed) || entry.bookingRef.empty()) {
+                        counters.unreadable.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    uint64_t key = referenceKey(entry.bookingRef);
+                    scanParts[t][partitionOf(key, partitions)].push_back(
+                        {key, keyHashBits(entry.keyHash), entry.flags, j, i});
+                }
+            }
+        });
+        const double scanSeconds = elapsedSeconds(start);
+
+        // ---- Build and probe each partition --------------------------------
+        std::vector<std::vector<Finding>> findings(threads);
+        std::atomic<size_t> nextPartition{0};
+
+        runParallel(threads, [&](size_t t) {
+            struct Issued
+            {
+                uint64_t keyHash;
+                uint64_t presentedBy = 0;      // first key the ticket was presented with
+                bool     duplicateUseReported = false;
+            };
+            std::unordered_map<uint64_t, Issued> table;
+
+            for (size_t p = nextPartition++; p < partitions; p = nextPartition++) {
+                table.clear();
+                size_t expected = 0;
+                for (size_t s = 0; s < threads; ++s) {
+                    expected += issuedParts[s][p].size();
+                }
+                table.reserve(expected);
+
+                for (size_t s = 0; s < threads; ++s) {
+                    for (const IssuedRow& row : issuedParts[s][p]) {
+                        if (!table.emplace(row.refKey, Issued{row.keyHash}).second) {
+                            counters.duplicateIssue.fetch_add(1, std::memory_order_relaxed);
+                            findings[t].push_back({"duplicate_issue", UINT32_MAX, row.lineOffset});
+                        }
+                    }
+                    std::vector<IssuedRow>().swap(issuedParts[s][p]);
+                }
+
+                for (size_t s = 0; s < threads; ++s) {
+                    for (const ScanRow& row : scanParts[s][p]) {
+                        const bool signatureChecked = (row.flags & ScanJournal::PitParsed) &&
+                                                      (row.flags & ScanJournal::KeysMatch);
+                        if (signatureChecked && !(row.flags & ScanJournal::PitSignatureValid)) {
+                            counters.signatureFailure.fetch_add(1, std::memory_order_relaxed);
+                            findings[t].push_back({"signature_failure", row.journal, row.index});
+                        }
+
+                        auto it = table.find(row.refKey);
+                        if (it == table.end()) {
+                            counters.unissued.fetch_add(1, std::memory_order_relaxed);
+                            findings[t].push_back({"unissued", row.journal, row.index});
+                            continue;
+                        }
+
+                        Issued& issued = it->second;
+                        if (row.keyHash == 0) {
+                            continue;
+                        }
+                        if (row.keyHash != issued.keyHash) {
+                            counters.keyMismatch.fetch_add(1, std::memory_order_relaxed);
+                            findings[t].push_back({"key_mismatch", row.journal, row.index});
+                        }
+
+                        // A second distinct key on the same ticket means it was passed
+                        // around, whether or not one of the keys is the owner's
+                        if (issued.presentedBy == 0) {
+                            issued.presentedBy = row.keyHash;
+                        } else if (issued.presentedBy != row.keyHash && !issued.duplicateUseReported) {
+                            issued.duplicateUseReported = true;
+                            counters.duplicateUse.fetch_add(1, std::memory_order_relaxed);
+                            findings[t].push_back({"duplicate_use", row.journal, row.index});
+                        }
+                    }
+                    std::vector<ScanRow>().swap(scanParts[s][p]);
+                }
+            }
+        });
+        const double joinSeconds = elapsedSeconds(start);
+
+        // ---- Report ---------------------------------------------------------
+        if (!reportPath.empty()) {
+            FILE* report = std::fopen(reportPath.c_str(), "w");
+            if (!report) {
+                throw std::runtime_error("Cannot write " + reportPath);
+            }
+            std::fprintf(report, "issue,booking_ref,key_hash,scan_time_ms,source\n");
+            ScanJournal::Entry entry;
+            for (const std::vector<Finding>& threadFindings : findings) {
+                for (const Finding& f : threadFindings) {
+                    if (f.journal == UINT32_MAX) {
+                        std::string line(lineAt(issuedText, f.index));
+                        std::string_view ref, keyHash, travelDate;
+                        int64_t issuedAt = 0;
+                        IssuedTicketLog::parseLine(line, ref, keyHash, issuedAt, travelDate);
+                        std::fprintf(report, "%s,%.*s,%.*s,,%s\n", f.issue,
+                                     static_cast<int>(ref.size()), ref.data(),
+                                     static_cast<int>(keyHash.size()), keyHash.data(), issuedPath.c_str());
+                    } else if (journals[f.journal]->read(f.index, entry)) {
+                        std::fprintf(report, "%s,%s,%s,%lld,%s\n", f.issue, entry.bookingRef.c_str(),
+                                     entry.keyHash.c_str(), static_cast<long long>(entry.scanTime),
+                                     journalPaths[f.journal].c_str());
+                    }
+                }
+            }
+            std::fclose(report);
+        }
+
+        std::printf("Issued tickets:      %llu (%llu malformed lines)\n",
+                    static_cast<unsigned long long>(counters.issued.load()),
+                    static_cast<unsigned long long>(counters.malformedIssued.load()));
+        std::printf("Scans:               %llu in %zu journal(s) (%llu without a readable ticket)\n\n",
+                    static_cast<unsigned long long>(counters.scans.load()), journalPaths.size(),
+                    static_cast<unsigned long long>(counters.unreadable.load()));
+        std::printf("unissued             %llu\n", static_cast<unsigned long long>(counters.unissued.load()));
+        std::printf("key_mismatch         %llu\n", static_cast<unsigned long long>(counters.keyMismatch.load()));
+        std::printf("duplicate_use        %llu\n", static_cast<unsigned long long>(counters.duplicateUse.load()));
+        std::printf("signature_failure    %llu\n", static_cast<unsigned long long>(counters.signatureFailure.load()));
+        std::printf("duplicate_issue      %llu\n\n", static_cast<unsigned long long>(counters.duplicateIssue.load()));
+        std::printf("%zu threads: issued %.2f s, scans %.2f s, join %.2f s, total %.2f s\n",
+                    threads, issuedSeconds, scanSeconds - issuedSeconds, joinSeconds - scanSeconds,
+                    elapsedSeconds(start));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
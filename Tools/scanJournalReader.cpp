@@ -0,0 +1,131 @@
+// scanJournalReader - dump or summarise an inspector scan journal
+//
+// Reads the records written by ScanJournal, up to the first torn or empty
+// record. The default output is a shift summary: outcome counts and latency
+// percentiles. --csv prints one line per scan for upload or a spreadsheet.
+//
+// Usage: scanJournalReader <journal> [--csv]
+
+#include "ScanJournal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string formatTime(int64_t ms)
+{
+    std::time_t seconds = static_cast<std::time_t>(ms / 1000);
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+    return std::string(buffer) + "." + std::to_string(1000 + ms % 1000).substr(1) + "Z";
+}
+
+int flag(const ScanJournal::Entry& entry, uint32_t bit)
+{
+    return (entry.flags & bit) ? 1 : 0;
+}
+
+void printCsv(const std::vector<ScanJournal::Entry>& entries)
+{
+    std::printf("scan_time,booking_ref,key_hash,pit_timestamp,ticket_timestamp,valid,pit_parsed,"
+                "ticket_parsed,keys_match,pit_signature,ticket_signature,revoked,"
+                "decode_us,verify_us,total_us\n");
+    for (const ScanJournal::Entry& e : entries) {
+        std::printf("%s,%s%s,%s,%lld,%lld,%d,%d,%d,%d,%d,%d,%d,%u,%u,%u\n",
+                    formatTime(e.scanTime).c_str(),
+                    e.bookingRef.c_str(),
+                    flag(e, ScanJournal::BookingRefTruncated) ? "~" : "",
+                    e.keyHash.c_str(),
+                    static_cast<long long>(e.pitTimestamp),
+                    static_cast<long long>(e.ticketTimestamp),
+                    flag(e, ScanJournal::Valid),
+                    flag(e, ScanJournal::PitParsed),
+                    flag(e, ScanJournal::TicketParsed),
+                    flag(e, ScanJournal::KeysMatch),
+                    flag(e, ScanJournal::PitSignatureValid),
+                    flag(e, ScanJournal::TicketSignatureValid),
+                    flag(e, ScanJournal::TicketRevoked),
+                    e.decodeMicros, e.verifyMicros, e.totalMicros);
+    }
+}
+
+double percentileMs(std::vector<uint32_t> micros, double p)
+{
+    if (micros.empty()) {
+        return 0.0;
+    }
+    std::sort(micros.begin(), micros.end());
+    size_t index = std::min(micros.size() - 1, static_cast<size_t>(micros.size() * p));
+    return micros[index] / 1000.0;
+}
+
+void printSummary(const std::vector<ScanJournal::Entry>& entries)
+{
+    std::printf("Scans: %zu\n", entries.size());
+    if (entries.empty()) {
+        return;
+    }
+
+    size_t valid = 0, unparsed = 0, mismatched = 0, badSignature = 0, revoked = 0;
+    std::vector<uint32_t> verify, total;
+    for (const ScanJournal::Entry& e : entries) {
+        if (e.flags & ScanJournal::Valid) {
+            ++valid;
+        } else if (!(e.flags & ScanJournal::PitParsed) || !(e.flags & ScanJournal::TicketParsed)) {
+            ++unparsed;
+        } else if (e.flags & ScanJournal::TicketRevoked) {
+            ++revoked;
+        } else if (!(e.flags & ScanJournal::KeysMatch)) {
+            ++mismatched;
+        } else {
+            ++badSignature;
+        }
+        verify.push_back(e.verifyMicros);
+        total.push_back(e.totalMicros);
+    }
+
+    std::printf("First: %s\nLast:  %s\n\n",
+                formatTime(entries.front().scanTime).c_str(),
+                formatTime(entries.back().scanTime).c_str());
+    std::printf("Valid:                     %zu\n", valid);
+    std::printf("Invalid - unreadable/stale %zu\n", unparsed);
+    std::printf("Invalid - revoked          %zu\n", revoked);
+    std::printf("Invalid - key mismatch     %zu\n", mismatched);
+    std::printf("Invalid - signature/other  %zu\n\n", badSignature);
+    std::printf("Verify latency  p50 %7.2f ms  p99 %7.2f ms\n",
+                percentileMs(verify, 0.50), percentileMs(verify, 0.99));
+    std::printf("Total latency   p50 %7.2f ms  p99 %7.2f ms\n",
+                percentileMs(total, 0.50), percentileMs(total, 0.99));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <journal> [--csv]\n", argv[0]);
+        return 2;
+    }
+
+    const bool csv = argc > 2 && std::string(argv[2]) == "--csv";
+
+    try {
+        const std::vector<ScanJournal::Entry> entries = ScanJournal::readAll(argv[1]);
+        if (csv) {
+            printCsv(entries);
+        } else {
+            printSummary(entries);
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
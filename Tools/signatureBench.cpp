@@ -0,0 +1,156 @@
+// signatureBench - OpenPGP (rnp) vs raw Ed25519 scan payloads
+//
+// Compares the version 1 payloads (OpenPGP detached signature over the text
+// message) with the version 2 payloads (raw Ed25519 over ScanMessage) and
+// the version 3 payloads (OpenPGP over ScanMessage): sign and verify
+// latency, and the resulting QR payload and symbol size.
+//
+// Usage: signatureBench [iterations]
+//        default: 2000 iterations per operation
+
+#include "Ed25519Signer.h"
+#include "KeyFingerprint.h"
+#include "PgpKeyManager.h"
+#include "ScanMessage.h"
+
+#include <qrencode.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string toHex(const uint8_t* data, size_t size)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(size * 2);
+    for (size_t i = 0; i < size; ++i) {
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 0x0f];
+    }
+    return hex;
+}
+
+// QR version (1-40) for the payload, with the settings used by QRCodeGenerator
+int qrVersion(const std::string& payload)
+{
+    QRcode* qrcode = QRcode_encodeString(payload.c_str(), 0, QR_ECLEVEL_M, QR_MODE_8, 1);
+    if (!qrcode) {
+        return -1;
+    }
+    int version = qrcode->version;
+    QRcode_free(qrcode);
+    return version;
+}
+
+// Time each call individually and report median and p99 in microseconds
+void bench(const char* label, size_t iterations, const std::function<bool()>& op)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    size_t failures = 0;
+
+    for (size_t i = 0; i < iterations; ++i) {
+        auto start = Clock::now();
+        bool ok = op();
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        failures += ok ? 0 : 1;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    std::printf("  %-34s p50 %8.1f us  p99 %8.1f us%s\n",
+                label,
+                samples[samples.size() / 2],
+                samples[std::min(samples.size() - 1, samples.size() * 99 / 100)],
+                failures ? "  (FAILURES)" : "");
+}
+
+void reportPayload(const char* label, const std::string& payload, size_t signatureBytes)
+{
+    std::printf("  %-34s %4zu chars  signature %3zu bytes  QR version %d\n",
+                label, payload.size(), signatureBytes, qrVersion(payload));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    iterations = std::max<size_t>(iterations, 1);
+
+    std::printf("Generating key...\n");
+    PgpKeyManager key("bench@example.com");
+    const std::string publicKey = key.exportPublicKeyArmored();
+    const std::unique_ptr<Ed25519Signer> fastSigner =
+        Ed25519Signer::fromOpenPgpSecretKey(key.exportSecretKeyArmored());
+
+    const std::string keyHash = KeyFingerprint::fromPublicKey(publicKey).toHex();
+    const int64_t timestamp = 1732368000;
+
+    // Version 1: OpenPGP signature over publicKey + timestamp
+    const std::string pitText = publicKey + std::to_string(timestamp);
+    const std::string pgpSignature = key.signData(pitText);
+    const std::string pit1 = "PIT:" + keyHash + ":" + std::to_string(timestamp) + ":" +
+                             toHex(reinterpret_cast<const uint8_t*>(pgpSignature.data()), pgpSignature.size());
+
+    // Version 2: raw Ed25519 over the canonical message
+    const ScanMessage message = ScanMessage::pit(keyHash, timestamp);
+    const Ed25519Signer::Signature rawSignature = fastSigner->sign(message.data(), message.size());
+    const std::string pit2 = "PIT2:" + keyHash + ":" + std::to_string(timestamp) + ":" +
+                             toHex(rawSignature.data(), rawSignature.size());
+
+    // Version 3: OpenPGP signature over the canonical message
+    const std::string messageBytes(reinterpret_cast<const char*>(message.data()), message.size());
+    const std::string pgpMessageSignature = key.signData(messageBytes);
+    const std::string pit3 = "PIT3:" + keyHash + ":" + std::to_string(timestamp) + ":" +
+                             toHex(reinterpret_cast<const uint8_t*>(pgpMessageSignature.data()),
+                                   pgpMessageSignature.size());
+
+    std::printf("\nPayload size\n");
+    reportPayload("PIT  (OpenPGP, text)", pit1, pgpSignature.size());
+    reportPayload("PIT2 (raw Ed25519)", pit2, rawSignature.size());
+    reportPayload("PIT3 (OpenPGP, ScanMessage)", pit3, pgpMessageSignature.size());
+
+    std::printf("\nSign (%zu iterations)\n", iterations);
+    std::vector<uint8_t> signatureBuffer;
+    bench("OpenPGP (rnp, cached key handle)", iterations, [&] {
+        key.signData(reinterpret_cast<const uint8_t*>(pitText.data()), pitText.size(), signatureBuffer);
+        return !signatureBuffer.empty();
+    });
+    bench("OpenPGP over ScanMessage", iterations, [&] {
+        ScanMessage m = ScanMessage::pit(keyHash, timestamp);
+        key.signData(m.data(), m.size(), signatureBuffer);
+        return !signatureBuffer.empty();
+    });
+    bench("raw Ed25519", iterations, [&] {
+        ScanMessage m = ScanMessage::pit(keyHash, timestamp);
+        return fastSigner->sign(m.data(), m.size())[0] == rawSignature[0];
+    });
+
+    std::printf("\nVerify (%zu iterations)\n", iterations);
+    bench("OpenPGP (rnp, import per verify)", iterations, [&] {
+        return PgpKeyManager::verifyDetached(publicKey, pitText, pgpSignature);
+    });
+    bench("OpenPGP over ScanMessage", iterations, [&] {
+        return PgpKeyManager::verifyDetached(publicKey, messageBytes, pgpMessageSignature);
+    });
+    bench("raw Ed25519 (parse key per verify)", iterations, [&] {
+        auto point = Ed25519Signer::publicKeyFromOpenPgp(publicKey);
+        ScanMessage m = ScanMessage::pit(keyHash, timestamp);
+        return point && Ed25519Signer::verify(*point, m.data(), m.size(), rawSignature);
+    });
+    const Ed25519Signer::PublicKey point = fastSigner->publicKey();
+    bench("raw Ed25519 (pre-parsed key)", iterations, [&] {
+        return Ed25519Signer::verify(point, message.data(), message.size(), rawSignature);
+    });
+
+    return 0;
+}
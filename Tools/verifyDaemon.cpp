@@ -0,0 +1,659 @@
+// verifyDaemon - shared PIT/ticket verification service for inspector terminals
+//
+// Owns one warm set of verification state - the public key directory and its
+// LRU cache, the company key, the revocation list and the replay cache - and
+// serves any number of inspector clients over a Unix domain socket using the
+// binary VerifyProtocol. Gate terminals on one station box connect to it
+// instead of each loading keys and lists on their own, and a PIT replayed at
+// a second gate is caught because all gates share the replay cache.
+//
+// One thread runs an epoll loop over the listening socket, the clients, a
+// signalfd and an eventfd; it only moves bytes and frames. Verifications run
+// on a worker pool fed by a bounded ScanQueue and hand finished responses
+// back through the eventfd. A client with too many requests in flight is not
+// read until it catches up; when the queue itself is full, new requests are
+// answered with an Overloaded error instead of waiting behind it. With
+// --drop-oldest the oldest waiting request gets that error instead, for live
+// gates where a stale scan is worth less than the one just taken.
+//
+// Signals: SIGINT/SIGTERM stop the daemon, SIGHUP reloads the revocation lists.
+//
+// Usage: verifyDaemon --socket <path> --keys <dir> [--company-key <file.asc>]
+//                     [--revocation-list <file>]... [--pit-policy <file>]
+//                     [--workers N] [--drop-oldest]
+
+#include "PayloadVerifier.h"
+#include "PitValidityPolicy.h"
+#include "PublicKeyDirectory.h"
+#include "RevocationList.h"
+#include "ScanQueue.h"
+#include "VerifyProtocol.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t kListenTag     = 1;
+constexpr uint64_t kSignalTag     = 2;
+constexpr uint64_t kCompletionTag = 3;
+constexpr uint64_t kFirstClientId = 16;
+
+constexpr size_t kMaxInFlight  = 64;         // per client, before reads pause
+constexpr size_t kQueueDepth   = 4096;       // all clients, before requests are refused
+constexpr size_t kMaxOutBuffer = 1u << 20;   // per client, unsent response bytes
+constexpr size_t kReadChunk    = 16 * 1024;
+constexpr int    kMaxEvents    = 64;
+
+struct Options
+{
+    std::string              socketPath;
+    std::string              keysDir;
+    std::string              companyKeyPath;
+    std::vector<std::string> revocationFiles;
+    std::string              policyPath;
+    unsigned                 workers = std::max(1u, std::thread::hardware_concurrency());
+    bool                     dropOldest = false;
+};
+
+struct Completion
+{
+    uint64_t    clientId;
+    std::string frame;
+};
+
+struct Client
+{
+    int         fd = -1;
+    std::string in;
+    std::string out;
+    size_t      outPos = 0;
+    size_t      inFlight = 0;
+    bool        readPaused = false;
+    bool        closing = false;      // drop after the error frame is sent
+    int64_t     readAt = 0;           // ScanQueue::now() of the last read that returned data
+    uint32_t    events = 0;           // currently registered epoll events
+};
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+// Full list followed by its deltas, in the given order
+std::shared_ptr<const RevocationList> loadRevocations(const std::vector<std::string>& files,
+                                                      const std::string& companyKey)
+{
+    if (files.empty()) {
+        return nullptr;
+    }
+    auto list = std::make_shared<RevocationList>();
+    for (const std::string& file : files) {
+        list->loadFile(file, companyKey);
+    }
+    return list;
+}
+
+class Daemon
+{
+public:
+    Daemon(const Options& options, std::string companyKey, PublicKeyDirectory& keys, PayloadVerifier& verifier)
+        : m_options(options), m_companyKey(std::move(companyKey)), m_keys(keys), m_verifier(verifier)
+        , m_queue(kQueueDepth, options.dropOldest ? ScanQueue::Policy::DropOldest : ScanQueue::Policy::Backpressure,
+                  [this](ScanQueue::Scan&& victim) { dropped(std::move(victim)); })
+    {
+    }
+
+    ~Daemon()
+    {
+        for (auto& [id, client] : m_clients) {
+            ::close(client.fd);
+        }
+        for (int fd : {m_listenFd, m_signalFd, m_eventFd, m_epollFd}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    ScanQueue::Stats queueStats() const { return m_queue.stats(); }
+
+    void run()
+    {
+        setUp();
+
+        // However the loop ends, an exception from epoll_wait or accept
+        // included, the workers are stopped and joined before they are destroyed
+        struct ShutDownGuard
+        {
+            Daemon& daemon;
+            ~ShutDownGuard() { daemon.shutDown(); }
+        } guard{*this};
+
+        for (unsigned i = 0; i < m_options.workers; ++i) {
+            m_workers.emplace_back([this] { workerLoop(); });
+        }
+
+        std::fprintf(stderr, "verifyDaemon: listening on %s with %u workers\n",
+                     m_options.socketPath.c_str(), m_options.workers);
+
+        epoll_event events[kMaxEvents];
+        while (m_running) {
+            int count = epoll_wait(m_epollFd, events, kMaxEvents, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("epoll_wait: ") + std::strerror(errno));
+            }
+            for (int i = 0; i < count; ++i) {
+                const uint64_t tag = events[i].data.u64;
+                if (tag == kListenTag) {
+                    acceptClients();
+                } else if (tag == kSignalTag) {
+                    handleSignals();
+                } else if (tag == kCompletionTag) {
+                    drainCompletions();
+                } else {
+                    handleClient(tag, events[i].events);
+                }
+            }
+        }
+    }
+
+private:
+    void shutDown()
+    {
+        m_queue.close();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+        ::unlink(m_options.socketPath.c_str());
+    }
+
+    void setUp()
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        sigaddset(&signals, SIGHUP);
+        // Blocked before the workers start, so they inherit the mask
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        m_epollFd = check(epoll_create1(EPOLL_CLOEXEC), "epoll_create1");
+        m_signalFd = check(signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC), "signalfd");
+        m_eventFd = check(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC), "eventfd");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (m_options.socketPath.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path too long: " + m_options.socketPath);
+        }
+        std::strcpy(address.sun_path, m_options.socketPath.c_str());
+
+        // Replace a stale socket left by a previous run, but never a regular file
+        struct stat info;
+        if (::lstat(m_options.socketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            ::unlink(m_options.socketPath.c_str());
+        }
+
+        m_listenFd = check(socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0), "socket");
+        check(bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), "bind");
+        check(listen(m_listenFd, SOMAXCONN), "listen");
+
+        watch(m_listenFd, kListenTag, EPOLLIN);
+        watch(m_signalFd, kSignalTag, EPOLLIN);
+        watch(m_eventFd, kCompletionTag, EPOLLIN);
+    }
+
+    static int check(int result, const char* what)
+    {
+        if (result < 0) {
+            throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+        }
+        return result;
+    }
+
+    void watch(int fd, uint64_t tag, uint32_t events)
+    {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = tag;
+        check(epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event), "epoll_ctl");
+    }
+
+    void workerLoop()
+    {
+        ScanQueue::Scan scan;
+        while (true) {
+            if (!m_queue.pop(scan, std::chrono::seconds(1))) {
+                if (m_queue.isClosed()) {
+                    return;  // closed and drained
+                }
+                continue;
+            }
+            PayloadVerifier::Result result = m_verifier.verify(scan.pit, scan.ticket, scan.gateId);
+
+            VerifyProtocol::VerifyResponse response;
+            response.id = scan.id;
+            response.verdict = static_cast<uint8_t>(result.verdict);
+            response.flags = (result.inGrace ? VerifyProtocol::InGrace : 0) |
+                             (result.ticketSignatureChecked ? VerifyProtocol::TicketSignatureChecked : 0);
+            response.pitTimestamp = result.pitTimestamp;
+            response.ticketTimestamp = result.ticketTimestamp;
+            response.bookingRef = std::move(result.bookingRef);
+
+            Completion completion{scan.source, {}};
+            VerifyProtocol::appendVerifyResponse(response, completion.frame);
+            complete(std::move(completion));
+        }
+    }
+
+    // DropOldest evicted a waiting request; its client still gets an answer
+    void dropped(ScanQueue::Scan&& victim)
+    {
+        Completion completion{victim.source, {}};
+        VerifyProtocol::appendError(victim.id, VerifyProtocol::ErrorReason::Overloaded, completion.frame);
+        complete(std::move(completion));
+    }
+
+    // Hand a response to the epoll thread
+    void complete(Completion&& completion)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_completionMutex);
+            m_completions.push_back(std::move(completion));
+        }
+        const uint64_t one = 1;
+        ssize_t written = ::write(m_eventFd, &one, sizeof(one));
+        (void)written;  // the counter cannot overflow here
+    }
+
+    void acceptClients()
+    {
+        while (true) {
+            int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    std::fprintf(stderr, "verifyDaemon: accept: %s\n", std::strerror(errno));
+                }
+                return;
+            }
+            const uint64_t id = m_nextClientId++;
+            Client& client = m_clients[id];
+            client.fd = fd;
+            client.events = EPOLLIN;
+            watch(fd, id, client.events);
+        }
+    }
+
+    void handleSignals()
+    {
+        signalfd_siginfo info;
+        while (::read(m_signalFd, &info, sizeof(info)) == sizeof(info)) {
+            if (info.ssi_signo == SIGHUP) {
+                reloadRevocations();
+            } else {
+                std::fprintf(stderr, "verifyDaemon: shutting down\n");
+                m_running = false;
+            }
+        }
+    }
+
+    void reloadRevocations()
+    {
+        if (m_options.revocationFiles.empty()) {
+            return;
+        }
+        try {
+            m_verifier.setRevocationList(loadRevocations(m_options.revocationFiles, m_companyKey));
+            std::fprintf(stderr, "verifyDaemon: revocation lists reloaded\n");
+        } catch (const std::exception& e) {
+            // Keep serving with the previous list
+            std::fprintf(stderr, "verifyDaemon: revocation reload failed: %s\n", e.what());
+        }
+    }
+
+    void drainCompletions()
+    {
+        uint64_t counter = 0;
+        ssize_t got = ::read(m_eventFd, &counter, sizeof(counter));
+        (void)got;
+
+        std::vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(m_completionMutex);
+            completions.swap(m_completions);
+        }
+
+        for (Completion& completion : completions) {
+            auto it = m_clients.find(completion.clientId);
+            if (it == m_clients.end()) {
+                continue;  // client went away while its request was running
+            }
+            Client& client = it->second;
+            --client.inFlight;
+            client.out += completion.frame;
+            if (!flush(completion.clientId, client)) {
+                continue;
+            }
+            if (client.readPaused && client.inFlight < kMaxInFlight / 2) {
+                client.readPaused = false;
+                processFrames(completion.clientId, client);
+            }
+        }
+    }
+
+    void handleClient(uint64_t id, uint32_t events)
+    {
+        auto it = m_clients.find(id);
+        if (it == m_clients.end()) {
+            return;
+        }
+        Client& client = it->second;
+
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            drop(id);
+            return;
+        }
+        if ((events & EPOLLOUT) && !flush(id, client)) {
+            return;
+        }
+        if (events & EPOLLIN) {
+            char buffer[kReadChunk];
+            while (true) {
+                ssize_t got = ::read(client.fd, buffer, sizeof(buffer));
+                if (got > 0) {
+                    client.in.append(buffer, static_cast<size_t>(got));
+                    client.readAt = ScanQueue::now();
+                    continue;
+                }
+                if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    drop(id);
+                    return;
+                }
+                if (errno != EINTR) {
+                    break;
+                }
+            }
+            processFrames(id, client);
+        }
+    }
+
+    // Dispatch every complete frame in the input buffer, unless reads are paused
+    void processFrames(uint64_t id, Client& client)
+    {
+        size_t consumed = 0;
+        while (!client.readPaused && !client.closing) {
+            const auto* data = reinterpret_cast<const uint8_t*>(client.in.data()) + consumed;
+            const size_t available = client.in.size() - consumed;
+
+            size_t size = 0;
+            try {
+                size = VerifyProtocol::frameSize(data, available);
+            } catch (const std::exception&) {
+                // The stream cannot be resynchronised; answer once and hang up
+                VerifyProtocol::appendError(0, VerifyProtocol::ErrorReason::MalformedRequest, client.out);
+                client.closing = true;
+                break;
+            }
+            if (size == 0) {
+                break;
+            }
+            dispatch(id, client, VerifyProtocol::parseFrame(data, size));
+            consumed += size;
+        }
+        client.in.erase(0, consumed);
+        updateEvents(id, client);
+        flush(id, client);
+    }
+
+    void dispatch(uint64_t id, Client& client, const VerifyProtocol::Frame& frame)
+    {
+        switch (frame.type) {
+        case VerifyProtocol::Type::Verify: {
+            ScanQueue::Scan scan;
+            try {
+                VerifyProtocol::VerifyRequest request = VerifyProtocol::parseVerifyRequest(frame);
+                scan.pit = std::move(request.pit);
+                scan.ticket = std::move(request.ticket);
+                scan.gateId = request.gateId;
+                scan.id = request.id;
+            } catch (const std::exception&) {
+                VerifyProtocol::appendError(frame.id, VerifyProtocol::ErrorReason::MalformedRequest, client.out);
+                return;
+            }
+            scan.source = id;
+            // A request held back while the client was paused counts its wait from the read
+            scan.stamps.captured = client.readAt;
+            scan.stamps.decoded = ScanQueue::now();
+            if (m_queue.push(std::move(scan)) == ScanQueue::PushResult::Rejected) {
+                // The workers are saturated; the client retries instead of queueing behind them
+                VerifyProtocol::appendError(frame.id, VerifyProtocol::ErrorReason::Overloaded, client.out);
+                return;
+            }
+            if (++client.inFlight >= kMaxInFlight) {
+                client.readPaused = true;
+            }
+            return;
+        }
+
+        case VerifyProtocol::Type::Stats: {
+            VerifyProtocol::StatsResponse stats;
+            stats.id = frame.id;
+            auto counts = m_verifier.verdictCounts();
+            stats.verdictCounts.assign(counts.begin(), counts.end());
+            stats.replayEntries = m_verifier.replayCache().size();
+            stats.keyCacheHits = m_keys.cacheHits();
+            stats.keyCacheMisses = m_keys.cacheMisses();
+            VerifyProtocol::appendStatsResponse(stats, client.out);
+            return;
+        }
+
+        default:
+            VerifyProtocol::appendError(frame.id, VerifyProtocol::ErrorReason::UnknownType, client.out);
+            return;
+        }
+    }
+
+    // Write as much pending output as the socket takes. False if the client was dropped.
+    bool flush(uint64_t id, Client& client)
+    {
+        while (client.outPos < client.out.size()) {
+            ssize_t sent = ::send(client.fd, client.out.data() + client.outPos,
+                                  client.out.size() - client.outPos, MSG_NOSIGNAL);
+            if (sent > 0) {
+                client.outPos += static_cast<size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            drop(id);
+            return false;
+        }
+
+        if (client.outPos == client.out.size()) {
+            client.out.clear();
+            client.outPos = 0;
+            if (client.closing) {
+                drop(id);
+                return false;
+            }
+        } else if (client.out.size() - client.outPos > kMaxOutBuffer) {
+            // Not reading its responses; do not buffer without bound
+            drop(id);
+            return false;
+        }
+        updateEvents(id, client);
+        return true;
+    }
+
+    void updateEvents(uint64_t id, Client& client)
+    {
+        uint32_t events = 0;
+        if (!client.readPaused && !client.closing) {
+            events |= EPOLLIN;
+        }
+        if (client.outPos < client.out.size()) {
+            events |= EPOLLOUT;
+        }
+        if (events != client.events) {
+            epoll_event event{};
+            event.events = events;
+            event.data.u64 = id;
+            epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client.fd, &event);
+            client.events = events;
+        }
+    }
+
+    void drop(uint64_t id)
+    {
+        auto it = m_clients.find(id);
+        if (it != m_clients.end()) {
+            ::close(it->second.fd);  // also removes it from the epoll set
+            m_clients.erase(it);
+        }
+    }
+
+    const Options&      m_options;
+    const std::string   m_companyKey;
+    PublicKeyDirectory& m_keys;
+    PayloadVerifier&    m_verifier;
+
+    int  m_epollFd = -1;
+    int  m_listenFd = -1;
+    int  m_signalFd = -1;
+    int  m_eventFd = -1;
+    bool m_running = true;
+
+    std::unordered_map<uint64_t, Client> m_clients;
+    uint64_t                             m_nextClientId = kFirstClientId;
+
+    ScanQueue                m_queue;
+    std::vector<std::thread> m_workers;
+
+    std::mutex              m_completionMutex;
+    std::vector<Completion> m_completions;
+};
+
+double meanMillis(uint64_t totalNanos, uint64_t count)
+{
+    return count ? static_cast<double>(totalNanos) / static_cast<double>(count) / 1e6 : 0.0;
+}
+
+void printSummary(PayloadVerifier& verifier, const PublicKeyDirectory& keys, const ScanQueue::Stats& queue)
+{
+    auto counts = verifier.verdictCounts();
+    std::fprintf(stderr, "verifyDaemon: verdicts");
+    for (size_t i = 0; i < counts.size(); ++i) {
+        std::fprintf(stderr, " %s=%llu", PayloadVerifier::verdictName(static_cast<PayloadVerifier::Verdict>(i)),
+                     static_cast<unsigned long long>(counts[i]));
+    }
+    std::fprintf(stderr, "\nverifyDaemon: key cache hits=%zu misses=%zu\n", keys.cacheHits(), keys.cacheMisses());
+    std::fprintf(stderr, "verifyDaemon: queue high-water=%zu/%zu overloaded=%llu dropped=%llu\n",
+                 queue.highWater, queue.capacity, static_cast<unsigned long long>(queue.rejected),
+                 static_cast<unsigned long long>(queue.dropped));
+    std::fprintf(stderr, "verifyDaemon: read to enqueued mean=%.3f ms max=%.3f ms, "
+                         "enqueued to dequeued mean=%.3f ms max=%.3f ms\n",
+                 meanMillis(queue.intakeNanos, queue.stamped), static_cast<double>(queue.maxIntakeNanos) / 1e6,
+                 meanMillis(queue.waitNanos, queue.popped), static_cast<double>(queue.maxWaitNanos) / 1e6);
+}
+
+int usage()
+{
+    std::fprintf(stderr,
+                 "Usage: verifyDaemon --socket <path> --keys <dir> [--company-key <file.asc>]\n"
+                 "                    [--revocation-list <file>]... [--pit-policy <file>]\n"
+                 "                    [--workers N] [--drop-oldest]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else if (arg == "--keys" && i + 1 < argc) {
+            options.keysDir = argv[++i];
+        } else if (arg == "--company-key" && i + 1 < argc) {
+            options.companyKeyPath = argv[++i];
+        } else if (arg == "--revocation-list" && i + 1 < argc) {
+            options.revocationFiles.push_back(argv[++i]);
+        } else if (arg == "--pit-policy" && i + 1 < argc) {
+            options.policyPath = argv[++i];
+        } else if (arg == "--workers" && i + 1 < argc) {
+            options.workers = static_cast<unsigned>(std::max(1L, std::strtol(argv[++i], nullptr, 10)));
+        } else if (arg == "--drop-oldest") {
+            options.dropOldest = true;
+        } else {
+            return usage();
+        }
+    }
+    if (options.socketPath.empty() || options.keysDir.empty()) {
+        return usage();
+    }
+    if (!options.revocationFiles.empty() && options.companyKeyPath.empty()) {
+        std::fprintf(stderr, "verifyDaemon: --revocation-list needs --company-key to check its signature\n");
+        return 2;
+    }
+
+    try {
+        std::string companyKey = options.companyKeyPath.empty() ? std::string() : readFile(options.companyKeyPath);
+        PitValidityPolicy policy = options.policyPath.empty() ? PitValidityPolicy()
+                                                              : PitValidityPolicy::loadFile(options.policyPath);
+
+        PublicKeyDirectory keys(options.keysDir);
+        PayloadVerifier verifier(keys, companyKey, policy, std::make_shared<SystemWallClock>());
+        verifier.setRevocationList(loadRevocations(options.revocationFiles, companyKey));
+        if (companyKey.empty()) {
+            std::fprintf(stderr, "verifyDaemon: no --company-key, ticket signatures are not checked\n");
+        }
+
+        Daemon daemon(options, companyKey, keys, verifier);
+        daemon.run();
+        printSummary(verifier, keys, daemon.queueStats());
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "verifyDaemon: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,645 @@
+// verifyLoad - load generator and soak test for the PIT + ticket verification path
+//
+// Mints synthetic users (one SigningKey each, taken from a KeyPool), registers
+// their public keys in a key directory, issues each one a company-signed
+// ticket and keeps a fresh PIT for every user, all in the exact QR payload
+// formats. It then drives verifications at a fixed rate, either in-process
+// through PayloadVerifier or against a running verifyDaemon, and reports
+// throughput, p50/p99/p999 latency, failed verdicts and RSS every interval.
+//
+// The rate is open-loop: each request has a scheduled send time and latency is
+// measured from it, so a stall shows up as latency of every request it
+// delayed instead of as a quiet gap. --rate 0 runs closed-loop (as fast as the
+// target answers).
+//
+// The work directory keeps the company key between runs, so a daemon can be
+// started against it once:
+//   verifyLoad --workdir /tmp/load --setup-only
+//   verifyDaemon --socket /tmp/load.sock --keys /tmp/load/keys --company-key /tmp/load/company.asc
+//   verifyLoad --workdir /tmp/load --socket /tmp/load.sock --rate 2000 --duration 3600
+//
+// Usage: verifyLoad [--workdir <dir>] [--socket <path>] [--users N] [--payload-version 1|2|3]
+//                   [--rate R] [--duration S] [--threads N] [--report-interval S]
+//                   [--pit-policy <file>] [--rss-pid PID] [--setup-only]
+
+#include "Ed25519Signer.h"
+#include "KeyFingerprint.h"
+#include "PayloadVerifier.h"
+#include "KeyPool.h"
+#include "PitValidityPolicy.h"
+#include "PublicKeyDirectory.h"
+#include "ScanMessage.h"
+#include "SecureBuffer.h"
+#include "SigningKey.h"
+#include "VerifyClient.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr uint32_t kGateId        = 1;
+constexpr int      kPitRefreshSec = 5;   // well inside the default 20 s PIT lifetime
+
+std::atomic<bool> g_stop{false};
+
+void onSignal(int)
+{
+    g_stop = true;
+}
+
+std::string toHex(const uint8_t* data, size_t size)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(size * 2);
+    for (size_t i = 0; i < size; ++i) {
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 0x0f];
+    }
+    return hex;
+}
+
+int64_t wallSeconds()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+void writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+    if (!out) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+// Resident set size of a process in bytes (0 if it cannot be read)
+size_t residentBytes(pid_t pid)
+{
+    std::ifstream statm("/proc/" + std::to_string(pid) + "/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * Latency histogram with ~6% resolution: exact below 32 ns, then 16 linear
+ * sub-buckets per power of two. Fixed size, so soak runs of any length use
+ * the same memory. Buckets are atomic so the reporter can read them while the
+ * owning thread records.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr size_t kBuckets = 32 + 59 * 16;
+
+    void record(uint64_t ns) { m_counts[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed); }
+
+    void addTo(std::array<uint64_t, kBuckets>& totals) const
+    {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            totals[i] += m_counts[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Upper bound of the bucket holding the given fraction of samples
+    static uint64_t percentile(const std::array<uint64_t, kBuckets>& counts, double fraction)
+    {
+        uint64_t total = 0;
+        for (uint64_t count : counts) {
+            total += count;
+        }
+        if (total == 0) {
+            return 0;
+        }
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(total)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return upperBound(i);
+            }
+        }
+        return upperBound(kBuckets - 1);
+    }
+
+private:
+    static size_t bucketFor(uint64_t ns)
+    {
+        if (ns < 32) {
+            return static_cast<size_t>(ns);
+        }
+        const int exponent = 63 - __builtin_clzll(ns);  // >= 5
+        const size_t sub = static_cast<size_t>((ns >> (exponent - 4)) & 15);
+        return 32 + static_cast<size_t>(exponent - 5) * 16 + sub;
+    }
+
+    static uint64_t upperBound(size_t bucket)
+    {
+        if (bucket < 32) {
+            return bucket;
+        }
+        const int exponent = static_cast<int>((bucket - 32) / 16) + 5;
+        const uint64_t sub = (bucket - 32) % 16;
+        return ((16 + sub + 1) << (exponent - 4)) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, kBuckets> m_counts{};
+};
+
+using Snapshot = std::array<uint64_t, LatencyHistogram::kBuckets>;
+
+struct User
+{
+    std::unique_ptr<SigningKey> key;
+    std::string                 ticket;
+};
+
+const char* pitTag(int version)
+{
+    return version == 1 ? "PIT" : version == 2 ? "PIT2" : "PIT3";
+}
+
+const char* ticketTag(int version)
+{
+    return version == 1 ? "TICKET" : version == 2 ? "TICKET2" : "TICKET3";
+}
+
+// Signature of the given payload version over a v1 text or a ScanMessage
+std::string signPayload(int version, const SigningKey& key, const std::string& legacyText,
+                        const ScanMessage& message, std::vector<uint8_t>& buffer)
+{
+    if (version == 2) {
+        const Ed25519Signer::Signature signature = key.signRaw(message.data(), message.size());
+        return toHex(signature.data(), signature.size());
+    }
+    if (version == 1) {
+        key.signOpenPgp(reinterpret_cast<const uint8_t*>(legacyText.data()), legacyText.size(), buffer);
+    } else {
+        key.signOpenPgp(message.data(), message.size(), buffer);
+    }
+    return toHex(buffer.data(), buffer.size());
+}
+
+// PIT:<fingerprint>:<timestamp>:<signature>
+std::string issuePit(const User& user, int version, int64_t timestamp, std::vector<uint8_t>& buffer)
+{
+    const SigningKey& key = *user.key;
+    const std::string legacyText = key.publicKeyArmored() + std::to_string(timestamp);
+    const std::string signature = signPayload(version, key, legacyText,
+                                              ScanMessage::pit(key.fingerprint(), timestamp), buffer);
+    return std::string(pitTag(version)) + ":" + key.fingerprint().toHex() + ":" + std::to_string(timestamp) + ":" +
+           signature;
+}
+
+// TICKET:<bookingRef>:<timestamp>:<fingerprint>:<company signature>
+std::string issueTicket(const SigningKey& company, const User& user, const std::string& bookingRef, int version,
+                        int64_t timestamp, std::vector<uint8_t>& buffer)
+{
+    const SigningKey& key = *user.key;
+    const std::string legacyText = key.publicKeyArmored() + bookingRef + std::to_string(timestamp);
+    const std::string signature =
+        signPayload(version, company, legacyText,
+                    ScanMessage::ticket(key.fingerprint(), bookingRef, timestamp), buffer);
+    return std::string(ticketTag(version)) + ":" + bookingRef + ":" + std::to_string(timestamp) + ":" +
+           key.fingerprint().toHex() + ":" + signature;
+}
+
+// Reuse the company key of a previous run, so a daemon started against the work directory keeps working
+std::unique_ptr<SigningKey> loadCompany(const std::string& workdir)
+{
+    const std::string seedPath = workdir + "/company.seed";
+    std::string seedHex = readFile(seedPath);
+    if (seedHex.size() != 64) {
+        // Only ever a load-test key, so std::random_device is good enough for its seed
+        std::random_device random;
+        uint8_t fresh[32];
+        for (uint8_t& byte : fresh) {
+            byte = static_cast<uint8_t>(random());
+        }
+        seedHex = toHex(fresh, sizeof(fresh));
+        writeFile(seedPath, seedHex);
+        ::chmod(seedPath.c_str(), 0600);
+    }
+
+    SecureBuffer seed(32);
+    for (size_t i = 0; i < seed.size(); ++i) {
+        seed.data()[i] = static_cast<uint8_t>(std::stoul(seedHex.substr(2 * i, 2), nullptr, 16));
+    }
+    auto company = std::make_unique<SigningKey>(SigningKey::fromSeed(std::move(seed), "company@load.example"));
+    writeFile(workdir + "/company.asc", company->publicKeyArmored());
+    return company;
+}
+
+/**
+ * Current PIT of every user, re-signed every few seconds so they stay fresh
+ * however long the run is. Workers pick the list up with atomic_load.
+ */
+class PitIssuer
+{
+public:
+    PitIssuer(const std::vector<User>& users, int version) : m_users(users), m_version(version)
+    {
+        refresh();
+        m_thread = std::thread([this] { run(); });
+    }
+
+    ~PitIssuer()
+    {
+        m_done = true;
+        m_thread.join();
+    }
+
+    std::shared_ptr<const std::vector<std::string>> current() const { return std::atomic_load(&m_pits); }
+
+private:
+    void refresh()
+    {
+        auto pits = std::make_shared<std::vector<std::string>>();
+        pits->reserve(m_users.size());
+        const int64_t now = wallSeconds();
+        for (const User& user : m_users) {
+            pits->push_back(issuePit(user, m_version, now, m_buffer));
+        }
+        std::atomic_store(&m_pits, std::shared_ptr<const std::vector<std::string>>(std::move(pits)));
+    }
+
+    void run()
+    {
+        auto next = SteadyClock::now() + std::chrono::seconds(kPitRefreshSec);
+        while (!m_done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (SteadyClock::now() >= next) {
+                refresh();
+                next += std::chrono::seconds(kPitRefreshSec);
+            }
+        }
+    }
+
+    const std::vector<User>& m_users;
+    const int                m_version;
+    std::vector<uint8_t>     m_buffer;
+    std::atomic<bool>        m_done{false};
+
+    std::shared_ptr<const std::vector<std::string>> m_pits;
+    std::thread                                     m_thread;
+};
+
+struct WorkerStats
+{
+    LatencyHistogram                                           latency;
+    std::array<std::atomic<uint64_t>, PayloadVerifier::kVerdictCount> verdicts{};
+    std::atomic<uint64_t>                                      errors{0};
+};
+
+struct Options
+{
+    std::string workdir;
+    std::string socketPath;
+    std::string policyPath;
+    size_t      users = 100;
+    int         payloadVersion = 3;
+    double      rate = 1000;
+    double      duration = 60;
+    size_t      threads = std::max(1u, std::thread::hardware_concurrency());
+    double      reportInterval = 10;
+    pid_t       rssPid = 0;
+    bool        setupOnly = false;
+};
+
+void workerLoop(size_t index, const Options& options, const PitIssuer& issuer, const std::vector<User>& users,
+                PayloadVerifier* verifier, WorkerStats& stats)
+{
+    std::unique_ptr<VerifyClient> client;
+    if (!verifier) {
+        try {
+            client = std::make_unique<VerifyClient>(options.socketPath);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "verifyLoad: %s\n", e.what());
+            stats.errors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    // Each thread sends an equal share of the rate, offset so the threads interleave
+    const bool paced = options.rate > 0;
+    const auto interval = std::chrono::duration_cast<SteadyClock::duration>(
+        std::chrono::duration<double>(paced ? static_cast<double>(options.threads) / options.rate : 0));
+    auto scheduled = SteadyClock::now() + interval * index / options.threads;
+
+    std::shared_ptr<const std::vector<std::string>> pits = issuer.current();
+    auto nextReload = SteadyClock::now() + std::chrono::seconds(1);
+    size_t userIndex = index;
+
+    while (!g_stop) {
+        if (paced) {
+            std::this_thread::sleep_until(scheduled);
+        } else {
+            scheduled = SteadyClock::now();
+        }
+        if (scheduled >= nextReload) {
+            pits = issuer.current();
+            nextReload = scheduled + std::chrono::seconds(1);
+        }
+
+        const size_t user = userIndex % users.size();
+        userIndex += options.threads;
+        try {
+            const PayloadVerifier::Verdict verdict =
+                verifier ? verifier->verify((*pits)[user], users[user].ticket, kGateId).verdict
+                         : static_cast<PayloadVerifier::Verdict>(
+                               client->verify((*pits)[user], users[user].ticket, kGateId).verdict);
+            stats.verdicts[static_cast<size_t>(verdict)].fetch_add(1, std::memory_order_relaxed);
+        } catch (const std::exception& e) {
+            if (stats.errors.fetch_add(1, std::memory_order_relaxed) == 0) {
+                std::fprintf(stderr, "verifyLoad: %s\n", e.what());
+            }
+            if (client) {
+                return;
+            }
+        }
+        stats.latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - scheduled).count()));
+        scheduled += interval;
+    }
+}
+
+double toMs(uint64_t ns)
+{
+    return static_cast<double>(ns) / 1e6;
+}
+
+double toMiB(size_t bytes)
+{
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+struct Totals
+{
+    Snapshot                                          latency{};
+    std::array<uint64_t, PayloadVerifier::kVerdictCount> verdicts{};
+    uint64_t                                          errors = 0;
+
+    uint64_t count() const
+    {
+        uint64_t total = 0;
+        for (uint64_t n : verdicts) {
+            total += n;
+        }
+        return total + errors;
+    }
+
+    uint64_t failed() const { return count() - verdicts[static_cast<size_t>(PayloadVerifier::Verdict::Valid)]; }
+};
+
+Totals collect(const std::vector<std::unique_ptr<WorkerStats>>& workers)
+{
+    Totals totals;
+    for (const auto& worker : workers) {
+        worker->latency.addTo(totals.latency);
+        for (size_t i = 0; i < totals.verdicts.size(); ++i) {
+            totals.verdicts[i] += worker->verdicts[i].load(std::memory_order_relaxed);
+        }
+        totals.errors += worker->errors.load(std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+Totals difference(const Totals& now, const Totals& before)
+{
+    Totals delta;
+    for (size_t i = 0; i < delta.latency.size(); ++i) {
+        delta.latency[i] = now.latency[i] - before.latency[i];
+    }
+    for (size_t i = 0; i < delta.verdicts.size(); ++i) {
+        delta.verdicts[i] = now.verdicts[i] - before.verdicts[i];
+    }
+    delta.errors = now.errors - before.errors;
+    return delta;
+}
+
+void printLine(const char* label, const Totals& totals, double seconds, size_t rss)
+{
+    std::printf("%-8s %9.0f verif/s  p50 %7.3f ms  p99 %7.3f ms  p999 %7.3f ms  failed %6llu  rss %7.1f MiB\n",
+                label, seconds > 0 ? static_cast<double>(totals.count()) / seconds : 0.0,
+                toMs(LatencyHistogram::percentile(totals.latency, 0.50)),
+                toMs(LatencyHistogram::percentile(totals.latency, 0.99)),
+                toMs(LatencyHistogram::percentile(totals.latency, 0.999)),
+                static_cast<unsigned long long>(totals.failed()), toMiB(rss));
+    std::fflush(stdout);
+}
+
+int usage()
+{
+    std::fprintf(stderr,
+                 "Usage: verifyLoad [--workdir <dir>] [--socket <path>] [--users N] [--payload-version 1|2|3]\n"
+                 "                  [--rate R] [--duration S] [--threads N] [--report-interval S]\n"
+                 "                  [--pit-policy <file>] [--rss-pid PID] [--setup-only]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--workdir" && i + 1 < argc) {
+            options.workdir = argv[++i];
+        } else if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else if (arg == "--users" && i + 1 < argc) {
+            options.users = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--payload-version" && i + 1 < argc) {
+            options.payloadVersion = std::atoi(argv[++i]);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            options.rate = std::max(0.0, std::strtod(argv[++i], nullptr));
+        } else if (arg == "--duration" && i + 1 < argc) {
+            options.duration = std::max(0.0, std::strtod(argv[++i], nullptr));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--report-interval" && i + 1 < argc) {
+            options.reportInterval = std::max(0.1, std::strtod(argv[++i], nullptr));
+        } else if (arg == "--pit-policy" && i + 1 < argc) {
+            options.policyPath = argv[++i];
+        } else if (arg == "--rss-pid" && i + 1 < argc) {
+            options.rssPid = static_cast<pid_t>(std::atoi(argv[++i]));
+        } else if (arg == "--setup-only") {
+            options.setupOnly = true;
+        } else {
+            return usage();
+        }
+    }
+    if (options.payloadVersion < 1 || options.payloadVersion > 3) {
+        return usage();
+    }
+    if (!options.socketPath.empty() && options.workdir.empty()) {
+        std::fprintf(stderr, "verifyLoad: --socket needs --workdir, the daemon's key directory lives there\n");
+        return 2;
+    }
+    if (options.rssPid == 0) {
+        options.rssPid = getpid();
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    try {
+        if (options.workdir.empty()) {
+            char pattern[] = "/tmp/verifyLoad.XXXXXX";
+            if (!mkdtemp(pattern)) {
+                throw std::runtime_error("Cannot create a work directory");
+            }
+            options.workdir = pattern;
+        }
+        ::mkdir(options.workdir.c_str(), 0700);
+
+        std::unique_ptr<SigningKey> company = loadCompany(options.workdir);
+        std::printf("Work directory %s\n", options.workdir.c_str());
+        if (options.setupOnly) {
+            std::printf("Company key written to %s/company.asc\n", options.workdir.c_str());
+            return 0;
+        }
+
+        // Fresh random keys, as an onboarding burst would need them
+        std::printf("Minting %zu users (payload version %d)...\n", options.users, options.payloadVersion);
+        PublicKeyDirectory keys(options.workdir + "/keys");
+        std::vector<User> users(options.users);
+        std::vector<uint8_t> buffer;
+        const int64_t issuedAt = wallSeconds();
+        const auto mintStart = SteadyClock::now();
+        KeyPool pool("load@load.example", std::min<size_t>(options.users, 256), options.threads);
+        for (size_t i = 0; i < users.size(); ++i) {
+            User& user = users[i];
+            user.key = pool.take();
+            keys.registerKey(user.key->fingerprint().toHex(), user.key->publicKeyArmored());
+
+            char bookingRef[16];
+            std::snprintf(bookingRef, sizeof(bookingRef), "LOAD%06zu", i);
+            user.ticket = issueTicket(*company, user, bookingRef, options.payloadVersion, issuedAt, buffer);
+        }
+        const KeyPool::Stats poolStats = pool.stats();
+        std::printf("Minted in %.2f s: %llu pooled keys (%.2f ms each), %llu generated inline\n",
+                    std::chrono::duration<double>(SteadyClock::now() - mintStart).count(),
+                    static_cast<unsigned long long>(poolStats.taken),
+                    poolStats.generated ? toMs(poolStats.generateNanos / poolStats.generated) : 0.0,
+                    static_cast<unsigned long long>(poolStats.misses));
+
+        std::unique_ptr<PayloadVerifier> verifier;
+        if (options.socketPath.empty()) {
+            PitValidityPolicy policy = options.policyPath.empty() ? PitValidityPolicy()
+                                                                  : PitValidityPolicy::loadFile(options.policyPath);
+            verifier = std::make_unique<PayloadVerifier>(keys, company->publicKeyArmored(), policy, nullptr);
+        }
+
+        PitIssuer issuer(users, options.payloadVersion);
+
+        std::printf("Driving %s with %zu threads at %s for %s\n\n",
+                    verifier ? "PayloadVerifier in-process" : options.socketPath.c_str(), options.threads,
+                    options.rate > 0 ? (std::to_string(static_cast<long long>(options.rate)) + " verif/s").c_str()
+                                     : "maximum rate",
+                    options.duration > 0 ? (std::to_string(static_cast<long long>(options.duration)) + " s").c_str()
+                                         : "until interrupted");
+
+        std::vector<std::unique_ptr<WorkerStats>> stats;
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < options.threads; ++i) {
+            stats.push_back(std::make_unique<WorkerStats>());
+        }
+
+        const size_t rssStart = residentBytes(options.rssPid);
+        size_t rssPeak = rssStart;
+        const auto start = SteadyClock::now();
+        for (size_t i = 0; i < options.threads; ++i) {
+            workers.emplace_back(workerLoop, i, std::cref(options), std::cref(issuer), std::cref(users),
+                                 verifier.get(), std::ref(*stats[i]));
+        }
+
+        Totals previous;
+        auto lastReport = start;
+        const auto reportEvery = std::chrono::duration_cast<SteadyClock::duration>(
+            std::chrono::duration<double>(options.reportInterval));
+        const auto end = start + std::chrono::duration_cast<SteadyClock::duration>(
+            std::chrono::duration<double>(options.duration));
+
+        while (!g_stop) {
+            auto wake = std::min(lastReport + reportEvery, options.duration > 0 ? end : SteadyClock::time_point::max());
+            while (!g_stop && SteadyClock::now() < wake) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            const auto now = SteadyClock::now();
+            if (options.duration > 0 && now >= end) {
+                g_stop = true;
+            }
+
+            Totals current = collect(stats);
+            const size_t rss = residentBytes(options.rssPid);
+            rssPeak = std::max(rssPeak, rss);
+            char label[32];
+            std::snprintf(label, sizeof(label), "[%5.0fs]", std::chrono::duration<double>(now - start).count());
+            printLine(label, difference(current, previous),
+                      std::chrono::duration<double>(now - lastReport).count(), rss);
+            previous = current;
+            lastReport = now;
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        const double elapsed = std::chrono::duration<double>(SteadyClock::now() - start).count();
+        const Totals totals = collect(stats);
+        const size_t rssEnd = residentBytes(options.rssPid);
+
+        std::printf("\n");
+        printLine("total", totals, elapsed, rssEnd);
+        std::printf("\n%llu verifications in %.1f s\n", static_cast<unsigned long long>(totals.count()), elapsed);
+        for (size_t i = 0; i < totals.verdicts.size(); ++i) {
+            if (totals.verdicts[i]) {
+                std::printf("  %-22s %llu\n", PayloadVerifier::verdictName(static_cast<PayloadVerifier::Verdict>(i)),
+                            static_cast<unsigned long long>(totals.verdicts[i]));
+            }
+        }
+        if (totals.errors) {
+            std::printf("  %-22s %llu\n", "transport_error", static_cast<unsigned long long>(totals.errors));
+        }
+        std::printf("RSS start %.1f MiB, peak %.1f MiB, end %.1f MiB\n", toMiB(rssStart), toMiB(rssPeak),
+                    toMiB(rssEnd));
+        return totals.failed() ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "verifyLoad: %s\n", e.what());
+        return 1;
+    }
+}
@@ -1,19 +1,58 @@
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
 
 #include "window.h"
+#include "appStyle.h"
 #include "ticketInspector.h"
+#include "ticketOwnership.h"
+#include "companyKeys.h"
+#include "logInPage.h"
+#include "identificationToken.h"
+#include "startupProfiler.h"
+#include "scanHandoff.h"
+#include "scanVerifier.h"
+#include "scrollBenchmark.h"
 #include "PgpKeyManager.h"
 #include <iostream>
 #include <string>
 
 int main(int argc, char *argv[]) {
     
+    // Checked before QApplication so its construction is included in the profile
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--profile-startup") {
+            StartupProfiler::enable();
+        } else if (std::string(argv[i]) == "--company-secret-key" && i + 1 < argc) {
+            // Issue with a persistent company key; read here so the prefetch below uses it
+            setCompanySecretKeyFile(QString::fromLocal8Bit(argv[++i]));
+        }
+    }
+    
+    // Generate the company keys in the background while the windows are built
+    prefetchCompanyKeys();
+    
     QApplication app(argc, argv);
+    StartupProfiler::mark("QApplication constructed");
+    
+    // One stylesheet for every widget, parsed once
+    AppStyle::install(app);
+    StartupProfiler::mark("stylesheet installed");
 
     // Check command line arguments
     bool inspectorMode = false;
     bool userMode = false;
     bool bothMode = false;
+    QString scanSource;
+    QStringList revocationFiles;
+    QString handoffName;
+    QString journalPath;
+    QString companyKeyPath;
+    QString verifyDaemonPath;
+    quint32 gateId = 0;
+    bool companySecretKey = false;
+    int benchScrollCards = 0;
     
     for (int i = 1; i < argc; ++i) {
         QString arg(argv[i]);
@@ -23,25 +62,120 @@ int main(int argc, char *argv[]) {
             userMode = true;
         } else if (arg == "--both" || arg == "-b") {
             bothMode = true;
+        } else if ((arg == "--scan-source" || arg == "-s") && i + 1 < argc) {
+            // Live-scan frames from a directory or /dev/video* device
+            scanSource = QString(argv[++i]);
+        } else if (arg == "--revocation-list" && i + 1 < argc) {
+            // Full list followed by any deltas, applied in the given order
+            revocationFiles << QString(argv[++i]);
+        } else if (arg == "--company-key" && i + 1 < argc) {
+            // Company public key that tickets and revocation lists are verified with
+            companyKeyPath = QString(argv[++i]);
+        } else if (arg == "--company-secret-key" && i + 1 < argc) {
+            // Already applied above
+            companySecretKey = true;
+            ++i;
+        } else if (arg == "--fast-signatures") {
+            // Issue PIT2/TICKET2 payloads (raw Ed25519) instead of OpenPGP signatures
+            TicketOwnership::setIssuePayloadVersion(TicketOwnership::PayloadEd25519);
+        } else if (arg == "--legacy-signatures") {
+            // Issue version 1 PIT/TICKET payloads for inspectors that predate PIT3/TICKET3
+            TicketOwnership::setIssuePayloadVersion(TicketOwnership::PayloadOpenPgp);
+        } else if (arg == "--kdf-cost" && i + 1 < argc) {
+            // log2 of the scrypt cost used to derive login keys (default 15)
+            KeyDerivation::Params params;
+            bool ok = false;
+            params.costLog2 = QString(argv[++i]).toUInt(&ok);
+            if (!ok || !KeyDerivation::isValid(params)) {
+                std::cerr << "Invalid --kdf-cost: " << argv[i] << " (expected " << KeyDerivation::kMinCostLog2
+                          << " to " << KeyDerivation::kMaxCostLog2 << ")" << std::endl;
+                return 1;
+            }
+            LoginPage::setKeyDerivationParams(params);
+        } else if (arg == "--pit-policy" && i + 1 < argc) {
+            // PIT max age, allowed future clock skew and grace window
+            try {
+                TicketOwnership::setPitValidityPolicy(PitValidityPolicy::loadFile(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid --pit-policy: " << e.what() << std::endl;
+                return 1;
+            }
+        } else if (arg == "--journal" && i + 1 < argc) {
+            // Scan journal file for the inspector ("none" disables it)
+            journalPath = QString(argv[++i]);
+        } else if (arg == "--handoff" && i + 1 < argc) {
+            // Local socket name for handing QR frames from the user window to the inspector
+            handoffName = QString(argv[++i]);
+        } else if (arg == "--verify-daemon" && i + 1 < argc) {
+            // Verify through a running verifyDaemon shared with the other gates
+            verifyDaemonPath = QString(argv[++i]);
+        } else if (arg == "--gate-id" && i + 1 < argc) {
+            // This terminal's gate for the daemon's cross-gate replay check
+            gateId = QString(argv[++i]).toUInt();
+        } else if (arg == "--bench-scroll" && i + 1 < argc) {
+            // Measure ticket list frame times with this many cards, then exit
+            benchScrollCards = QString(argv[++i]).toInt();
+        } else if (arg == "--precompute-pits" && i + 1 < argc) {
+            // Pre-sign this many minutes of PIT windows right after login
+            IdentificationToken::setPrecomputeHorizon(QString(argv[++i]).toInt() * 60);
         }
     }
 
+    if (benchScrollCards > 0) {
+        return ScrollBenchmark::run(benchScrollCards);
+    }
+
     // If no arguments, default to user mode
     if (!inspectorMode && !userMode && !bothMode) {
         userMode = true;
     }
 
+    // The inspector checks company signatures against a persistent key; the
+    // generated one is only good for tickets this process issues itself
+    const bool issuesOwnTickets = bothMode || (inspectorMode && userMode);
+    if (!companyKeyPath.isEmpty()) {
+        if (!loadCompanyPublicKey(companyKeyPath)) {
+            std::cerr << "Invalid --company-key: " << companyKeyPath.toStdString()
+                      << " is not a readable Ed25519 public key" << std::endl;
+            return 1;
+        }
+    } else if (issuesOwnTickets || companySecretKey) {
+        trustOwnCompanyKey();
+    } else if (!revocationFiles.isEmpty()) {
+        std::cerr << "--revocation-list needs --company-key to check its signature" << std::endl;
+        return 1;
+    }
+
+    if (!verifyDaemonPath.isEmpty()) {
+        if (gateId == 0) {
+            std::cerr << "--verify-daemon needs a non-zero --gate-id for the replay check" << std::endl;
+            return 1;
+        }
+        ScanVerifier::setVerifyDaemon(verifyDaemonPath, gateId);
+    }
+
+    // In --both mode the user window hands codes to the inspector in memory
+    if (handoffName.isEmpty() && issuesOwnTickets) {
+        handoffName = ScanHandoff::defaultServerName();
+    }
+    ScanHandoff::setServerName(handoffName);
+
     // Pointers to keep windows alive
     Window* userWindow = nullptr;
     TicketInspector* inspectorWindow = nullptr;
+    QElapsedTimer buildTimer;
 
     if (bothMode || (inspectorMode && userMode)) {
         // Launch both windows
+        buildTimer.start();
         userWindow = new Window();
+        StartupProfiler::markBuilt(userWindow, "user window", buildTimer);
         userWindow->setWindowTitle("SBB Ticketing - User");
         userWindow->show();
         
+        buildTimer.start();
         inspectorWindow = new TicketInspector();
+        StartupProfiler::markBuilt(inspectorWindow, "inspector window", buildTimer);
         inspectorWindow->setWindowTitle("SBB Ticketing - Inspector");
         inspectorWindow->show();
         
@@ -56,17 +190,61 @@ int main(int argc, char *argv[]) {
         
     } else if (inspectorMode) {
         // Launch inspector window only
+        buildTimer.start();
         inspectorWindow = new TicketInspector();
+        StartupProfiler::markBuilt(inspectorWindow, "inspector window", buildTimer);
         inspectorWindow->show();
         
     } else {
         // Launch user window only
+        buildTimer.start();
         userWindow = new Window();
+        StartupProfiler::markBuilt(userWindow, "user window", buildTimer);
         userWindow->show();
     }
 
+    StartupProfiler::mark("windows shown");
+    StartupProfiler::watchFirstPaint(userWindow, "user window");
+    StartupProfiler::watchFirstPaint(inspectorWindow, "inspector window");
+
+    // Load revocation lists before any scan can be verified. Their signatures
+    // are checked with the company key, so defer until the event loop runs
+    // rather than wait for the key bootstrap before the first paint.
+    if (inspectorWindow && !revocationFiles.isEmpty()) {
+        QTimer::singleShot(0, inspectorWindow, [inspectorWindow, revocationFiles]() {
+            for (const QString& file : revocationFiles) {
+                inspectorWindow->loadRevocationFile(file);
+            }
+        });
+    }
+
+    // Record every scan for end-of-shift upload and audit
+    if (inspectorWindow && journalPath != "none") {
+        inspectorWindow->openJournal(journalPath.isEmpty() ? TicketInspector::defaultJournalPath() : journalPath);
+    }
+
+    // Listen for frames from the user window (this or another process)
+    if (inspectorWindow && !handoffName.isEmpty()) {
+        inspectorWindow->startHandoffServer(handoffName);
+    }
+
+    // Start live scanning if a frame source was given
+    if (inspectorWindow && !scanSource.isEmpty()) {
+        inspectorWindow->startLiveScan(scanSource);
+    }
+
     int result = app.exec();
     
+    // PIT outcomes by reason, for tuning the validity policy
+    const PitValidityStats::Counts pitCounts = TicketOwnership::pitValidityStats().snapshot();
+    if (inspectorWindow && pitCounts.valid + pitCounts.validInGrace + pitCounts.rejected() > 0) {
+        std::cerr << "[pit] valid " << pitCounts.valid
+                  << ", in grace " << pitCounts.validInGrace
+                  << ", expired " << pitCounts.expired
+                  << ", from future " << pitCounts.fromFuture
+                  << ", malformed " << pitCounts.malformed << std::endl;
+    }
+    
     // Cleanup
     delete userWindow;
     delete inspectorWindow;
@@ -68,6 +68,9 @@ install_ubuntu() {
     # QR Code decoder (for inspector)
     $SUDO apt-get install -y --no-install-recommends zbar-tools
 
+    # OpenSSL (raw Ed25519 signatures for PIT2/TICKET2 payloads)
+    $SUDO apt-get install -y --no-install-recommends libssl-dev
+
     # Verify whether qmake or qtpaths are available; if not, give the user clear next steps.
     if command -v qmake >/dev/null 2>&1; then
         info "Found qmake: $(command -v qmake)"
@@ -131,6 +134,7 @@ install_macos() {
     brew install pkg-config
     brew install qrencode
     brew install zbar
+    brew install openssl@3
     
     info "macOS install finished. Verify with: clang --version && qmake --version || qtpaths --version"
 }